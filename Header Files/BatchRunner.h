@@ -0,0 +1,171 @@
+#ifndef __BATCHRUNNER__
+#define __BATCHRUNNER__
+
+#include "rt.h"
+#include "Simulation.h"
+
+#include <deque>
+#include <iostream>
+#include <vector>
+
+const double rushHourArrivalRate = 60.0; // Passengers per minute from which Run() fails if the hot path touched the heap
+const int rushHourDays = 100; // Days RunRushHour() simulates unless it is told how many
+
+/**
+* @details The BatchRunner class runs many independent simulated days, for
+* example to compare dispatcher settings, and adds up their wait times.
+*	Every simulation runs on a CDeterministicScheduler of its own, seeded with
+* the batch seed plus its number, so the results do not depend on how many
+* workers there are or which worker ran which day.
+*	There is one worker thread per processor. The simulations are shared out
+* between the workers' queues at the start. A worker takes its next
+* simulation from the back of its own queue and, when that is empty, steals
+* one from the front of another worker's queue, so all the processors stay
+* busy until the whole batch is done even when some days take longer to
+* simulate than others.
+*/
+class BatchRunner {
+
+public:
+
+	/**
+	* Constructor that initializes the member variables.
+	* @param[in] parameters The settings of every simulated day.
+	* @param[in] numOfSimulations The number of days to simulate.
+	* @param[in] seed The seed of the first day, the others use the following seeds.
+	* @param[in] numOfWorkers The number of worker threads, one per processor if 0.
+	*/
+	BatchRunner(const simulationParameters &parameters, int numOfSimulations, unsigned int seed, int numOfWorkers = 0);
+
+	/**
+	* Destructor that releases the worker queues.
+	*/
+	~BatchRunner();
+
+	/**
+	* @details Runs every simulation and waits for them all to finish.
+	* @return Returns false if, with an arrivalRate of rushHourArrivalRate or
+	* more, the dispatchers or elevators made any heap allocations after their
+	* first poll. A day that busy takes every path they have, so the count
+	* should be 0. Always true unless rt.cpp is built with RT_COUNT_ALLOCATIONS.
+	* PrintReport() says which.
+	*/
+	bool Run();
+
+	/**
+	* @return Returns the wait times of all the simulations added together.
+	*/
+	const waitTimeHistogram &WaitTimes() const { return _waitTimes; }
+
+	/**
+	* @details Prints the number of passengers, the wait time distribution,
+	* the spread of the daily mean wait times and the hot path allocations,
+	* saying so if they made Run() fail.
+	* @param[in] out The stream to print to.
+	*/
+	void PrintReport(std::ostream &out) const;
+
+	/**
+	* @details Runs a rush hour batch, at twice rushHourArrivalRate, and prints
+	* its report if the arguments are "-rushhour" followed by the number of
+	* days and the seed, both optional. Like ProcessGroup::RunChild() it is
+	* called first thing in main(), so a build with RT_COUNT_ALLOCATIONS can
+	* check the hot path from the command line or a script.
+	* @param[in] argc The argc of main().
+	* @param[in] argv The argv of main().
+	* @param[out] exitCode 0 if Run() passed, 1 if it failed.
+	* @return Returns true if the batch was run, false if the program should
+	* carry on as normal.
+	*/
+	static bool RunRushHour(int argc, char *argv[], int &exitCode);
+
+private:
+
+	/**
+	* @details The simulations waiting to be run by one worker, and the lock
+	* that lets other workers steal from it.
+	*/
+	struct workQueue {
+
+		CriticalSection lock;
+		std::deque<int> simulations;
+
+	};
+
+	/**
+	* The settings of every simulated day.
+	*/
+	simulationParameters _parameters;
+
+	/**
+	* The number of days to simulate.
+	*/
+	int _numOfSimulations;
+
+	/**
+	* The seed of the first day.
+	*/
+	unsigned int _seed;
+
+	/**
+	* The number of worker threads.
+	*/
+	int _numOfWorkers;
+
+	/**
+	* The queue of each worker.
+	*/
+	std::vector<workQueue*> _queues;
+
+	/**
+	* The wait times of each simulation, indexed by simulation number.
+	*/
+	std::vector<waitTimeHistogram> _results;
+
+	/**
+	* The heap allocations the dispatcher and elevators of each simulation
+	* made after their first poll, indexed by simulation number.
+	*/
+	std::vector<ULONGLONG> _allocations;
+
+	/**
+	* The wait times of all the simulations added together.
+	*/
+	waitTimeHistogram _waitTimes;
+
+	/**
+	* Wall clock time the last Run() took in microseconds.
+	*/
+	ULONGLONG _runTime;
+
+	/**
+	* @details Runs simulations until there are none left in any queue.
+	* @param[in] ThreadArgs The worker number.
+	* @return Returns 0 when there is no work left.
+	*/
+	int Worker(void *ThreadArgs);
+
+	/**
+	* @details Takes the next simulation for a worker, from its own queue or
+	* stolen from another worker's.
+	* @param[in] worker The worker number.
+	* @param[out] simulation The simulation number.
+	* @return Returns false when every queue is empty.
+	*/
+	bool NextSimulation(int worker, int &simulation);
+
+	/**
+	* @return Returns the heap allocations of every simulation added together,
+	* or ALLOCATIONS_NOT_COUNTED if they were not counted.
+	*/
+	ULONGLONG TotalAllocations() const;
+
+	/**
+	* @return Returns false if the batch is a rush hour and its dispatchers or
+	* elevators made heap allocations after their first poll.
+	*/
+	bool AllocationFree() const;
+
+};
+
+#endif
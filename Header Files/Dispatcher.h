@@ -1,184 +1,428 @@
-#ifndef __DISPATCHER__
-#define __DISPATCHER__
-
-#include <vector>
-
-#include "rt.h"
-#include "Elevator.h"
-#include "IO.h"
-#include "data.h"
-
-/**
-* @details The Dispatcher class is used to handle the inputs coming froming the
-* IO class. It then sends the input to the correct elevator(s). 
-*/
-class Dispatcher : public ActiveClass {
-
-public:
-
-	/**
-	* Constructor that initializes the member variables.
-	*/
-	Dispatcher(int numOfElevators);
-
-	/**
-	* Destructor that releases the memory for all dynamically allocated objects.
-	*/
-	~Dispatcher();
-
-private:
-
-	/**
-	* Total number of elevators.
-	*/
-	int _numOfElevators;
-
-	/**
-	* Vector of elevator datapools.
-	*/
-	std::vector<CDataPool*> _elevatorDataPools;
-
-	/**
-	* Vector of elevator datapool pointers.
-	*/
-	std::vector<dataPoolData*> _elevatorDataPoolPtrs;
-
-	/**
-	* @details Mutex between the elevator and dispatcher. Since this algorithm
-	* allows for dynamic allocation of elevators, it would be more efficient to use
-	* one mutex instead of (2 * number of elevators) consumer and producer 
-	* semaphores. This mutex is used right before the FindClosestElevator()
-	* algorithm. This is because we need to freeze the elevators temporarily
-	* to compare the elevators to find the closest elevators. If we don't do this,
-	* then the elevator might move as the FindClosestElevator() is trying to find
-	* the right elevator which could result in an error.
-	*/
-	CMutex _DispatcherElevatorMutex;
-
-	/**
-	* The pipeline to receive elevator call information from outside the elevator.
-	*/
-	CPipe _pipeOutside;
-
-	/**
-	* The pipeline to receive elevator call information from inside the elevator.
-	*/
-	CPipe _pipeInside;
-
-	/**
-	* The pipeline to receive fault or termination information to the dispatcher.
-	*/
-	CPipe _faultPipe;
-
-	/**
-	* Char array containing the fault input from the user.
-	*/
-	char _faultInput[2];
-
-	/**
-	* Stores the elevator call for someone outisde the elevator to be sent through
-	* a pipeline to the elevator.
-	*/
-	outsideElevatorData _elevatorCall;
-
-	/**
-	* Stores the elevator call for someone inside the elevator to be sent through
-	* a pipeline to the elevator.
-	*/
-	insideElevatorData _elevatorDestination;
-
-	/**
-	/* @details Vector of pipelines to pipe outside elevator calls to the elevators.
-	*/
-	std::vector<CPipe*> _elevatorPipesOutside;
-
-	/**
-	* @details Vector of pipelines to pipe inside elevator calls to the elevators.
-	*/
-	std::vector<CPipe*> _elevatorPipesInside;
-
-	/**
-	* @details Vector of pipelines to pipe fault data to the elevators.
-	*/
-	std::vector<CPipe*> _elevatorFaultPipe;
-
-	/**
-	* @details Creates the elevator datapools and pipes and polls for the IO data
-	* and sends the inputs to the elevator based on the data received from the IO.
-	*/
-	int main(void);
-
-	/**
-	* @details Creates the datapools and datapool pointers to give the class access 
-	* to the elevator information. All of these objects are stored in a vector.
-	*/
-	void CreateElevatorDataPools();
-
-	/**
-	* @details Instantiates a vector of elevator pipes. There are three pipes. One
-	* is the pipe for elevator calls on the outside, one of for elevator calls on
-	* the inside and the last is for fault/termination calls.
-	*/
-	void CreateElevatorPipes();
-
-	/**
-	* @details Continuously polls for IO data. It tests for the data from the pipes.
-	* If it gets a call from the outside for an elevator it calls a function to
-	* find the closest elevator that is available. If it gets a call from the
-	* inside of the elevator it calls a function to send the elevator to drop the
-	* person off at the desired destination. If it gets a fault input, it sends
-	* the fault info to the elevator. If it gets a termination input, it sends
-	* the termination input to all the elevators.
-	*/
-	void PollForIOData();
-
-	/**
-	* @details Sends the outside elevator call to the closest elevator available
-	* via a pipeline. It calls the FindClosestElevator() function to find the
-	* closest elevator.
-	*/
-	void CallForClosestElevator();
-
-	/**
-	* @details This function runs the main dispatcher algorithm used to find the
-	* closest elevator. It uses a mutex to temporarily freeze the elevators 
-	* and access their datapools to find the optimal elevator.
-	*	If the elevator[i] is going up and has gone past the floor where the person
-	* requests for the elevator, it ignores the request. If the elevator[i] is going
-	* down and has gone past the floor where the person request for the elevator,
-	* it ignores the request and does nothing.
-	*	Else, it checks if the elevator[i] distance to the floor where the person
-	* requested for the elevator is greater than the closestDistance calculated
-	* from looping through the elevators. It also checks if the call direction is
-	* the same as the direction of the elevator. It also checks if the door is not
-	* open and is not faulted. Essentially, in this case, we find the closest elevator
-	* that is moving and can intercept the floor request. If this is true, we set
-	* the closestElevator to this new elevator[i] and set the closestDistance to
-	* the new distance from the elevator[i].
-	*	If we cannot find an elevator, then we reloop through the elevators and 
-	* take the closest one that is busy, ie. any elevator that is stopped and
-	* waiting for the user to input a call inside the elevator.
-	*@return Returns the number of the elevator that is closest to the floor where
-	* the user made a call for the elevator from the outside.
-	*/
-	int FindClosestElevator();
-
-	/**
-	* @details Sends the elevator to the destination call made inside the elevator.
-	*/
-	void SendElevatorToDestination();
-
-	/**
-	* @details Sends the termination input 'ee' to all the elevators via a pipeline.
-	*/
-	void TerminateElevators();
-	
-	/**
-	* @details Send the fault input to the elevator that needs to be faulted via
-	* a pipeline.
-	*/
-	void SendFaultToElevator();
-
-};
-
-#endif
+#ifndef __DISPATCHER__
+#define __DISPATCHER__
+
+#include <vector>
+
+#include "rt.h"
+#include "Elevator.h"
+#include "IO.h"
+#include "data.h"
+#include "FleetSnapshot.h"
+
+const int noDispatchCost = 1000; // Cost of an elevator that cannot take a call, more than any distance
+const int dispatchAttempts = 3; // Elevators a hall call is offered to, closest first, before it is dropped because their pipes stayed full
+const int liveStatusTicks = 4; // Ticks after the dispatcher sends an elevator something that it reads the elevator's own status instead of the snapshot
+
+/**
+* @details The elevators the dispatcher may send calls to. A table is never
+* changed once it has been published, adding or removing an elevator publishes
+* a new one, so the dispatcher can read it at any time without a lock.
+*	- numOfCars: the number of elevators in service
+*	- cars: their elevator numbers, in the order they are looked at
+*	- inService: whether each elevator number is in service
+*/
+struct fleetTable {
+
+	int numOfCars;
+	int cars[maxElevators];
+	bool inService[maxElevators];
+
+};
+
+/**
+* @details What the dispatcher has worked out about one elevator, kept until
+* the elevator's status changes so a call only has to look its cost up.
+*	- status: the status the costs were worked out from
+*	- valid: whether they have been worked out yet
+*	- freeCost: for a call from each floor going up (0) or down (1), the
+*	distance to the elevator if it can stop for the call on its way, or
+*	noDispatchCost if it cannot
+*	- busyCost: the same for an elevator that is busy, as long as it is not
+*	faulted and has not gone past the floor
+*	- sent: whether the dispatcher has sent the elevator a call, destination
+*	or fault
+*	- sentTick: the tick of the latest snapshot when it last did
+*	- sentCall: whether it has sent the elevator a call from outside
+*	- call: the last one, which counts as taken until the elevator's status
+*	shows it has taken it
+*/
+struct carCost {
+
+	dataPoolData status;
+	bool valid;
+	bool sent;
+	unsigned long long sentTick;
+	bool sentCall;
+	outsideElevatorData call;
+	int freeCost[numOfFloors][2];
+	int busyCost[numOfFloors][2];
+
+};
+
+/**
+* @details The Dispatcher class is used to handle the inputs coming froming the
+* IO class. It then sends the input to the correct elevator(s). 
+*	Elevators can be added and taken out of service while it runs, from
+* another thread, with AddElevator() and RemoveElevator(). These copy the
+* fleet table, change the copy and publish it with one pointer swap, then wait
+* until the dispatcher has passed a quiescent point, where it holds no table,
+* before freeing the old one. A search for the closest elevator therefore never
+* waits for them and never sees an elevator whose pipes are not yet made.
+*/
+class Dispatcher : public ActiveClass {
+
+public:
+
+	/**
+	* Constructor that initializes the member variables.
+	* @param[in] numOfElevators The number of elevators.
+	* @param[in] prefix Put in front of the names of the datapools, pipes and
+	* mutex so that several simulations can run side by side.
+	* @param[in] overflowPolicy What to do with a call for an elevator whose
+	* pipe is still full after dispatchTimeout, PIPE_BLOCK, PIPE_REJECT,
+	* PIPE_DROP_OLDEST or PIPE_COALESCE.
+	*/
+	Dispatcher(int numOfElevators, const std::string &prefix = "", int overflowPolicy = PIPE_COALESCE);
+
+	/**
+	* Destructor that releases the memory for all dynamically allocated objects.
+	*/
+	~Dispatcher();
+
+	/**
+	* @return Returns how late the dispatcher has woken up between polls.
+	*/
+	const JITTERSTATISTICS &Jitter() const { return _jitter; }
+
+	/**
+	* @return Returns the number of heap allocations the dispatcher made after the end
+	* of its first poll, or ALLOCATIONS_NOT_COUNTED unless rt.cpp is built with
+	* RT_COUNT_ALLOCATIONS.
+	*/
+	ULONGLONG Allocations() const { return _allocations; }
+
+	/**
+	* @details Makes the dispatcher's pipes to an elevator and adds it to the
+	* fleet table. The elevator's status in the fleet datapool must already be
+	* set up. Must not be called from the dispatcher's own thread.
+	* @param[in] elevatorNumber The elevator to add, below maxElevators.
+	* @return Returns false if the elevator is already in service or the
+	* dispatcher has not started yet.
+	*/
+	bool AddElevator(int elevatorNumber);
+
+	/**
+	* @details Takes an elevator out of the fleet table, so it gets no more
+	* calls, then sends it to floor zero to stop and closes the dispatcher's
+	* pipes to it. Must not be called from the dispatcher's own thread.
+	* @param[in] elevatorNumber The elevator to remove.
+	* @return Returns false if the elevator is not in service.
+	*/
+	bool RemoveElevator(int elevatorNumber);
+
+private:
+
+	/**
+	* Number of elevators the dispatcher starts with.
+	*/
+	int _numOfElevators;
+
+	/**
+	* The fleet table in use, replaced whole by AddElevator() and RemoveElevator().
+	*/
+	fleetTable *volatile _fleet;
+
+	/**
+	* Counts the quiescent points the dispatcher has passed, where it holds no
+	* fleet table.
+	*/
+	volatile LONG _quiescentCount;
+
+	/**
+	* Prefix of the names of the datapools, pipes and mutex.
+	*/
+	std::string _prefix;
+
+	/**
+	* How late the dispatcher has woken up between polls.
+	*/
+	JITTERSTATISTICS _jitter;
+
+	/**
+	* Heap allocations made by the poll loop after its first poll.
+	*/
+	ULONGLONG _allocations;
+
+	/**
+	* What to do with a call for an elevator whose pipe is full.
+	*/
+	int _overflowPolicy;
+
+	/**
+	* Datapool of the whole fleet.
+	*/
+	CDataPool _fleetDataPool;
+
+	/**
+	* @details The status of every elevator as collected at the latest tick.
+	* The dispatcher reads the elevators from here rather than from their
+	* status in the fleet datapool, so it sees them all at the same moment
+	* without stopping them while it compares them.
+	*/
+	FleetSnapshot _snapshot;
+
+	/**
+	* @details Each elevator's own status in the fleet datapool, indexed by
+	* elevator number. Used instead of the snapshot for an elevator the
+	* dispatcher has just sent something, as the snapshot may not show what
+	* the elevator did with it for a tick or more.
+	*/
+	const dataPoolData *_liveStatus;
+
+	/**
+	* @details The cost of each elevator for every call, indexed by elevator
+	* number. Only the elevators whose status changed since the last snapshot
+	* that was looked at are worked out again.
+	*/
+	std::vector<carCost> _costs;
+
+	/**
+	* The tick of the snapshot _costs was last brought up to date with.
+	*/
+	unsigned long long _costTick;
+
+	/**
+	* The elevators whose costs UpdateCosts() is working out again, to take
+	* back if the snapshot turns out to have been written meanwhile.
+	*/
+	std::vector<int> _changedCosts;
+
+	/**
+	* Where the dispatcher waits for the fleet and IO to be ready before it
+	* starts polling.
+	*/
+	CRendezvous _fleetReady;
+
+	/**
+	* Lets one AddElevator() or RemoveElevator() change the fleet table at a time.
+	*/
+	CMutex _fleetWriterMutex;
+
+	/**
+	* The queue to receive elevator call information from outside the elevator.
+	*/
+	outsideCallQueue _pipeOutside;
+
+	/**
+	* The queue to receive elevator call information from inside the elevator.
+	*/
+	insideCallQueue _pipeInside;
+
+	/**
+	* The queue to receive fault or termination information to the dispatcher.
+	*/
+	faultQueue _faultPipe;
+
+	/**
+	* The fault or termination command from the user.
+	*/
+	faultElevatorData _faultInput;
+
+	/**
+	* Stores the elevator call for someone outisde the elevator to be sent through
+	* a pipeline to the elevator.
+	*/
+	outsideElevatorData _elevatorCall;
+
+	/**
+	* Stores the elevator call for someone inside the elevator to be sent through
+	* a pipeline to the elevator.
+	*/
+	insideElevatorData _elevatorDestination;
+
+	/**
+	/* @details Vector of pipelines to pipe outside elevator calls to the elevators,
+	* indexed by elevator number and NULL for the ones not in service.
+	*/
+	std::vector<CPipe*> _elevatorPipesOutside;
+
+	/**
+	* @details Vector of pipelines to pipe inside elevator calls to the elevators.
+	*/
+	std::vector<CPipe*> _elevatorPipesInside;
+
+	/**
+	* @details Vector of pipelines to pipe fault data to the elevators.
+	*/
+	std::vector<CPipe*> _elevatorFaultPipe;
+
+	/**
+	* @details Creates the elevator datapools and pipes and polls for the IO data
+	* and sends the inputs to the elevator based on the data received from the IO.
+	*/
+	int main(void);
+
+	/**
+	* @details Instantiates a vector of elevator pipes. There are three pipes. One
+	* is the pipe for elevator calls on the outside, one of for elevator calls on
+	* the inside and the last is for fault/termination calls. Then publishes the
+	* first fleet table.
+	*/
+	void CreateElevatorPipes();
+
+	/**
+	* @details Makes the three pipes to one elevator.
+	*/
+	void LinkElevator(int elevatorNumber);
+
+	/**
+	* @details Publishes a new fleet table and frees the old one once the
+	* dispatcher can no longer be using it.
+	*/
+	void PublishFleet(fleetTable *fleet);
+
+	/**
+	* @details Sends a terminate to one elevator, trying again for as long as
+	* its fault pipe cannot be written, as an elevator that never gets it never
+	* stops and nothing waiting for it to stop would return.
+	* @param[in] elevatorNumber The elevator to stop.
+	*/
+	void TerminateElevator(int elevatorNumber);
+
+	/**
+	* @details Marks a quiescent point, where the dispatcher holds no fleet table.
+	*/
+	void Quiescent() { InterlockedIncrement(&_quiescentCount); }
+
+	/**
+	* @details Continuously polls for IO data. Each time it takes every message
+	* waiting in each pipe, up to messageBatchSize, and handles them in turn.
+	* If it gets a call from the outside for an elevator it calls a function to
+	* find the closest elevator that is available. If it gets a call from the
+	* inside of the elevator it calls a function to send the elevator to drop the
+	* person off at the desired destination. If it gets a fault input, it sends
+	* the fault info to the elevator. If it gets a termination input, it sends
+	* the termination input to all the elevators and stops. It also stops as
+	* soon as RequestTerminate() is called, and drains the pipes from IO when
+	* it does.
+	*/
+	void PollForIOData();
+
+	/**
+	* @details Reads and throws away whatever is left in the queues from IO, so
+	* nothing writing to them is left waiting for room once the dispatcher
+	* has stopped.
+	*/
+	void DrainPipes();
+
+	/**
+	* @details Logs how many times the pipes to each elevator were found full.
+	*/
+	void LogOverflows();
+
+	/**
+	* @details Sends the outside elevator call to the closest elevator available
+	* via a pipeline. It calls the FindClosestElevator() function to find the
+	* closest elevator.
+	*	If the overflow policy refuses the call because that elevator's pipe
+	* stayed full, the call goes to the next closest one, up to
+	* dispatchAttempts elevators in all, and only then is dropped.
+	*/
+	void CallForClosestElevator();
+
+	/**
+	* @details This function runs the main dispatcher algorithm used to find the
+	* closest elevator. It compares the elevators as they were in a fleet
+	* snapshot, so it never stops them to find the optimal elevator.
+	*	If the elevator[i] is going up and has gone past the floor where the person
+	* requests for the elevator, it ignores the request. If the elevator[i] is going
+	* down and has gone past the floor where the person request for the elevator,
+	* it ignores the request and does nothing.
+	*	Else, it checks if the elevator[i] distance to the floor where the person
+	* requested for the elevator is greater than the closestDistance calculated
+	* from looping through the elevators. It also checks if the call direction is
+	* the same as the direction of the elevator. It also checks if the door is not
+	* open and is not faulted. Essentially, in this case, we find the closest elevator
+	* that is moving and can intercept the floor request. If this is true, we set
+	* the closestElevator to this new elevator[i] and set the closestDistance to
+	* the new distance from the elevator[i].
+	*	If we cannot find an elevator, then we reloop through the elevators and 
+	* take the closest one that is busy, ie. any elevator that is stopped and
+	* waiting for the user to input a call inside the elevator.
+	*	Both are worked out in advance for every floor and direction by
+	* UpdateCost(), so each call only looks up the cost of each elevator.
+	* @param[in] refused Indexed by elevator number, true for the elevators that
+	* have already refused the call and are not looked at, or NULL.
+	*@return Returns the number of the elevator that is closest to the floor where
+	* the user made a call for the elevator from the outside.
+	*/
+	int FindClosestElevator(const bool *refused = NULL);
+
+	/**
+	* @details Works the costs out again for every elevator in service whose
+	* status in the snapshot is not the one they were worked out from. Only
+	* the Live() elevators are looked at if the snapshot is the one looked at
+	* last time. A Live() elevator that has not yet taken the last call it was
+	* sent is looked at as if it had, so calls that come in together are not
+	* all given to the same elevator.
+	* @param[in] snapshot The fleet snapshot to compare the elevators in.
+	* @param[in] sequence The sequence number Read() gave with it.
+	* @return Returns false, and keeps none of the costs worked out from it,
+	* if the snapshot was written while it was being read.
+	*/
+	bool UpdateCosts(const fleetSnapshot *snapshot, long sequence);
+
+	/**
+	* @details Works out the cost of one elevator for a call from each floor
+	* in each direction, using the rules described for FindClosestElevator().
+	* @param[in] elevatorNumber The elevator.
+	* @param[in] status Its status.
+	*/
+	void UpdateCost(int elevatorNumber, const dataPoolData &status);
+
+	/**
+	* @details Checks whether the dispatcher reads an elevator's own status
+	* rather than the snapshot, because it sent the elevator something less
+	* than liveStatusTicks ticks ago.
+	* @param[in] elevatorNumber The elevator.
+	* @param[in] tick The tick of the snapshot that would be read.
+	*/
+	bool Live(int elevatorNumber, unsigned long long tick) const;
+
+	/**
+	* @details Notes that the dispatcher has just sent an elevator something.
+	* @param[in] elevatorNumber The elevator.
+	* @param[in] call The call from outside it was sent, if it was one.
+	*/
+	void Sent(int elevatorNumber, const outsideElevatorData *call = NULL);
+
+	/**
+	* @details Reads one elevator's status from the latest snapshot, or its
+	* own status if it is Live(), reading the snapshot again if it was written
+	* while being read.
+	* @param[in] elevatorNumber The elevator.
+	* @param[out] status Its status.
+	* @return Returns false if the elevator is not in the snapshot yet.
+	*/
+	bool ReadStatus(int elevatorNumber, dataPoolData &status);
+
+	/**
+	* @details Sends the elevator to the destination call made inside the elevator.
+	*/
+	void SendElevatorToDestination();
+
+	/**
+	* @details Sends the termination input 'ee' to all the elevators via a pipeline,
+	* see TerminateElevator().
+	*/
+	void TerminateElevators();
+	
+	/**
+	* @details Send the fault input to the elevator that needs to be faulted via
+	* a pipeline.
+	*/
+	void SendFaultToElevator();
+
+};
+
+#endif
@@ -0,0 +1,74 @@
+#ifndef __FLEETDEADLINES__
+#define __FLEETDEADLINES__
+
+#include "rt.h"
+#include "data.h"
+
+#include <string>
+
+/**
+* @details The FleetDeadlines class keeps the deadlines of every elevator in
+* a process, such as how long a door stays open, on one CTimerWheel and runs
+* it on a thread of its own. When a deadline passes the wheel calls the
+* function it was set with, on that thread, which wakes the elevator waiting
+* for it. IO or a Simulation owns it, so there is one thread for the whole
+* fleet rather than a wheel and a wait per elevator.
+*	It is resumed from the thread of its owner, so in a deterministic
+* simulation it runs on the same scheduler, and the same logical clock, as
+* the elevators. Elevators in child processes keep a wheel of their own.
+*/
+class FleetDeadlines : public ActiveClass {
+
+public:
+
+	/**
+	* Constructor that makes room for a deadline for every elevator, so
+	* setting one never allocates.
+	* @param[in] prefix Put in front of the name of its semaphore.
+	*/
+	FleetDeadlines(const std::string &prefix = "");
+
+	/**
+	* @details Sets a deadline and wakes the thread, so it waits for the new
+	* deadline if that is the next one. Can be called from any thread.
+	* @param[in] delay Microseconds from now.
+	* @param[in] callback Called on the thread of this class when it passes.
+	* @param[in] arg Passed to the callback.
+	* @return Returns the deadline, for Cancel().
+	*/
+	TIMERWHEELID Set(ULONGLONG delay, TIMERWHEELPROC callback, void *arg);
+
+	/**
+	* @details Cancels a deadline. Can be called from any thread.
+	* @param[in] deadline The deadline Set() returned.
+	* @return Returns false if it has already passed.
+	*/
+	bool Cancel(TIMERWHEELID deadline);
+
+	/**
+	* @details Asks the thread to stop and wakes it.
+	*/
+	void Stop();
+
+private:
+
+	/**
+	* The deadlines.
+	*/
+	CTimerWheel _wheel;
+
+	/**
+	* Signalled each time a deadline is set, so the thread looks again at
+	* how long it can wait.
+	*/
+	CSemaphore _deadlineSet;
+
+	/**
+	* @details Calls the deadlines that have passed and waits for the next
+	* one, or for one to be set, until Stop() is called.
+	*/
+	int main(void);
+
+};
+
+#endif
@@ -0,0 +1,66 @@
+#ifndef __FLEETSNAPSHOT__
+#define __FLEETSNAPSHOT__
+
+#include "rt.h"
+#include "data.h"
+
+/**
+* @details The FleetSnapshot class publishes a copy of every elevator's
+* status once per tick, for the dispatcher and anything else that wants to
+* look at the whole fleet at once. The copies are the two snapshot buffers in
+* the fleet datapool, so a dispatcher in another process sees them too.
+*	The one thread that collects the elevators' states, the render thread
+* of IO or a Simulation, writes the buffer that is not the latest and then
+* makes it the latest by changing one index. It never waits for the readers.
+* A reader loads the index and uses that buffer where it is, without a lock
+* or a copy. Only a reader still using a buffer two ticks later will find
+* it has been written again, which Changed() tells it so it can look again.
+*/
+class FleetSnapshot {
+
+public:
+
+	/**
+	* Constructor.
+	* @param[in] fleet The fleet datapool the snapshots are in.
+	*/
+	FleetSnapshot(fleetDataPoolData *fleet);
+
+	/**
+	* @details Copies the states into the buffer that is not the latest and
+	* makes it the latest. Only one thread may publish.
+	* @param[in] states The state of each elevator, indexed by elevator number.
+	* @param[in] numOfElevators The number of elevators.
+	*/
+	void Publish(const dataPoolData *states, int numOfElevators);
+
+	/**
+	* @details Finds the latest snapshot.
+	* @param[out] sequence Its sequence number, to pass to Changed().
+	* @return Returns the latest snapshot.
+	*/
+	const fleetSnapshot *Read(long &sequence) const;
+
+	/**
+	* @details Checks whether a snapshot has been written again since Read()
+	* returned it, in which case what was read from it may be torn.
+	* @param[in] snapshot The snapshot Read() returned.
+	* @param[in] sequence The sequence number Read() gave.
+	*/
+	bool Changed(const fleetSnapshot *snapshot, long sequence) const;
+
+	/**
+	* @return Returns the tick of the latest snapshot, 0 before the first one.
+	*/
+	unsigned long long Tick() const;
+
+private:
+
+	/**
+	* The fleet datapool the snapshots are in.
+	*/
+	fleetDataPoolData *_fleet;
+
+};
+
+#endif
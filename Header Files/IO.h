@@ -1,221 +1,401 @@
-#ifndef __IO__
-#define __IO__
-
-#include "rt.h"
-#include "data.h"
-#include "Elevator.h"
-
-#include <string>
-#include <vector>
-
-class Dispatcher; // Forward declare the Dispatcher class
-
-const int columnSpacing = 4; // Spacing for the columns
-const int rowSpacing = 10; // Spacing for the rows
-
-/**
-* @details The IO class is responsible for instantiating the entire elevator system,
-* getting the user input and updating the display on the screen. 
-*/
-class IO : public ActiveClass {
-
-public:
-
-	/**
-	* Constructor that initializes the member variables.
-	*/
-	IO();
-
-	/**
-	* Destructor that releases the memory for all dynamically allocated objects.
-	*/
-	~IO();
-
-private:
-
-	/**
-	* Number of elevators.
-	*/
-	int _numOfElevators;
-
-	/**
-	* Vector of elevator objects.
-	*/
-	std::vector<Elevator*> _elevators;
-
-	/**
-	* Vector of elevator datapools.
-	*/
-	std::vector<CDataPool*> _elevatorDataPools;
-	
-	/**
-	* Vector of elevator datapool pointers.
-	*/
-	std::vector<dataPoolData*> _elevatorDataPoolPtrs;
-
-	/**
-	* Dispatcher object.
-	*/
-	Dispatcher* _dispatcher;
-
-	/**
-	* Semaphore used to prevent simulataneuous updating of the display by several
-	* functions.
-	*/
-	CSemaphore _displaySemaphore;
-
-	/**
-	* Vector of display ClassThreads.
-	*/
-	std::vector<ClassThread <IO>*> _displayThreads;
-
-	/**
-	* Vector of IO/Elevator producer semaphores.
-	*/
-	std::vector<CSemaphore*> _IOElevatorSemaphoresP;
-
-	/**
-	* Vector of IO/Elevator consumer semaphores.
-	*/
-	std::vector<CSemaphore*> _IOElevatorSemaphoresC;
-	
-	/**
-	* The pipeline to send elevator call information from outside the elevator.
-	*/
-	CPipe _pipeOutside;
-
-	/**
-	* The pipeline to send elevator call information from inside the elevator.
-	*/
-	CPipe _pipeInside;
-
-	/**
-	* The pipeline to send fault or termination information to the dispatcher.
-	*/
-	CPipe _faultPipe;
-
-	/**
-	* Stores the elevator call for someone outisde the elevator to be sent through
-	* a pipeline to the dispatcher.
-	*/
-	outsideElevatorData _elevatorCall;
-
-	/**
-	* Stores the elevator call for someone inside the elevator to be sent through
-	* a pipeline to the dispatcher.
-	*/
-	insideElevatorData _elevatorDestination;
-
-	/**
-	* @details This is the active class' main function that gets the number
-	* of elevators and calls the functions to instantiate the elevators, dispatcher,
-	* datapools and semaphores. It also calls the threads to poll for the user
-	* input and update the console display.
-	*/
-	int main(void);
-
-	/**
-	* @details Get the number of elevators from the user.
-	*/
-	void GetNumberOfElevators();
-
-	/**
-	* @details Instantiates the elevators and dispatcher objects.
-	*/
-	void CreateElevatorSystem();
-
-	/**
-	* @details Instantiates a vector of elevator objects.
-	* @param[in] i The elevator number you wish to create.
-	*/
-	void CreateElevator(int i);
-
-	/**
-	* @details Instantiates a vector of elevator data pools and
-	* assigns them with default values.
-	*/
-	void CreateElevatorDataPools();
-
-	/**
-	* @details Instantiates a vector of dispatcher objects.
-	*/
-	void CreateDispatcher();
-
-	/**
-	* @details Instantiates a vector of producer consumer semaphores
-	* that will be used between the IO and elevator objects.
-	*/
-	void CreateSemaphores();
-
-	/**
-	* @details Polls for the user input. If a valid input is entered
-	* it sends it via a pipe to the dispatcher.
-	* @return Returns 0 when 'ee' is pressed and stops polling.
-	*/
-	int PollForUserInput(void *ThreadArgs);
-
-	/**
-	* @details Initializes the console display. First it prints the title
-	* and then it prints out the floor numbers. Finally, it prints out the
-	* elevators with a green text colour.
-	*/
-	void InitializeDisplay();
-
-	/**
-	* @details Turns the cursor off and creates a vector of display ClassThreads
-	* that runs the UpdateDisplay thread for each elevator.
-	*/
-	void UpdateDisplays();
-
-	/**
-	* @details Updates the display of the elevators with the new status
-	* updates. It first erases the current display of the elevator. It then
-	* updates the elevator location, fault status and door status.
-	* @return Returns 0 when the thread is done.
-	*/
-	int UpdateDisplay(void *ThreadArgs);
-
-	/**
-	* @details Loops through the elevator graphics for one of the elevators
-	* and erases it from the console display.
-	* @param[in] x The x location of where the elevator is.
-	*/
-	void Erase(int x);
-
-	/**
-	* @details Updates the elevator to display it's fault status (turns red
-	* if the elevator is faulted). Moves the elevator to the new location
-	* based on the inputs x and y. Opens the elevator door based on the status in
-	* the datapool.
-	* @param[in] elevator The elevator number.
-	* @param[in] x The x location of the elevator.
-	* @param[in] y The y location of the elevator.
-	*/
-	void UpdateElevator(int elevator, int x, int y);
-
-	/**
-	* @details Updates the display with an arrow showing whether the elevator
-	* is going up or down.
-	* @param[in] elevator The elevator number.
-	* @param[in] x The x location of the elevator.
-	*/
-	void UpdateElevatorDirection(int elevator, int x);
-
-	/**
-	* @details Prints out a statement to get the user command.
-	*/
-	void PrintGetUserCommand();
-	
-	/**
-	* @details Prints out the user command.
-	*/
-	void PrintUserCommand(char input1, char input2);
-	
-	/**
-	* @details Prints out the title "SUPER SIMS 2000" in fancy ASCII text.
-	*/
-	void PrintTitle();
-
-};
-
+#ifndef __IO__
+#define __IO__
+
+#include "rt.h"
+#include "data.h"
+#include "Elevator.h"
+#include "FleetDeadlines.h"
+#include "FleetSnapshot.h"
+#include "InputReader.h"
+#include "TraceWriter.h"
+#include "TraceReplayer.h"
+#include "ProcessGroup.h"
+#include "config.h"
+
+#include <string>
+#include <vector>
+
+class Dispatcher; // Forward declare the Dispatcher class
+
+const int columnSpacing = 4; // Spacing for the columns
+const int rowSpacing = 10; // Spacing for the rows
+const int framePeriod = 500; // Time between display frames in milliseconds
+const int consoleBackend = ANSI_CONSOLE; // Draw with buffered escape sequences, flushed once per frame
+const int inputPollPeriod = 50; // Time between reads of the user input in milliseconds
+const int pinnedProcessors = 3; // Processors needed to pin IO, the dispatcher and the elevators to their own
+const char refusedCommandEcho[] = "Refused"; // Shown instead of a command that could not be carried out, the event log says why
+
+/**
+* @details The IO class is responsible for instantiating the entire elevator system,
+* getting the user input and updating the display on the screen. 
+*/
+class IO : public ActiveClass {
+
+public:
+
+	/**
+	* Constructor that initializes the member variables.
+	* @param[in] config Where to read the user commands from and the traces
+	* to record or replay. The defaults read the standard input, which may be
+	* the keyboard or a pipe.
+	*/
+	IO(const simulationConfig &config = simulationConfig());
+
+	/**
+	* Destructor that releases the memory for all dynamically allocated objects.
+	*/
+	~IO();
+
+private:
+
+	/**
+	* Number of elevators.
+	*/
+	int _numOfElevators;
+
+	/**
+	* Vector of elevator objects.
+	*/
+	std::vector<Elevator*> _elevators;
+
+	/**
+	* Datapool of the whole fleet, made before any elevator.
+	*/
+	CDataPool* _fleetDataPool;
+
+	/**
+	* Where IO waits for every elevator and the dispatcher to be ready.
+	*/
+	CRendezvous* _fleetReady;
+
+	/**
+	* The fleet snapshot the render thread publishes each frame for the dispatcher.
+	*/
+	FleetSnapshot* _snapshot;
+	
+	/**
+	* Vector of elevator datapool pointers, into the fleet datapool.
+	*/
+	std::vector<dataPoolData*> _elevatorDataPoolPtrs;
+
+	/**
+	* Dispatcher object.
+	*/
+	Dispatcher* _dispatcher;
+
+	/**
+	* The deadlines of the elevators, NULL while they run in child processes.
+	*/
+	FleetDeadlines* _fleetDeadlines;
+
+	/**
+	* The dispatcher and elevator processes when _config.processExecutable is
+	* set, in which case there are no elevator or dispatcher objects.
+	*/
+	ProcessGroup* _processes;
+
+	/**
+	* Semaphore used to prevent simulataneuous updating of the display by several
+	* functions.
+	*/
+	CSemaphore _displaySemaphore;
+
+	/**
+	* The render ClassThread that draws every elevator once per frame.
+	*/
+	ClassThread <IO>* _renderThread;
+
+	/**
+	* The ClassThread that reads the user input.
+	*/
+	ClassThread <IO>* _inputThread;
+
+	/**
+	* Copy of each elevator's datapool taken at the start of the current frame.
+	*/
+	std::vector<dataPoolData> _frame;
+
+	/**
+	* Whether the elevator has signalled a change since the last frame.
+	*/
+	std::vector<bool> _frameChanged;
+
+	/**
+	* Vector of IO/Elevator producer semaphores.
+	*/
+	std::vector<CSemaphore*> _IOElevatorSemaphoresP;
+
+	/**
+	* Vector of IO/Elevator consumer semaphores.
+	*/
+	std::vector<CSemaphore*> _IOElevatorSemaphoresC;
+	
+	/**
+	* The queue to send elevator call information from outside the elevator.
+	*/
+	outsideCallQueue _pipeOutside;
+
+	/**
+	* The queue to send elevator call information from inside the elevator.
+	*/
+	insideCallQueue _pipeInside;
+
+	/**
+	* The queue to send fault or termination information to the dispatcher.
+	*/
+	faultQueue _faultPipe;
+
+	/**
+	* The options the system was started with.
+	*/
+	simulationConfig _config;
+
+	/**
+	* Reads and parses the user commands without blocking.
+	*/
+	InputReader* _inputReader;
+
+	/**
+	* Records the user commands when _config.recordFile is set.
+	*/
+	TraceWriter* _traceWriter;
+
+	/**
+	* Replays _config.replayFile into the dispatcher when it is set.
+	*/
+	TraceReplayer* _traceReplayer;
+
+	/**
+	* GET_TIME_US() when the system was created, the start of a recorded trace.
+	*/
+	ULONGLONG _startTime;
+
+	/**
+	* @details The last command entered, shown on the display by the render
+	* thread. The input thread writes it without waiting for the display, and
+	* the render thread copies it until _commandEchoSequence says the copy is
+	* whole.
+	*/
+	char _commandEcho[commandLength];
+
+	/**
+	* Odd while the input thread writes _commandEcho, and one more each time it
+	* starts or finishes.
+	*/
+	volatile LONG _commandEchoSequence;
+
+	/**
+	* @details This is the active class' main function that gets the number
+	* of elevators and calls the functions to instantiate the elevators, dispatcher,
+	* datapools and semaphores. It also calls the threads to poll for the user
+	* input and update the console display. It returns once 'ee' has stopped
+	* the system or RequestTerminate() has been called, and every thread has ended.
+	*/
+	int main(void);
+
+	/**
+	* @details Stops every thread and waits for it to end. Unless 'ee' has
+	* already sent the elevators to floor zero, the dispatcher and elevators
+	* are asked to terminate. The display keeps collecting the elevator states
+	* until they have ended, as they wait for it between floors.
+	*/
+	void StopElevatorSystem();
+
+	/**
+	* @details Get the number of elevators from the user.
+	*/
+	void GetNumberOfElevators();
+
+	/**
+	* @details Instantiates the elevators and dispatcher objects, or starts
+	* them as processes if _config.processExecutable is set.
+	*/
+	void CreateElevatorSystem();
+
+	/**
+	* @details Starts the dispatcher and groups of _config.elevatorsPerProcess
+	* elevators as child processes.
+	* @return Returns false if they cannot be processes with the current
+	* options, and the threads should be created instead.
+	*/
+	bool CreateElevatorProcesses();
+
+	/**
+	* @details Instantiates every elevator object without starting them. Each
+	* elevator makes its own pipes, so they are made by a thread per
+	* processor, or one after another when the scheduler is deterministic.
+	*/
+	void CreateElevators();
+
+	/**
+	* @details Thread of CreateElevators() that takes the next elevator number
+	* from a shared counter until every elevator has been made.
+	* @param[in] ThreadArgs Points to the counter, a volatile LONG.
+	*/
+	int CreateElevatorWorker(void *ThreadArgs);
+
+	/**
+	* @details Waits until every elevator and the dispatcher have met IO at the
+	* fleet's rendezvous and logs how long the fleet took to be ready, for
+	* example "fleet ready 256 elevators in 41230us".
+	* @param[in] createStart GET_TIME_US() when the fleet started being made.
+	*/
+	void WaitForFleet(ULONGLONG createStart);
+
+	/**
+	* @details Sets the priority of a thread and, if _config.pinThreads is set,
+	* the processors it runs on. With fewer than pinnedProcessors no thread is
+	* pinned, which the constructor logs, as the dispatcher would have to share.
+	* The elevators' range is cut down to the processors there are.
+	* @param[in] thread The thread to place.
+	* @param[in] priority The THREAD_PRIORITY_ for the thread.
+	* @param[in] firstProcessor The first processor the thread may run on.
+	* @param[in] lastProcessor The last processor the thread may run on.
+	*/
+	void PlaceThread(const CThread &thread, int priority, int firstProcessor, int lastProcessor);
+
+	/**
+	* @details Writes how late the dispatcher and the elevators woke up from
+	* their polling sleeps to the event log, to compare thread priorities and
+	* pinning. A poll more than JITTER_LATE_LIMIT late counts as late.
+	*/
+	void LogJitter() const;
+
+	/**
+	* @details Creates the fleet datapool in one step, assigns every
+	* elevator's status default values, and creates the fleet's rendezvous.
+	*/
+	void CreateElevatorDataPools();
+
+	/**
+	* @details Adds an elevator's status to the fleet datapool, with default values.
+	* @param[in] elevator The elevator number.
+	*/
+	void CreateElevatorStatus(int elevator);
+
+	/**
+	* @details Adds an elevator's producer and consumer semaphores.
+	* @param[in] elevator The elevator number.
+	*/
+	void CreateElevatorSemaphores(int elevator);
+
+	/**
+	* @details Puts a new elevator into service while the system runs, with
+	* the next elevator number, and shows it on the display. Only possible
+	* while the dispatcher is a thread of this process.
+	* @return Returns false, with the reason in the event log, if the fleet
+	* is full or the dispatcher cannot take another elevator.
+	*/
+	bool AddElevator();
+
+	/**
+	* @details Takes an elevator out of service while the system runs. The
+	* dispatcher stops sending it calls and sends it to floor zero to stop.
+	* @param[in] elevator The elevator number.
+	* @return Returns false, with the reason in the event log, if the
+	* elevator is not in service.
+	*/
+	bool RemoveElevator(int elevator);
+
+	/**
+	* @details Instantiates the dispatcher object without starting it.
+	*/
+	void CreateDispatcher();
+
+	/**
+	* @details Instantiates a vector of producer consumer semaphores
+	* that will be used between the IO and elevator objects.
+	*/
+	void CreateSemaphores();
+
+	/**
+	* @details Polls for the user input. Every command that has arrived since
+	* the last poll is parsed and the whole batch is sent to the dispatcher.
+	* @return Returns 0 when 'ee' is entered or the input ends, and stops polling.
+	*/
+	int PollForUserInput(void *ThreadArgs);
+
+	/**
+	* @details Sends a batch of commands to the dispatcher, one message at a
+	* time, and records it if a trace is being recorded.
+	* Elevators are added and removed here first, and are not recorded.
+	* @param[in] batch The commands to send.
+	* @return Returns false if an elevator could not be added or removed.
+	*/
+	bool PostUserCommands(const commandBatch &batch);
+
+	/**
+	* @details Initializes the console display. First it prints the title
+	* and then it prints out the floor numbers. Finally, it prints out the
+	* elevators with a green text colour.
+	*/
+	void InitializeDisplay();
+
+	/**
+	* @details Turns the cursor off and creates the render ClassThread that
+	* runs the RenderDisplay thread for all of the elevators.
+	*/
+	void UpdateDisplays();
+
+	/**
+	* @details Draws one frame every framePeriod milliseconds. At the start of
+	* the frame it collects the state of every elevator that has signalled a
+	* change, and lets those elevators continue straight away. It then draws
+	* the collected elevators, so the cost of a frame does not depend on how
+	* many elevators there are.
+	* @return Returns 0 when the thread is done.
+	*/
+	int RenderDisplay(void *ThreadArgs);
+
+	/**
+	* @details Updates the display of one elevator with the state collected
+	* for this frame. It first erases the current display of the elevator. It
+	* then updates the elevator location, fault status and door status.
+	* @param[in] elevator The elevator number.
+	*/
+	void UpdateDisplay(int elevator);
+
+	/**
+	* @details Loops through the elevator graphics for one of the elevators
+	* and erases it from the console display.
+	* @param[in] x The x location of where the elevator is.
+	*/
+	void Erase(int x);
+
+	/**
+	* @details Updates the elevator to display it's fault status (turns red
+	* if the elevator is faulted). Moves the elevator to the new location
+	* based on the inputs x and y. Opens the elevator door based on the status in
+	* the datapool.
+	* @param[in] elevator The elevator number.
+	* @param[in] x The x location of the elevator.
+	* @param[in] y The y location of the elevator.
+	*/
+	void UpdateElevator(int elevator, int x, int y);
+
+	/**
+	* @details Updates the display with an arrow showing whether the elevator
+	* is going up or down.
+	* @param[in] elevator The elevator number.
+	* @param[in] x The x location of the elevator.
+	*/
+	void UpdateElevatorDirection(int elevator, int x);
+
+	/**
+	* @details Prints out a statement to get the user command.
+	*/
+	void PrintGetUserCommand();
+	
+	/**
+	* @details Prints out the last user command.
+	*/
+	void PrintUserCommand();
+	
+	/**
+	* @details Prints out the title "SUPER SIMS 2000" in fancy ASCII text.
+	*/
+	void PrintTitle();
+
+};
+
 #endif
\ No newline at end of file
@@ -0,0 +1,227 @@
+#ifndef __INPUTREADER__
+#define __INPUTREADER__
+
+#include "rt.h"
+#include "data.h"
+
+#include <string>
+#include <vector>
+
+const int inputBufferSize = 4096; // Number of bytes read from the input at once
+const int commandLength = 16; // Longest command that can be entered
+
+/**
+* @details The queues into the dispatcher. Anything may write to them, IO, a
+* trace being replayed or another process, without waiting for each other.
+*/
+typedef CTypedMessageQueue<outsideElevatorData> outsideCallQueue;
+typedef CTypedMessageQueue<insideElevatorData> insideCallQueue;
+typedef CTypedMessageQueue<faultElevatorData> faultQueue;
+
+/**
+* @details The commands parsed from one read of the input, grouped by the
+* queue they are sent to. Post() writes them one message at a time, so a
+* batch is not sent in one piece and other writers' messages may come
+* between them.
+*/
+struct commandBatch {
+
+	std::vector<outsideElevatorData> outsideCalls;
+	std::vector<insideElevatorData> insideCalls;
+	std::vector<faultElevatorData> faults;
+	std::vector<faultElevatorData> fleetChanges;
+
+	int Size() const { return (int)(outsideCalls.size() + insideCalls.size() + faults.size() + fleetChanges.size()); }
+	void Clear() { outsideCalls.clear(); insideCalls.clear(); faults.clear(); fleetChanges.clear(); }
+
+	/**
+	* @details Sends the batch to the dispatcher, one message at a time. The
+	* fleet changes are not sent, they are for whoever owns the elevators.
+	*	While a queue is full it waits a poll period at a time, giving up
+	* once the thread posting it is asked to terminate, so it is never left
+	* waiting for a dispatcher that has stopped reading.
+	* @param[in] poster The thread posting the batch.
+	* @return Returns true if every message was sent.
+	*/
+	bool Post(outsideCallQueue &pipeOutside, insideCallQueue &pipeInside, faultQueue &faultPipe, const ActiveClass &poster) const;
+
+};
+
+/**
+* @details The InputReader class reads user commands from the keyboard, a pipe
+* or a file without ever blocking. Each call to Read() takes every byte that is
+* currently available, parses any number of commands out of it and returns them
+* as one batch.
+*	Commands are separated by spaces, new lines, ',' or ';':
+*	- 'u5', 'd12': call an elevator to go up or down from a floor
+*	- '2:14': a passenger in elevator 2 wants to go to floor 14
+*	- '24': the same for single digit elevators and floors, ie. elevator 2 to floor 4
+*	- '-3', '+3': fault elevator 3 or clear its fault
+*	- 'a': add an elevator to the fleet
+*	- 'r3': take elevator 3 out of service
+*	- 'ee': send every elevator to floor zero and stop reading
+*	A command also ends without a separator as soon as no more digits could
+* be added to it, so 'u5' or '24' typed on the keyboard are taken straight away
+* in a building with no more than 10 floors and 10 elevators.
+*/
+class InputReader {
+
+public:
+
+	/**
+	* Constructor that reads from the standard input, which may be the keyboard,
+	* a pipe or a redirected file.
+	* @param[in] numOfElevators The number of elevators, used to check commands.
+	*/
+	InputReader(int numOfElevators);
+
+	/**
+	* Constructor that reads the commands from a file.
+	* @param[in] numOfElevators The number of elevators, used to check commands.
+	* @param[in] fileName The file containing the commands.
+	*/
+	InputReader(int numOfElevators, const std::string &fileName);
+
+	/**
+	* Destructor that closes the input file if one was opened.
+	*/
+	~InputReader();
+
+	/**
+	* @details Reads every byte that is available right now and parses it.
+	* It never waits for more input to arrive.
+	* @param[out] batch The commands that were parsed are added to this batch.
+	* @return Returns the number of commands added to the batch.
+	*/
+	int Read(commandBatch &batch);
+
+	/**
+	* @details Parses a block of bytes that has already been read. Bytes that
+	* do not finish a command are kept and used by the next call.
+	* @param[in] data The bytes to parse.
+	* @param[in] size The number of bytes.
+	* @param[out] batch The commands that were parsed are added to this batch.
+	* @return Returns the number of commands added to the batch.
+	*/
+	int Parse(const char *data, int size, commandBatch &batch);
+
+	/**
+	* @return Returns true once the terminate command 'ee' has been read.
+	*/
+	bool Terminated() const { return _terminated; }
+
+	/**
+	* @return Returns true when the pipe or file being read has no more data.
+	*/
+	bool EndOfInput() const { return _endOfInput; }
+
+	/**
+	* @return Returns the text of the last command that was accepted.
+	*/
+	const char *LastCommand() const { return _lastCommand; }
+
+	/**
+	* @details Changes the number of elevators commands are checked against,
+	* when one has been added.
+	* @param[in] numOfElevators The number of elevators.
+	*/
+	void SetNumOfElevators(int numOfElevators) { _numOfElevators = numOfElevators; }
+
+private:
+
+	/**
+	* Number of elevators.
+	*/
+	int _numOfElevators;
+
+	/**
+	* Handle of the keyboard, pipe or file being read.
+	*/
+	HANDLE _input;
+
+	/**
+	* Whether the handle was opened by this class and needs to be closed.
+	*/
+	bool _ownsInput;
+
+	/**
+	* Type of the input handle, FILE_TYPE_CHAR for the keyboard, FILE_TYPE_PIPE
+	* or FILE_TYPE_DISK.
+	*/
+	DWORD _inputType;
+
+	/**
+	* Whether the terminate command has been read.
+	*/
+	bool _terminated;
+
+	/**
+	* Whether the input has no more data.
+	*/
+	bool _endOfInput;
+
+	/**
+	* The characters of the command currently being entered.
+	*/
+	char _token[commandLength];
+
+	/**
+	* Number of characters in _token.
+	*/
+	int _tokenLength;
+
+	/**
+	* The last command that was accepted.
+	*/
+	char _lastCommand[commandLength];
+
+	/**
+	* Buffer the input is read into.
+	*/
+	char _buffer[inputBufferSize];
+
+	/**
+	* @details Copies whatever the standard input stream has already buffered,
+	* for example the rest of the line after the number of elevators, so that
+	* none of it is lost by reading the handle directly.
+	* @return Returns the number of bytes copied into the buffer.
+	*/
+	int ReadBufferedStream();
+
+	/**
+	* @details Reads the bytes that are available from the input handle without
+	* waiting.
+	* @return Returns the number of bytes read into the buffer.
+	*/
+	int ReadAvailable();
+
+	/**
+	* @details Checks whether the command in _token cannot get any longer, so it
+	* can be taken without waiting for a separator.
+	*/
+	bool TokenComplete() const;
+
+	/**
+	* @details Parses the command in _token and adds it to the batch if it is valid.
+	* @return Returns true if a command was added.
+	*/
+	bool ParseToken(commandBatch &batch);
+
+	/**
+	* @details Reads a number from the text and checks that it is below the limit.
+	* @param[in] text The digits to read.
+	* @param[in] limit The number must be less than this.
+	* @param[out] number The number that was read.
+	* @return Returns true if the text is a valid number.
+	*/
+	static bool ParseNumber(const char *text, int limit, int &number);
+
+	/**
+	* @details Checks whether a number that has been partly typed could not get
+	* any more digits without going over the limit.
+	*/
+	static bool NumberComplete(const char *text, int limit);
+
+};
+
+#endif
@@ -0,0 +1,110 @@
+#ifndef __PROCESSGROUP__
+#define __PROCESSGROUP__
+
+#include "rt.h"
+#include "config.h"
+
+#include <string>
+#include <vector>
+
+const int processCheckPeriod = 1000; // Milliseconds a child process waits between checks that its parent is still running
+const int processExitTimeout = 5000; // Milliseconds to wait for a process or thread to stop before it is killed
+
+/**
+* @details The ProcessGroup class runs the dispatcher and the elevators in
+* child processes instead of threads of the IO process. The children are the
+* same executable started again with arguments that tell it which part to run,
+* so the program's main() must call RunChild() first and return straight away
+* if it returns true. Everything is still connected by the named datapools,
+* pipes, mutexes and semaphores, which only work between processes while
+* GET_OBJECT_SCOPE() is GLOBAL_OBJECTS.
+*	Each child can be pinned to a processor or NUMA node of its own, and it
+* stops when the group is deleted or its parent process dies, so one crashing
+* elevator controller does not take the others with it.
+*/
+class ProcessGroup {
+
+public:
+
+	/**
+	* Constructor that creates the event the children wait for to stop.
+	* @param[in] executable The program to start for each child.
+	* @param[in] prefix The object name prefix the children use.
+	* @param[in] affinity noAffinity, coreAffinity or numaAffinity.
+	*/
+	ProcessGroup(const std::string &executable, const std::string &prefix, int affinity);
+
+	/**
+	* Destructor that asks every child to stop, waits for them and kills any
+	* that have not stopped after processExitTimeout.
+	*/
+	~ProcessGroup();
+
+	/**
+	* @details Starts the dispatcher in a process of its own.
+	* @param[in] numOfElevators The number of elevators.
+	*/
+	void StartDispatcher(int numOfElevators);
+
+	/**
+	* @details Starts a process running a group of elevators.
+	* @param[in] first The number of the first elevator in the group.
+	* @param[in] count The number of elevators in the group.
+	*/
+	void StartElevators(int first, int count);
+
+	/**
+	* @return Returns the number of child processes started.
+	*/
+	int Size() const { return (int)_processes.size(); }
+
+	/**
+	* @details Runs the dispatcher or a group of elevators if the arguments
+	* are the ones StartDispatcher() or StartElevators() gave the process, and
+	* returns once the group is deleted or the parent process has died.
+	* @param[in] argc The argc of main().
+	* @param[in] argv The argv of main().
+	* @return Returns true if this process was a child and has finished, false
+	* if it is not a child and should carry on as normal.
+	*/
+	static bool RunChild(int argc, char *argv[]);
+
+private:
+
+	/**
+	* The program to start for each child.
+	*/
+	std::string _executable;
+
+	/**
+	* The object name prefix the children use.
+	*/
+	std::string _prefix;
+
+	/**
+	* Where the children are allowed to run, noAffinity, coreAffinity or numaAffinity.
+	*/
+	int _affinity;
+
+	/**
+	* Event signalled to ask every child to stop.
+	*/
+	CEvent _stopEvent;
+
+	/**
+	* The child processes.
+	*/
+	std::vector<CProcess*> _processes;
+
+	/**
+	* @details Starts a child process suspended, pins it according to
+	* _affinity and lets it run. With coreAffinity the children take the
+	* processors after the first one in turn, leaving the first to this
+	* process. With numaAffinity they take the nodes in turn from the first.
+	* @param[in] arguments The arguments telling the child what to run.
+	*/
+	void Start(const std::string &arguments);
+
+};
+
+#endif
@@ -0,0 +1,321 @@
+#ifndef __SIMULATION__
+#define __SIMULATION__
+
+#include "rt.h"
+#include "data.h"
+#include "Elevator.h"
+#include "FleetDeadlines.h"
+#include "Dispatcher.h"
+#include "InputReader.h"
+
+#include <string>
+#include <vector>
+
+const int simulationStep = 500; // Simulated milliseconds between two looks at the elevators, the same as the IO frame
+const int hallCallRetryPeriod = 30000; // Simulated milliseconds before a waiting passenger presses the call button again
+const int waitTimeBuckets = 600; // One second buckets of the wait time histogram, longer waits go in the last one
+
+/**
+* @details The settings of one simulated day.
+*	- numOfElevators: the number of elevators in the building
+*	- dayLength: the length of the day in simulated seconds
+*	- arrivalRate: the average number of passengers arriving per simulated
+*	  minute, each at a random floor going to another random floor
+*/
+struct simulationParameters {
+
+	int numOfElevators;
+	int dayLength;
+	double arrivalRate;
+
+	simulationParameters() : numOfElevators(4), dayLength(3600), arrivalRate(6.0) {}
+
+};
+
+/**
+* @details The distribution of the time passengers waited for an elevator,
+* from pressing the call button to the doors opening for them.
+*	- buckets: the number of passengers that waited each whole number of
+*	  seconds, the last bucket has everyone who waited longer
+*	- passengers: the number of passengers that got an elevator
+*	- unserved: the number of passengers still waiting at the end of the day
+*	- totalWait: the sum of the wait times in seconds
+*	- maxWait: the longest wait in seconds
+*/
+struct waitTimeHistogram {
+
+	std::vector<int> buckets;
+	int passengers;
+	int unserved;
+	double totalWait;
+	double maxWait;
+
+	waitTimeHistogram() : buckets(waitTimeBuckets, 0), passengers(0), unserved(0), totalWait(0), maxWait(0) {}
+
+	void Add(double waitTime);
+	void Merge(const waitTimeHistogram &o);
+	double Mean() const;
+
+	/**
+	* @return Returns the wait time in seconds that the given fraction of the
+	* passengers waited no longer than, to the nearest second above.
+	*/
+	double Percentile(double fraction) const;
+
+};
+
+/**
+* @details The Simulation active class runs one simulated day of the elevator
+* system without a display. It creates its own dispatcher, elevators,
+* datapools, pipes and semaphores, with names starting with a prefix so that
+* many simulations can run in one process without sharing anything.
+*	It takes the place of the IO class. Once per simulationStep it collects
+* the state of every elevator, lets passengers arrive at random and press the
+* call button, and boards waiting passengers when an elevator opens its doors
+* for them, sending their destinations to the dispatcher.
+*	Run it on a CDeterministicScheduler so the day passes as fast as the
+* processor allows and the same seed always gives the same day.
+*/
+class Simulation : public ActiveClass {
+
+public:
+
+	/**
+	* Constructor that creates the pipes to the dispatcher.
+	* @param[in] parameters The settings of the day.
+	* @param[in] prefix Put in front of the name of every object, it must be
+	* different for each simulation running at the same time.
+	*/
+	Simulation(const simulationParameters &parameters, const std::string &prefix);
+
+	/**
+	* Destructor.
+	*/
+	~Simulation();
+
+	/**
+	* @return Returns the wait times of the day, complete once the thread has ended.
+	*/
+	const waitTimeHistogram &WaitTimes() const { return _waitTimes; }
+
+	/**
+	* @return Returns the heap allocations the dispatcher and elevators made
+	* after their first poll, complete once the thread has ended, or
+	* ALLOCATIONS_NOT_COUNTED if they were not counted.
+	*/
+	ULONGLONG HotPathAllocations() const { return _hotPathAllocations; }
+
+private:
+
+	/**
+	* @details A passenger waiting for an elevator.
+	*	- callTime: GET_TIME_US() when the passenger arrived
+	*	- floor: the floor the passenger is waiting on
+	*	- destination: the floor the passenger wants to go to
+	*	- direction: UP or DOWN
+	*/
+	struct passenger {
+
+		ULONGLONG callTime;
+		int floor;
+		int destination;
+		char direction;
+
+	};
+
+	/**
+	* @details The up or down call button of a floor, passed to the retry
+	* timer so it knows which button to press again.
+	*	- simulation: the simulation the button belongs to
+	*	- floor: the floor of the button
+	*	- direction: UP or DOWN
+	*	- waiting: the number of passengers waiting for this button
+	*	- retry: the timer that presses the button again, set while anyone is waiting
+	*/
+	struct hallButton {
+
+		Simulation *simulation;
+		int floor;
+		char direction;
+		int waiting;
+		TIMERWHEELID retry;
+
+	};
+
+	/**
+	* The settings of the day.
+	*/
+	simulationParameters _parameters;
+
+	/**
+	* Prefix of the name of every object.
+	*/
+	std::string _prefix;
+
+	/**
+	* The queue to send elevator call information from outside the elevator.
+	*/
+	outsideCallQueue _pipeOutside;
+
+	/**
+	* The queue to send elevator call information from inside the elevator.
+	*/
+	insideCallQueue _pipeInside;
+
+	/**
+	* The queue to send fault or termination information to the dispatcher.
+	*/
+	faultQueue _faultPipe;
+
+	/**
+	* Vector of elevator objects.
+	*/
+	std::vector<Elevator*> _elevators;
+
+	/**
+	* Dispatcher object.
+	*/
+	Dispatcher* _dispatcher;
+
+	/**
+	* The deadlines of the elevators.
+	*/
+	FleetDeadlines* _fleetDeadlines;
+
+	/**
+	* Heap allocations made by the dispatcher and elevators after their first poll.
+	*/
+	ULONGLONG _hotPathAllocations;
+
+	/**
+	* Datapool of the whole fleet.
+	*/
+	CDataPool* _fleetDataPool;
+
+	/**
+	* Where the simulation waits for the elevators and dispatcher to be ready.
+	*/
+	CRendezvous* _fleetReady;
+
+	/**
+	* The fleet snapshot published for the dispatcher each time the states are collected.
+	*/
+	FleetSnapshot* _snapshot;
+
+	/**
+	* Vector of elevator datapool pointers, into the fleet datapool.
+	*/
+	std::vector<dataPoolData*> _elevatorDataPoolPtrs;
+
+	/**
+	* Vector of IO/Elevator producer semaphores.
+	*/
+	std::vector<CSemaphore*> _IOElevatorSemaphoresP;
+
+	/**
+	* Vector of IO/Elevator consumer semaphores.
+	*/
+	std::vector<CSemaphore*> _IOElevatorSemaphoresC;
+
+	/**
+	* The last state collected from each elevator.
+	*/
+	std::vector<dataPoolData> _state;
+
+	/**
+	* Whether the passengers have already boarded at the stop each elevator is at.
+	*/
+	std::vector<bool> _stopServed;
+
+	/**
+	* The passengers waiting for an elevator.
+	*/
+	std::vector<passenger> _waiting;
+
+	/**
+	* The call buttons of every floor, up then down.
+	*/
+	std::vector<hallButton> _hallButtons;
+
+	/**
+	* Timers that press the call buttons again, made by main() so its ticks
+	* follow the clock of the thread the day runs on.
+	*/
+	CTimerWheel *_retryTimers;
+
+	/**
+	* The calls to send to the dispatcher at the end of the current step.
+	*/
+	commandBatch _batch;
+
+	/**
+	* The wait times of the day.
+	*/
+	waitTimeHistogram _waitTimes;
+
+	/**
+	* @details Creates the elevator system, runs the day and shuts it down.
+	*/
+	int main(void);
+
+	/**
+	* @details Creates the fleet datapool, semaphores, elevators and
+	* dispatcher, starts them and waits until they are all ready.
+	*/
+	void CreateElevatorSystem();
+
+	/**
+	* @details Asks the dispatcher and elevators to stop, keeps the elevators
+	* moving until they have, then deletes everything CreateElevatorSystem() made.
+	*/
+	void DestroyElevatorSystem();
+
+	/**
+	* @details Takes the state of every elevator that has changed and lets the
+	* elevator carry on, the same as a display frame of the IO class.
+	*/
+	void CollectElevatorStates();
+
+	/**
+	* @details Boards the passengers going the elevator's way when it is
+	* stopped with its doors open to pick up, and sends their destinations. If
+	* nobody is there the elevator is sent to its own floor to close its doors.
+	* The car calls are added to _batch.
+	* @param[in] elevator The elevator number.
+	*/
+	void BoardPassengers(int elevator);
+
+	/**
+	* @details Adds the passengers that arrived during this step and presses the
+	* call button for those on a floor where nobody has pressed it yet.
+	*/
+	void GeneratePassengers();
+
+	/**
+	* @return Returns the call button of a floor for a direction.
+	*/
+	hallButton &HallButton(int floor, char direction) { return _hallButtons[floor * 2 + (direction == UP ? 0 : 1)]; }
+
+	/**
+	* @details Presses a call button, adding the hall call to _batch, and sets
+	* a timer to press it again after hallCallRetryPeriod, as the dispatcher
+	* drops calls when no elevator can take them. The timer is cancelled once
+	* nobody is waiting for the button.
+	* @param[in] button The button to press.
+	*/
+	void PressHallCall(hallButton &button);
+
+	/**
+	* @details Retry timer callback that presses the button again.
+	* @param[in] arg The hallButton.
+	*/
+	static void RetryHallCall(void *arg);
+
+	/**
+	* @return Returns a random number from 0 up to but not including 1.
+	*/
+	static double Uniform();
+
+};
+
+#endif
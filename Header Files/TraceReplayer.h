@@ -0,0 +1,164 @@
+#ifndef __TRACEREPLAYER__
+#define __TRACEREPLAYER__
+
+#include "rt.h"
+#include "data.h"
+#include "InputReader.h"
+
+#include <string>
+
+const unsigned long long traceViewSize = 16 * 1024 * 1024; // Bytes of the trace file mapped at once
+const int replayBatchSize = 64; // Most commands sent to the dispatcher in one batch
+
+/**
+* @details The TraceReplayer active class plays a trace file written by the
+* TraceWriter into the dispatcher pipes, the same way the IO class sends what
+* the user types, so a load test gives the same calls every time it is run.
+*	The file is memory mapped a view at a time rather than read, so traces of
+* any length are streamed without copying them. Binary and text traces are
+* told apart by the traceMagic at the start of the file.
+*	Commands are sent at the times they were recorded, or as fast as the
+* dispatcher takes them. Commands that are due together are sent as one batch.
+*/
+class TraceReplayer : public ActiveClass {
+
+public:
+
+	/**
+	* Constructor that initializes the member variables.
+	* @param[in] numOfElevators The number of elevators, used to check commands.
+	* @param[in] fileName The trace file to replay.
+	* @param[in] asFastAsPossible Whether to ignore the recorded times.
+	* @param[in] prefix Put in front of the names of the pipes to the dispatcher.
+	*/
+	TraceReplayer(int numOfElevators, const std::string &fileName, bool asFastAsPossible, const std::string &prefix = "");
+
+	/**
+	* Destructor.
+	*/
+	~TraceReplayer();
+
+	/**
+	* @return Returns the number of commands sent to the dispatcher so far.
+	*/
+	int CommandsReplayed() const { return _commandsReplayed; }
+
+private:
+
+	/**
+	* Number of elevators.
+	*/
+	int _numOfElevators;
+
+	/**
+	* The trace file to replay.
+	*/
+	std::string _fileName;
+
+	/**
+	* Whether to ignore the recorded times.
+	*/
+	bool _asFastAsPossible;
+
+	/**
+	* The queue to send elevator call information from outside the elevator.
+	*/
+	outsideCallQueue _pipeOutside;
+
+	/**
+	* The queue to send elevator call information from inside the elevator.
+	*/
+	insideCallQueue _pipeInside;
+
+	/**
+	* The queue to send fault or termination information to the dispatcher.
+	*/
+	faultQueue _faultPipe;
+
+	/**
+	* Parses the commands of a text trace. Only its Parse() function is used.
+	*/
+	InputReader _parser;
+
+	/**
+	* The commands waiting to be sent to the dispatcher.
+	*/
+	commandBatch _batch;
+
+	/**
+	* A text line that was cut off by the end of a mapped view.
+	*/
+	std::string _partialLine;
+
+	/**
+	* GET_TIME_US() when the replay started.
+	*/
+	ULONGLONG _startTime;
+
+	/**
+	* Whether a terminate command has been replayed or RequestTerminate() was
+	* called while waiting for the next command.
+	*/
+	bool _terminated;
+
+	/**
+	* Number of commands sent to the dispatcher.
+	*/
+	int _commandsReplayed;
+
+	/**
+	* @details Maps the trace file a view at a time and replays each view.
+	* @return Returns 0 when the whole trace or a terminate command has been sent.
+	*/
+	int main(void);
+
+	/**
+	* @details Replays the binary records in a mapped view.
+	* @param[in] data The first record.
+	* @param[in] size The number of bytes of records.
+	*/
+	void ReplayBinary(const char *data, ULONGLONG size);
+
+	/**
+	* @details Replays the text lines in a mapped view. A line cut off at the end
+	* of the view is kept until the next view.
+	* @param[in] data The start of the view.
+	* @param[in] size The number of bytes in the view.
+	*/
+	void ReplayText(const char *data, ULONGLONG size);
+
+	/**
+	* @details Replays one text line, the time in milliseconds then the command.
+	* Blank lines and lines starting with '#' are skipped.
+	* @param[in] line The start of the line.
+	* @param[in] length The length of the line without its new line character.
+	*/
+	void ReplayLine(const char *line, ULONGLONG length);
+
+	/**
+	* @details Checks one binary record and adds it to the batch once it is due.
+	* @param[in] record The record to replay.
+	*/
+	void ReplayRecord(const traceRecord &record);
+
+	/**
+	* @details Waits for the time a command was recorded at, sending the
+	* commands already in the batch first. Does nothing when replaying as fast
+	* as possible.
+	* @param[in] time Microseconds since the start of the trace.
+	*/
+	void WaitUntil(ULONGLONG time);
+
+	/**
+	* @details Sends the batch to the dispatcher once it is full.
+	*/
+	void CheckBatch();
+
+	/**
+	* @details Sends the batch to the dispatcher and clears it.
+	*/
+	void PostBatch();
+
+};
+
+#endif
@@ -0,0 +1,76 @@
+#ifndef __TRACEWRITER__
+#define __TRACEWRITER__
+
+#include "rt.h"
+#include "data.h"
+#include "InputReader.h"
+
+#include <cstdio>
+#include <string>
+
+/**
+* @details The TraceWriter class records timestamped commands to a trace file
+* that the TraceReplayer can play back.
+*	The binary format is a traceHeader followed by one traceRecord per command.
+*	The text format has one command per line, the time in milliseconds followed
+* by the command as it is typed, ie. "1500 u5", "1720 2:4" or "9000 -3".
+*/
+class TraceWriter {
+
+public:
+
+	/**
+	* Constructor that creates the trace file and writes the binary header.
+	* @param[in] fileName The trace file. A name ending in ".txt" is written in
+	* the text format, anything else in the binary format.
+	*/
+	TraceWriter(const std::string &fileName);
+
+	/**
+	* Destructor that flushes and closes the trace file.
+	*/
+	~TraceWriter();
+
+	/**
+	* @details Records every command in a batch with the same time.
+	* @param[in] time Microseconds since the start of the trace.
+	* @param[in] batch The commands to record.
+	*/
+	void Write(unsigned long long time, const commandBatch &batch);
+
+	/**
+	* @details Records one command.
+	* @param[in] record The command to record.
+	*/
+	void Write(const traceRecord &record);
+
+	/**
+	* @details Writes any buffered records out to the file.
+	*/
+	void Flush();
+
+	/**
+	* @return Returns the number of records written.
+	*/
+	int RecordsWritten() const { return _recordsWritten; }
+
+private:
+
+	/**
+	* The trace file, NULL if it could not be created.
+	*/
+	FILE *_file;
+
+	/**
+	* Whether the file is written in the text format.
+	*/
+	bool _text;
+
+	/**
+	* Number of records written.
+	*/
+	int _recordsWritten;
+
+};
+
+#endif
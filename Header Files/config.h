@@ -0,0 +1,75 @@
+#ifndef __CONFIG__
+#define __CONFIG__
+
+#include "rt.h"
+
+#include <string>
+
+const int noAffinity = 0; // Child processes run on any processor
+const int coreAffinity = 1; // Each child process is pinned to a processor of its own
+const int numaAffinity = 2; // Each child process is pinned to the processors of a NUMA node, in turn
+
+/**
+* @details The options the elevator system is started with. The defaults run
+* the interactive simulation reading commands from the standard input.
+*	- inputFile: file to read the user commands from, the standard input if empty
+*	- recordFile: trace file every user command is recorded to, nothing is
+*	  recorded if empty. A name ending in ".txt" writes the text format.
+*	- replayFile: binary or text trace file replayed into the dispatcher,
+*	  nothing is replayed if empty
+*	- replayAsFastAsPossible: replay the trace without waiting for the recorded
+*	  times, only for the pipes to the dispatcher to have room
+*	- deterministic: run every active class on the deterministic scheduler in
+*	  rt, so the same replayed trace and seed always give the same event log
+*	- seed: seed for RANDOM() and for the deterministic scheduler
+*	- eventLogFile: file the dispatcher and elevator events are logged to,
+*	  nothing is logged if empty
+*	- objectPrefix: put in front of the name of every datapool, pipe, mutex
+*	  and semaphore, so several elevator systems can run on one machine
+*	- adaptiveWait: mutexes and semaphores spin for a while before blocking
+*	  and count how often they are found taken, see SET_ADAPTIVE_WAIT() in rt
+*	- contentionReportFile: profile every mutex, semaphore, event and condition
+*	  and write the report to this file at the end, nothing is profiled if empty
+*	- processExecutable: run the dispatcher and the elevators as separate
+*	  processes of this program instead of threads, see ProcessGroup
+*	- elevatorsPerProcess: the number of elevators in each elevator process
+*	- processAffinity: noAffinity, coreAffinity or numaAffinity for the processes
+*	- dispatcherPriority, elevatorPriority, displayPriority: the THREAD_PRIORITY_
+*	  of the dispatcher thread, the elevator threads and the IO input and
+*	  display threads
+*	- pinThreads: keep the IO threads on the first processor, the dispatcher
+*	  alone on the second and the elevators together on the rest, ignored
+*	  with fewer than three processors
+*	- overflowPolicy: what the dispatcher does with a call for an elevator
+*	  whose pipe stays full, PIPE_BLOCK, PIPE_REJECT, PIPE_DROP_OLDEST or
+*	  PIPE_COALESCE, see CPipe::Write() in rt
+*/
+struct simulationConfig {
+
+	std::string inputFile;
+	std::string recordFile;
+	std::string replayFile;
+	bool replayAsFastAsPossible;
+	bool deterministic;
+	unsigned int seed;
+	std::string eventLogFile;
+	std::string objectPrefix;
+	bool adaptiveWait;
+	std::string contentionReportFile;
+	std::string processExecutable;
+	int elevatorsPerProcess;
+	int processAffinity;
+	int dispatcherPriority;
+	int elevatorPriority;
+	int displayPriority;
+	bool pinThreads;
+	int overflowPolicy;
+
+	simulationConfig() : replayAsFastAsPossible(false), deterministic(false), seed(1), adaptiveWait(false),
+		elevatorsPerProcess(1), processAffinity(noAffinity), dispatcherPriority(THREAD_PRIORITY_NORMAL),
+		elevatorPriority(THREAD_PRIORITY_NORMAL), displayPriority(THREAD_PRIORITY_NORMAL), pinThreads(false),
+		overflowPolicy(PIPE_COALESCE) {}
+
+};
+
+#endif
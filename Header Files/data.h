@@ -1,97 +1,273 @@
-#ifndef __DATA__
-#define __DATA__
-
-const char OPEN = 'o';
-const char CLOSED = 'c';
-const char UP = 'u';
-const char DOWN = 'd';
-const char NODIR = 'n';
-const char MOVING = 'm';
-const char IDLE = 'i';
-const char PICKUP = 'p';
-const char DROPOFF = 'd';
-const char FAULT = 'f';
-const char NOFAULT = 'n';
-const char TERMINATED = 't';
-
-/**
-* @details The struct data that is stored in the datapool and is used to store
-* the various status' of the elevators:
-*	- direction: the direction (up, down, nodir) of the elevator
-*	- doorStatus: the door status of the elevator (closed, open)
-*	- movingStatus: the status describing whether the elevator is moving
-*	- serviceStatus: whether the elevator is faulted or not
-*	- currentFloorNumber: the current floor number the elevator is on
-*	- desiredFloorNumber: the floor number that the elevator needs to go to
-*/
-struct dataPoolData {
-
-	char direction; // 'u' up, 'd' down, 'n' no direction
-	char doorStatus; // 'c' closed, 'o' open
-	char movingStatus; // 'm' moving, 'i' idle
-	char serviceStatus; // 'f' fault, 'n' no fault
-	int currentFloorNumber;
-	int desiredFloorNumber;
-
-};
-
-/**
-* @details The struct containing the elevator call made by someone outside the
-* elevators. 
-*	- direction: the direction the person wants to go
-*	- currentFloorNumber: the current floor number of the person making the call
-*/
-struct outsideElevatorData {
-
-	char direction;
-	int currentFloorNumber;
-	
-};
-
-/**
-* @details The struct containing the elevator call made by someone inside the
-* elevators.
-*	- currentElevatorNumber: the current elevator number the person is in
-*	- desiredFloorNumber: the floor the person wishes to go to
-*/
-struct insideElevatorData{
-
-	int currentElevatorNumber;
-	int desiredFloorNumber;
-
-};
-
-/**
-* @details The struct data that goes in the priority queue used by the elevators.
-*	- destination: the destination of the call
-*	- destinationStatus: whether the destination is a PICKUP, DROPOFF or TERMINATE
-*	- direction: the direction of the call
-* The function also overloads the operator <. It is a max priority queue if the
-* elevator is going down. In otherwords, it wants to go to the larger floor numbers
-* first. It is a min priority queue if the elevator is going up. In otherwords,
-* it wants to go to the lower floor numbers first. Ie. If there is a queue to go
-* to floors 3, 5 and 7 and the elevator is going up, it should go to floor 3 first
-* then floor 5 and finally floor 7.
-*/
-struct queueData {
-
-	int destination;
-	char destinationStatus; // 'p' pickup, 'd' dropoff, 't' terminate
-	char direction; // 'u' up, 'd' down
-
-	bool operator<(const queueData &o) const
-	{
-		if (direction == UP) {
-
-			return destination > o.destination;
-
-		}else if(direction == DOWN) {
-
-			return destination < o.destination;
-
-		}
-	}
-
-};
-
+#ifndef __DATA__
+#define __DATA__
+
+#include <intrin.h>
+
+const char OPEN = 'o';
+const char CLOSED = 'c';
+const char UP = 'u';
+const char DOWN = 'd';
+const char NODIR = 'n';
+const char MOVING = 'm';
+const char IDLE = 'i';
+const char PICKUP = 'p';
+const char DROPOFF = 'd';
+const char FAULT = 'f';
+const char NOFAULT = 'n';
+const char TERMINATED = 't';
+const char ADDED = 'a';
+const char REMOVED = 'r';
+
+const int numOfFloors = 10; // Number of floors in the building
+const int pollPeriod = 50; // Milliseconds the dispatcher and elevators sleep between looks at their pipes
+const int messageBatchSize = 32; // Most messages of one kind taken from a pipe at each look
+const int dispatcherQueueSize = 128; // Messages each queue into the dispatcher holds
+const int dispatchTimeout = 10; // Milliseconds the dispatcher waits for room in an elevator's pipe before its overflow policy applies
+const int maxElevators = 256; // Most elevators the fleet datapool has room for
+
+/**
+* @details The struct data that is stored in the datapool and is used to store
+* the various status' of the elevators:
+*	- direction: the direction (up, down, nodir) of the elevator
+*	- doorStatus: the door status of the elevator (closed, open)
+*	- movingStatus: the status describing whether the elevator is moving
+*	- serviceStatus: whether the elevator is faulted or not
+*	- currentFloorNumber: the current floor number the elevator is on
+*	- desiredFloorNumber: the floor number that the elevator needs to go to
+*/
+struct dataPoolData {
+
+	char direction; // 'u' up, 'd' down, 'n' no direction
+	char doorStatus; // 'c' closed, 'o' open
+	char movingStatus; // 'm' moving, 'i' idle
+	char serviceStatus; // 'f' fault, 'n' no fault
+	int currentFloorNumber;
+	int desiredFloorNumber;
+
+};
+
+/**
+* @details The status of every elevator as collected at one tick of IO or a
+* Simulation, see FleetSnapshot.
+*	- sequence: odd while the snapshot is being written, and moved on each time it is
+*	- tick: counts the snapshots published
+*	- numOfElevators: the number of elevators in the snapshot
+*	- elevators: the status of each elevator, indexed by elevator number
+*/
+struct fleetSnapshot {
+
+	volatile long sequence;
+	unsigned long long tick;
+	int numOfElevators;
+	dataPoolData elevators[maxElevators];
+
+};
+
+/**
+* @details The datapool shared by the whole fleet, created in one step before
+* any elevator is, in place of a datapool for each elevator.
+*	- numOfElevators: the number of elevators in the fleet
+*	- elevators: the status of each elevator, indexed by elevator number, as
+*	  the elevators write it
+*	- latestSnapshot: the snapshot readers should use, 0 or 1
+*	- snapshots: the two snapshot buffers, one being read while the other is written
+*/
+struct fleetDataPoolData {
+
+	int numOfElevators;
+	dataPoolData elevators[maxElevators];
+	volatile long latestSnapshot;
+	fleetSnapshot snapshots[2];
+
+};
+
+/**
+* @details The number of threads that meet at the fleet's readiness
+* rendezvous before any of them starts work: every elevator, the dispatcher
+* and the thread that created the fleet.
+*/
+inline int fleetReadyThreads(int numOfElevators) { return numOfElevators + 2; }
+
+/**
+* @details The struct containing the elevator call made by someone outside the
+* elevators. 
+*	- direction: the direction the person wants to go
+*	- currentFloorNumber: the current floor number of the person making the call
+*/
+struct outsideElevatorData {
+
+	char direction;
+	int currentFloorNumber;
+	
+};
+
+/**
+* @details The struct containing the elevator call made by someone inside the
+* elevators.
+*	- currentElevatorNumber: the current elevator number the person is in
+*	- desiredFloorNumber: the floor the person wishes to go to
+*/
+struct insideElevatorData{
+
+	int currentElevatorNumber;
+	int desiredFloorNumber;
+
+};
+
+/**
+* @details The struct containing a fault or termination command for the elevators.
+*	- faultType: FAULT to fault the elevator, NOFAULT to clear the fault or
+*	  TERMINATED to send every elevator to floor zero and stop the simulation.
+*	  ADDED and REMOVED put an elevator into service or take it out, and are
+*	  handled by IO rather than sent to the dispatcher
+*	- elevatorNumber: the elevator the fault is for, ignored for TERMINATED
+*	  and ADDED
+*/
+struct faultElevatorData {
+
+	char faultType;
+	int elevatorNumber;
+
+};
+
+const char HALLCALL = 'h'; // Trace record of a call made outside the elevators
+const char CARCALL = 'c'; // Trace record of a call made inside an elevator
+const char FAULTCALL = 'f'; // Trace record of a fault or termination command
+
+const char traceMagic[4] = { 'E', 'T', 'R', 'C' }; // First bytes of a binary trace file
+const int traceVersion = 1; // Version of the binary trace record layout
+
+/**
+* @details The header at the start of a binary trace file.
+*	- magic: traceMagic, which tells a binary trace apart from a text one
+*	- version: the traceVersion the file was written with
+*	- reserved: zero, it makes the header the same size as a record so that
+*	  no record crosses the boundary between two mapped views of the file
+*/
+struct traceHeader {
+
+	char magic[4];
+	int version;
+	unsigned long long reserved;
+
+};
+
+/**
+* @details One timestamped command in a binary trace file. The records are
+* 16 bytes each and are stored in time order straight after the header.
+*	- time: microseconds since the start of the trace
+*	- type: HALLCALL, CARCALL or FAULTCALL
+*	- command: the direction of a hall call or the faultType of a fault
+*	- floor: the floor of a hall call or the desired floor of a car call
+*	- elevatorNumber: the elevator of a car call or a fault
+*/
+struct traceRecord {
+
+	unsigned long long time;
+	char type; // 'h' hall call, 'c' car call, 'f' fault
+	char command; // 'u' up, 'd' down, 'f' fault, 'n' no fault, 't' terminate
+	short floor;
+	int elevatorNumber;
+
+};
+
+/**
+* @details The floors an elevator has been asked to stop at, one bit per
+* floor for each kind of stop, so a floor is only ever in the set once and
+* the set is emptied in one go:
+*	- pickups: floors with a hall call, the door stays open for a passenger
+*	- dropoffs: floors a passenger in the elevator wants to go to
+*	- terminate: floor zero after 'ee'
+* Next() finds the next stop the way the elevator travels, the nearest one
+* ahead of it and only then the nearest one behind it, with a bit scan. The
+* masks and scans are 32 bits so they build for every Windows target.
+*/
+static_assert(numOfFloors <= 32, "a destinationSet has one bit per floor in an unsigned long");
+
+struct destinationSet {
+
+	unsigned long pickups;
+	unsigned long dropoffs;
+	unsigned long terminate;
+
+	destinationSet() : pickups(0), dropoffs(0), terminate(0) {}
+
+	bool Empty() const { return (pickups | dropoffs | terminate) == 0; }
+	void Clear() { pickups = dropoffs = terminate = 0; }
+
+	void Add(int floor, char status) {
+
+		unsigned long bit = 1UL << floor;
+
+		if (status == PICKUP) {
+
+			pickups |= bit;
+
+		}
+		else if (status == DROPOFF) {
+
+			dropoffs |= bit;
+
+		}
+		else {
+
+			terminate |= bit;
+
+		}
+
+	}
+
+	void Remove(int floor) {
+
+		unsigned long bit = ~(1UL << floor);
+		pickups &= bit;
+		dropoffs &= bit;
+		terminate &= bit;
+
+	}
+
+	/**
+	* @return Returns TERMINATED, PICKUP or DROPOFF for a floor in the set. A
+	* pickup wins over a dropoff as the door stays open for both.
+	*/
+	char Status(int floor) const {
+
+		unsigned long bit = 1UL << floor;
+		return (terminate & bit) ? TERMINATED : (pickups & bit) ? PICKUP : DROPOFF;
+
+	}
+
+	/**
+	* @return Returns the next floor to stop at for an elevator on a floor
+	* going in a direction, or -1 if the set is empty. With no direction it
+	* is the nearest floor either way.
+	*/
+	int Next(int floor, char direction) const {
+
+		unsigned long all = pickups | dropoffs | terminate;
+		unsigned long atOrAbove = all & (~0UL << floor);
+		unsigned long atOrBelow = all & ((floor >= 31) ? ~0UL : (2UL << floor) - 1);
+		unsigned long above;
+		unsigned long below;
+		bool up = _BitScanForward(&above, atOrAbove) != 0;
+		bool down = _BitScanReverse(&below, atOrBelow) != 0;
+
+		if (!up && !down) {
+
+			return -1;
+
+		}
+
+		if (direction == UP || (direction != DOWN && up && (!down || above - floor <= floor - below))) {
+
+			return up ? (int)above : (int)below;
+
+		}
+
+		return down ? (int)below : (int)above;
+
+	}
+
+};
+
 #endif
\ No newline at end of file
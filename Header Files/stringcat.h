@@ -1,15 +1,29 @@
-#ifndef __STRINGCAT__
-#define __STRINGCAT__
-
-#include <iostream>
-#include <string>
-#include <sstream>
-
-inline std::string itos(int i) // convert int to string
-{
-	std::stringstream s;
-	s << i;
-	return s.str();
-}
-
+#ifndef __STRINGCAT__
+#define __STRINGCAT__
+
+#include <iostream>
+#include <string>
+
+inline std::string itos(int i) // convert int to string, short enough that std::string keeps it without the heap
+{
+	char s[12];
+	char *p = s + sizeof(s);
+	unsigned int u = (i < 0) ? 0u - (unsigned int)i : (unsigned int)i;
+
+	do {
+
+		*--p = (char)('0' + u % 10);
+		u /= 10;
+
+	} while (u != 0);
+
+	if (i < 0) {
+
+		*--p = '-';
+
+	}
+
+	return std::string(p, s + sizeof(s));
+}
+
 #endif
\ No newline at end of file
@@ -0,0 +1,252 @@
+#include "BatchRunner.h"
+#include "stringcat.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+
+using namespace std;
+
+BatchRunner::BatchRunner(const simulationParameters &parameters, int numOfSimulations, unsigned int seed, int numOfWorkers) :
+	_parameters(parameters),
+	_numOfSimulations(numOfSimulations),
+	_seed(seed),
+	_numOfWorkers(numOfWorkers),
+	_runTime(0) {
+
+	if (_numOfWorkers <= 0) {
+
+		SYSTEM_INFO systemInfo;
+		GetSystemInfo(&systemInfo);
+		_numOfWorkers = (int)systemInfo.dwNumberOfProcessors;
+
+	}
+
+	for (int i = 0; i < _numOfWorkers; i++) {
+
+		_queues.push_back(new workQueue);
+
+	}
+
+}
+
+BatchRunner::~BatchRunner() {
+
+	for (int i = 0; i < _numOfWorkers; i++) {
+
+		delete _queues[i];
+
+	}
+
+}
+
+bool BatchRunner::Run() {
+
+	ULONGLONG startTime = GET_TIME_US();
+
+	// Every simulation runs in this process, so their objects do not need
+	// to be kernel objects, the prefix is enough to keep them apart
+	int objectScope = GET_OBJECT_SCOPE();
+	SET_OBJECT_SCOPE(PROCESS_OBJECTS);
+
+	_results.assign(_numOfSimulations, waitTimeHistogram());
+	_allocations.assign(_numOfSimulations, 0);
+	_waitTimes = waitTimeHistogram();
+
+	for (int simulation = 0; simulation < _numOfSimulations; simulation++) {
+
+		_queues[simulation % _numOfWorkers]->simulations.push_back(simulation);
+
+	}
+
+	vector<ClassThread<BatchRunner>*> workers;
+
+	for (int i = 0; i < _numOfWorkers; i++) {
+
+		workers.push_back(new ClassThread<BatchRunner>(this, &BatchRunner::Worker, ACTIVE, (void*)(INT_PTR)i));
+
+	}
+
+	for (int i = 0; i < _numOfWorkers; i++) {
+
+		workers[i]->WaitForThread();
+		delete workers[i];
+
+	}
+
+	// Added up in simulation order so the totals are the same for any number of workers
+	for (int simulation = 0; simulation < _numOfSimulations; simulation++) {
+
+		_waitTimes.Merge(_results[simulation]);
+
+	}
+
+	SET_OBJECT_SCOPE(objectScope);
+
+	_runTime = GET_TIME_US() - startTime;
+
+	// Reported by PrintReport(), as a batch may have nobody to press a key
+	return AllocationFree();
+
+}
+
+bool BatchRunner::RunRushHour(int argc, char *argv[], int &exitCode) {
+
+	if (argc < 2 || argc > 4 || strcmp(argv[1], "-rushhour") != 0) {
+
+		return false;
+
+	}
+
+	simulationParameters rushHour;
+	rushHour.arrivalRate = 2 * rushHourArrivalRate;
+
+	int days = (argc > 2) ? atoi(argv[2]) : rushHourDays;
+	unsigned int seed = (argc > 3) ? (unsigned int)atoi(argv[3]) : 1;
+
+	BatchRunner batch(rushHour, (days > 0) ? days : rushHourDays, seed);
+	exitCode = batch.Run() ? 0 : 1;
+	batch.PrintReport(cout);
+
+	return true;
+
+}
+
+int BatchRunner::Worker(void *ThreadArgs) {
+
+	int worker = (int)(INT_PTR)ThreadArgs;
+	int simulation;
+
+	while (NextSimulation(worker, simulation)) {
+
+		// Everything the simulation resumes runs on this scheduler and nothing else
+		CDeterministicScheduler scheduler(_seed + simulation);
+		Simulation *day = new Simulation(_parameters, "Sim" + itos(simulation) + ".");
+
+		day->Resume();
+		day->WaitForThread();
+
+		_results[simulation] = day->WaitTimes();
+		_allocations[simulation] = day->HotPathAllocations();
+		delete day;
+
+	}
+
+	return 0;
+
+}
+
+bool BatchRunner::NextSimulation(int worker, int &simulation) {
+
+	workQueue *own = _queues[worker];
+
+	own->lock.Enter();
+	bool found = !own->simulations.empty();
+
+	if (found) {
+
+		simulation = own->simulations.back();
+		own->simulations.pop_back();
+
+	}
+
+	own->lock.Leave();
+
+	// Steal the oldest simulation of the next worker that has any left
+	for (int i = 1; i < _numOfWorkers && !found; i++) {
+
+		workQueue *victim = _queues[(worker + i) % _numOfWorkers];
+
+		victim->lock.Enter();
+		found = !victim->simulations.empty();
+
+		if (found) {
+
+			simulation = victim->simulations.front();
+			victim->simulations.pop_front();
+
+		}
+
+		victim->lock.Leave();
+
+	}
+
+	return found;
+
+}
+
+ULONGLONG BatchRunner::TotalAllocations() const {
+
+	ULONGLONG allocations = 0;
+
+	for (int simulation = 0; simulation < _numOfSimulations && allocations != ALLOCATIONS_NOT_COUNTED; simulation++) {
+
+		allocations = (_allocations[simulation] == ALLOCATIONS_NOT_COUNTED) ? ALLOCATIONS_NOT_COUNTED : allocations + _allocations[simulation];
+
+	}
+
+	return allocations;
+
+}
+
+bool BatchRunner::AllocationFree() const {
+
+	ULONGLONG allocations = TotalAllocations();
+
+	return _parameters.arrivalRate < rushHourArrivalRate
+		|| allocations == ALLOCATIONS_NOT_COUNTED || allocations == 0;
+
+}
+
+void BatchRunner::PrintReport(std::ostream &out) const {
+
+	double minMean = 0;
+	double maxMean = 0;
+	ULONGLONG allocations = TotalAllocations();
+
+	for (int simulation = 0; simulation < _numOfSimulations; simulation++) {
+
+		double mean = _results[simulation].Mean();
+
+		if (simulation == 0 || mean < minMean) {
+
+			minMean = mean;
+
+		}
+
+		if (simulation == 0 || mean > maxMean) {
+
+			maxMean = mean;
+
+		}
+
+	}
+
+	out << "Simulated days: " << _numOfSimulations << " on " << _numOfWorkers << " workers in "
+		<< _runTime / 1000000.0 << " s" << endl;
+	out << "Passengers: " << _waitTimes.passengers << " served, " << _waitTimes.unserved << " still waiting" << endl;
+	out << "Wait time (s): mean " << _waitTimes.Mean()
+		<< ", 50% " << _waitTimes.Percentile(0.5)
+		<< ", 90% " << _waitTimes.Percentile(0.9)
+		<< ", 99% " << _waitTimes.Percentile(0.99)
+		<< ", max " << _waitTimes.maxWait << endl;
+	out << "Daily mean wait time (s): " << minMean << " to " << maxMean << endl;
+
+	if (allocations == ALLOCATIONS_NOT_COUNTED) {
+
+		out << "Hot path allocations: not counted, build rt.cpp with RT_COUNT_ALLOCATIONS" << endl;
+
+	}
+	else if (!AllocationFree()) {
+
+		out << "Hot path allocations: " << allocations << ", FAILED, a day with "
+			<< rushHourArrivalRate << " or more passengers a minute must make none" << endl;
+
+	}
+	else {
+
+		out << "Hot path allocations: " << allocations << endl;
+
+	}
+
+}
@@ -1,296 +1,738 @@
-#include "Dispatcher.h"
-#include "stringcat.h"
-
-Dispatcher::Dispatcher(int numOfElevators) :
-	_numOfElevators(numOfElevators),
-	_DispatcherElevatorMutex("_DispatcherElevatorMutex"),
-	_pipeOutside("PipeOutside", 1024),
-	_pipeInside("PipeInside", 1024),
-	_faultPipe("FaultPipe", 1024) {
-
-	_elevatorCall.currentFloorNumber = 0;
-	_elevatorCall.direction = NODIR;
-	_elevatorDestination.currentElevatorNumber = 0;
-	_elevatorDestination.desiredFloorNumber = 0;
-
-}
-
-Dispatcher::~Dispatcher() {
-
-	for (int i = 0; i < _numOfElevators; i++) {
-
-		delete _elevatorPipesOutside[i];
-		delete _elevatorPipesInside[i];
-		delete _elevatorDataPools[i];
-		delete _elevatorDataPoolPtrs[i];
-		delete _elevatorFaultPipe[i];
-
-	}
-
-}
-
-int Dispatcher::main(void) {
-
-	CreateElevatorDataPools();
-
-	CreateElevatorPipes();
-
-	PollForIOData();
-
-	return 0;
-
-}
-
-void Dispatcher::CreateElevatorDataPools() {
-
-	for (int i = 0; i < _numOfElevators; i++) {
-
-		_elevatorDataPools.push_back(new CDataPool("Elevator" + itos(i) + "Datapool", sizeof(struct dataPoolData)));
-		_elevatorDataPoolPtrs.push_back((dataPoolData*)(_elevatorDataPools[i]->LinkDataPool()));
-
-	}
-
-}
-
-void Dispatcher::CreateElevatorPipes() {
-
-	for (int i = 0; i < _numOfElevators; i++) {
-
-		_elevatorPipesOutside.push_back(new CPipe("PipeOutside" + itos(i), 1024));
-		_elevatorPipesInside.push_back(new CPipe("PipeInside" + itos(i), 1024));
-		_elevatorFaultPipe.push_back(new CPipe("FaultPipe" + itos(i), 1024));
-
-	}
-
-}
-
-void Dispatcher::PollForIOData() {
-
-	while (1) {
-		
-		SLEEP(50);
-
-		if (_pipeOutside.TestForData() >= sizeof(outsideElevatorData)) {
-
-
-			_pipeOutside.Read(&_elevatorCall, sizeof(outsideElevatorData));
-			CallForClosestElevator();
-
-		}
-		if (_pipeInside.TestForData() >= sizeof(insideElevatorData)) {
-
-			_pipeInside.Read(&_elevatorDestination, sizeof(insideElevatorData));
-			
-			if (_elevatorDataPoolPtrs[_elevatorDestination.currentElevatorNumber]->doorStatus == OPEN) {
-				
-				SendElevatorToDestination();
-
-			}
-
-
-		}
-		if (_faultPipe.TestForData() >= sizeof(_faultInput)) {
-
-			_faultPipe.Read(&_faultInput, sizeof(_faultInput));
-			
-			if (_faultInput[0] == 'e' && _faultInput[1] == 'e') {
-
-				TerminateElevators();
-
-			}
-			else {
-
-				SendFaultToElevator();
-
-			}
-
-		}
-
-	}
-
-}
-
-void Dispatcher::CallForClosestElevator() {
-
-	int closestElevator = -1;
-
-	// Instead of having x number of producer consumer semaphores, we use
-	// one mutex for all the elevators and stops the elevators briefly to figure 
-	// out which elevator is closest by accessing all their data pools
-	_DispatcherElevatorMutex.Wait();
-
-	SLEEP(50);
-	closestElevator = FindClosestElevator();
-
-	// Skip if no elevator is available at all
-	if (closestElevator == -1) {
-
-		return;
-
-	}
-
-	// If elevator found is in the wrong direction then skip it
-	if (_elevatorDataPoolPtrs[closestElevator]->direction != NODIR 
-		&& _elevatorDataPoolPtrs[closestElevator]->direction != _elevatorCall.direction) {
-
-		return;
-
-	}
-
-	_DispatcherElevatorMutex.Signal();
-
-	_elevatorPipesOutside[closestElevator]->Write(&_elevatorCall, sizeof(outsideElevatorData));
-
-}
-
-int Dispatcher::FindClosestElevator() {
-
-	// Initialize variables
-	int closestElevator = -1;
-	int closestDistance = 1000;
-	char userDirection = _elevatorCall.direction;
-	int newDistance;
-	char newDirection;
-	char doorStatus;
-	char serviceStatus;
-
-	int destination = _elevatorCall.currentFloorNumber;
-
-	// Try to find the closest elevator that is free
-	for (int newElevator = 0; newElevator < _numOfElevators; newElevator++) {
-
-		newDistance = abs(_elevatorDataPoolPtrs[newElevator]->currentFloorNumber - _elevatorCall.currentFloorNumber);
-		newDirection = _elevatorDataPoolPtrs[newElevator]->direction;
-		doorStatus = _elevatorDataPoolPtrs[newElevator]->doorStatus;
-		serviceStatus = _elevatorDataPoolPtrs[newElevator]->serviceStatus;
-
-		// If the elevator[i] is going up and has gone past the floor where the person
-		// requests for the elevator, it ignores the request.If the elevator[i] is going
-		// down and has gone past the floor where the person request for the elevator,
-		// it ignores the request and does nothing.
-		if ((_elevatorDataPoolPtrs[newElevator]->currentFloorNumber > destination
-			&& newDirection == UP)
-			||
-			(_elevatorDataPoolPtrs[newElevator]->currentFloorNumber < destination
-			&& newDirection == DOWN)) {
-
-			// do nothing
-
-		}
-		// Else, it checks if the elevator[i] distance to the floor where the person
-		// requested for the elevator is greater than the closestDistance calculated
-		// from looping through the elevators.It also checks if the call direction is
-		// the same as the direction of the elevator.It also checks if the door is not
-		// open and is not faulted.Essentially, in this case, we find the closest elevator
-		// that is moving and can intercept the floor request.If this is true, we set
-		// the closestElevator to this new elevator[i] and set the closestDistance to
-		// the new distance from the elevator[i].
-		else if ((newDistance < closestDistance) && ((newDirection == userDirection) || (newDirection == NODIR))
-			&& (doorStatus != OPEN) && (serviceStatus == NOFAULT)) {
-
-			// Check to see if the call is before the current desired destination of the elevator
-			if (_elevatorDataPoolPtrs[newElevator]->movingStatus == MOVING) {
-
-				if (newDistance <= abs(_elevatorDataPoolPtrs[newElevator]->desiredFloorNumber - _elevatorDataPoolPtrs[newElevator]->currentFloorNumber)){
-
-					closestElevator = newElevator;
-					closestDistance = newDistance;
-
-				}
-
-			}
-			else {
-
-				closestElevator = newElevator;
-				closestDistance = newDistance;
-
-			}
-
-		}		
-
-	}
-
-	// If we cannot find an elevator, then we reloop through the elevators and
-	// take the closest one that is busy, ie.any elevator that is stopped and
-	// waiting for the user to input a call inside the elevator.
-	if (closestElevator == -1) {
-
-		for (int newElevator = 0; newElevator < _numOfElevators; newElevator++) {
-
-			newDistance = abs(_elevatorDataPoolPtrs[newElevator]->currentFloorNumber - _elevatorCall.currentFloorNumber);
-			newDirection = _elevatorDataPoolPtrs[newElevator]->direction;
-			serviceStatus = _elevatorDataPoolPtrs[newElevator]->serviceStatus;
-
-			// If the elevator[i] is going up and has gone past the floor where the person
-			// requests for the elevator, it ignores the request.If the elevator[i] is going
-			// down and has gone past the floor where the person request for the elevator,
-			// it ignores the request and does nothing.
-			if ((_elevatorDataPoolPtrs[newElevator]->currentFloorNumber > destination
-				&& newDirection == UP)
-				||
-				(_elevatorDataPoolPtrs[newElevator]->currentFloorNumber < destination
-				&& newDirection == DOWN)) {
-
-			}
-			// Find the elevator with the closest distance and is going in the same direction
-			else if ((newDistance <= closestDistance) && ((newDirection == userDirection) || (newDirection == NODIR))
-				&& (serviceStatus == NOFAULT)) {
-
-				closestElevator = newElevator;
-				closestDistance = newDistance;
-
-			}			
-
-		}
-
-	}
-
-	return closestElevator;
-
-}
-
-void Dispatcher::SendElevatorToDestination() {
-
-	int desiredFloor = _elevatorDestination.desiredFloorNumber;
-	int elevatorNumber = _elevatorDestination.currentElevatorNumber;
-	int currentFloor = _elevatorDataPoolPtrs[elevatorNumber]->currentFloorNumber;
-	char direction = _elevatorDataPoolPtrs[elevatorNumber]->direction;
-	char fault = _elevatorDataPoolPtrs[elevatorNumber]->serviceStatus;
-
-	// If the user presses up and his direction is up, go up
-	// If the user presses down and his direction is down, go down
-	// Otherwise, the user initially called the elevator to go up but now wants to
-	// go down which is bad
-	if (((desiredFloor >= currentFloor) && (direction == UP)) ||
-		((desiredFloor <= currentFloor) && (direction == DOWN))
-		&&
-		(fault != FAULT)) {
-
-		_elevatorPipesInside[elevatorNumber]->Write(&_elevatorDestination, sizeof(insideElevatorData));
-
-	}
-
-}
-
-void Dispatcher::TerminateElevators() {
-
-	for (int i = 0; i < _numOfElevators; i++) {
-
-		_elevatorFaultPipe[i]->Write(&_faultInput, sizeof(_faultInput));
-
-	}
-
-}
-
-void Dispatcher::SendFaultToElevator() {
-
-	char fault = _elevatorDataPoolPtrs[_faultInput[1] - 0x30]->serviceStatus;
-
-	// Should not send if input is + and there is no fault currently
-	if (!(_faultInput[0] == '+' && fault == NOFAULT)) {
-
-		_elevatorFaultPipe[_faultInput[1] - 0x30]->Write(&_faultInput, sizeof(_faultInput));
-
-	}
-
-}
+#include "Dispatcher.h"
+#include "stringcat.h"
+
+#include <cstring>
+
+Dispatcher::Dispatcher(int numOfElevators, const std::string &prefix, int overflowPolicy) :
+	_numOfElevators(numOfElevators),
+	_fleet(NULL),
+	_quiescentCount(0),
+	_prefix(prefix),
+	_allocations(ALLOCATIONS_NOT_COUNTED),
+	_overflowPolicy(overflowPolicy),
+	_fleetDataPool(prefix + "FleetDatapool", sizeof(fleetDataPoolData)),
+	_snapshot((fleetDataPoolData*)_fleetDataPool.LinkDataPool()),
+	_liveStatus(((fleetDataPoolData*)_fleetDataPool.LinkDataPool())->elevators),
+	_costTick(0),
+	_fleetReady(prefix + "FleetReady", fleetReadyThreads(numOfElevators)),
+	_fleetWriterMutex(prefix + "FleetWriterMutex"),
+	_pipeOutside(prefix + "PipeOutside", dispatcherQueueSize),
+	_pipeInside(prefix + "PipeInside", dispatcherQueueSize),
+	_faultPipe(prefix + "FaultPipe", dispatcherQueueSize) {
+
+	_elevatorCall.currentFloorNumber = 0;
+	_elevatorCall.direction = NODIR;
+	_elevatorDestination.currentElevatorNumber = 0;
+	_elevatorDestination.desiredFloorNumber = 0;
+
+	// Sized once for every elevator there could be, so adding one never
+	// moves a vector the dispatcher may be reading
+	_elevatorPipesOutside.assign(maxElevators, NULL);
+	_elevatorPipesInside.assign(maxElevators, NULL);
+	_elevatorFaultPipe.assign(maxElevators, NULL);
+	_costs.assign(maxElevators, carCost());
+	_changedCosts.reserve(maxElevators);
+
+	for (int i = 0; i < maxElevators; i++) {
+
+		_costs[i].valid = false;
+		_costs[i].sent = false;
+		_costs[i].sentTick = 0;
+		_costs[i].sentCall = false;
+
+	}
+
+}
+
+Dispatcher::~Dispatcher() {
+
+	for (int i = 0; i < maxElevators; i++) {
+
+		delete _elevatorPipesOutside[i];
+		delete _elevatorPipesInside[i];
+		delete _elevatorFaultPipe[i];
+
+	}
+
+	delete _fleet;
+
+}
+
+int Dispatcher::main(void) {
+
+	CreateElevatorPipes();
+
+	// Nothing is dispatched until the whole fleet exists
+	while (_fleetReady.Wait(pollPeriod) == WAIT_TIMEOUT) {
+
+		if (TerminateStatus()) {
+
+			return 0;
+
+		}
+
+	}
+
+	PollForIOData();
+
+	return 0;
+
+}
+
+void Dispatcher::CreateElevatorPipes() {
+
+	fleetTable *fleet = new fleetTable();
+
+	for (int i = 0; i < _numOfElevators; i++) {
+
+		LinkElevator(i);
+		fleet->cars[fleet->numOfCars++] = i;
+		fleet->inService[i] = true;
+
+	}
+
+	PublishFleet(fleet);
+
+}
+
+void Dispatcher::LinkElevator(int elevatorNumber) {
+
+	_elevatorPipesOutside[elevatorNumber] = new CPipe(_prefix + "PipeOutside" + itos(elevatorNumber), 1024);
+	_elevatorPipesInside[elevatorNumber] = new CPipe(_prefix + "PipeInside" + itos(elevatorNumber), 1024);
+	_elevatorFaultPipe[elevatorNumber] = new CPipe(_prefix + "FaultPipe" + itos(elevatorNumber), 1024);
+
+}
+
+bool Dispatcher::AddElevator(int elevatorNumber) {
+
+	_fleetWriterMutex.Wait();
+
+	const fleetTable *old = _fleet;
+	bool added = old != NULL && elevatorNumber >= 0 && elevatorNumber < maxElevators && !old->inService[elevatorNumber];
+
+	if (added) {
+
+		// Everything the dispatcher needs is made before the table that
+		// lets it see the elevator is published
+		LinkElevator(elevatorNumber);
+
+		fleetTable *fleet = new fleetTable(*old);
+		fleet->cars[fleet->numOfCars++] = elevatorNumber;
+		fleet->inService[elevatorNumber] = true;
+		PublishFleet(fleet);
+
+		LOG_EVENTF("add elevator %d", elevatorNumber);
+
+	}
+
+	_fleetWriterMutex.Signal();
+
+	return added;
+
+}
+
+bool Dispatcher::RemoveElevator(int elevatorNumber) {
+
+	_fleetWriterMutex.Wait();
+
+	const fleetTable *old = _fleet;
+	bool removed = old != NULL && elevatorNumber >= 0 && elevatorNumber < maxElevators && old->inService[elevatorNumber];
+
+	if (removed) {
+
+		fleetTable *fleet = new fleetTable();
+
+		for (int i = 0; i < old->numOfCars; i++) {
+
+			if (old->cars[i] != elevatorNumber) {
+
+				fleet->cars[fleet->numOfCars++] = old->cars[i];
+				fleet->inService[old->cars[i]] = true;
+
+			}
+
+		}
+
+		// Once this returns the dispatcher can no longer be using the pipes
+		PublishFleet(fleet);
+
+		TerminateElevator(elevatorNumber);
+
+		delete _elevatorPipesOutside[elevatorNumber];
+		delete _elevatorPipesInside[elevatorNumber];
+		delete _elevatorFaultPipe[elevatorNumber];
+		_elevatorPipesOutside[elevatorNumber] = NULL;
+		_elevatorPipesInside[elevatorNumber] = NULL;
+		_elevatorFaultPipe[elevatorNumber] = NULL;
+
+		LOG_EVENTF("remove elevator %d", elevatorNumber);
+
+	}
+
+	_fleetWriterMutex.Signal();
+
+	return removed;
+
+}
+
+void Dispatcher::PublishFleet(fleetTable *fleet) {
+
+	fleetTable *old = (fleetTable*)InterlockedExchangePointer((void* volatile*)&_fleet, fleet);
+
+	if (old == NULL) {
+
+		return;
+
+	}
+
+	// The dispatcher may still be reading the old table until it passes a
+	// quiescent point that starts after the new one was published, or until
+	// it has stopped. One it passed before the count is read here may have
+	// been followed by loading the old table.
+	LONG quiescentCount = _quiescentCount;
+
+	while (_quiescentCount == quiescentCount && WaitForThread(0) != WAIT_OBJECT_0) {
+
+		SLEEP(1);
+
+	}
+
+	delete old;
+
+}
+
+void Dispatcher::TerminateElevator(int elevatorNumber) {
+
+	faultElevatorData terminate;
+	terminate.faultType = TERMINATED;
+	terminate.elevatorNumber = elevatorNumber;
+
+	// Only the latest fault or terminate matters, so older ones make room for
+	// it, but the elevator may be holding its pipe for longer than dispatchTimeout
+	while (!_elevatorFaultPipe[elevatorNumber]->Write(&terminate, sizeof(faultElevatorData), dispatchTimeout, PIPE_DROP_OLDEST)) {
+
+		LOG_EVENTF("elevator %d busy, retry terminate", elevatorNumber);
+
+	}
+
+}
+
+void Dispatcher::PollForIOData() {
+
+	// The first poll may still allocate, for example the first log line, so
+	// counting starts at the end of it
+	ULONGLONG firstAllocations = ALLOCATIONS_NOT_COUNTED;
+
+	while (!TerminateStatus()) {
+
+		Quiescent();
+
+		ULONGLONG sleepStart = GET_TIME_US();
+
+		if (WaitForTerminate(pollPeriod)) {
+
+			break;
+
+		}
+
+		ULONGLONG slept = GET_TIME_US() - sleepStart;
+		_jitter.Add((slept > pollPeriod * 1000) ? slept - pollPeriod * 1000 : 0);
+
+		// Everything that arrived since the last look is handled now, not one
+		// message of each kind per poll period
+		outsideElevatorData elevatorCalls[messageBatchSize];
+		int count = _pipeOutside.ReadBatch(elevatorCalls, messageBatchSize);
+
+		for (int i = 0; i < count; i++) {
+
+			// Each call takes a while, so a change to the fleet need not wait for all of them
+			Quiescent();
+
+			_elevatorCall = elevatorCalls[i];
+			CallForClosestElevator();
+
+		}
+
+		insideElevatorData elevatorDestinations[messageBatchSize];
+		count = _pipeInside.ReadBatch(elevatorDestinations, messageBatchSize);
+
+		for (int i = 0; i < count; i++) {
+
+			_elevatorDestination = elevatorDestinations[i];
+			int elevatorNumber = _elevatorDestination.currentElevatorNumber;
+			dataPoolData status;
+
+			if (elevatorNumber >= 0 && elevatorNumber < maxElevators
+				&& ReadStatus(elevatorNumber, status) && status.doorStatus == OPEN) {
+				
+				SendElevatorToDestination();
+
+			}
+
+		}
+
+		faultElevatorData faults[messageBatchSize];
+		count = _faultPipe.ReadBatch(faults, messageBatchSize);
+
+		for (int i = 0; i < count && !TerminateStatus(); i++) {
+
+			_faultInput = faults[i];
+			
+			if (_faultInput.faultType == TERMINATED) {
+
+				TerminateElevators();
+				RequestTerminate(); // Nothing is dispatched after 'ee'
+
+			}
+			else {
+
+				SendFaultToElevator();
+
+			}
+
+		}
+
+		if (firstAllocations == ALLOCATIONS_NOT_COUNTED) {
+
+			firstAllocations = GET_ALLOCATION_COUNT();
+
+		}
+
+	}
+
+	if (firstAllocations != ALLOCATIONS_NOT_COUNTED) {
+
+		_allocations = GET_ALLOCATION_COUNT() - firstAllocations;
+
+	}
+
+	DrainPipes();
+	LogOverflows();
+
+}
+
+void Dispatcher::DrainPipes() {
+
+	// Nothing more is dispatched, but a writer must not be left waiting for room
+	while (_pipeOutside.TryRead(&_elevatorCall)) {
+
+	}
+
+	while (_pipeInside.TryRead(&_elevatorDestination)) {
+
+	}
+
+	while (_faultPipe.TryRead(&_faultInput)) {
+
+	}
+
+}
+
+void Dispatcher::LogOverflows() {
+
+	const fleetTable *fleet = _fleet;
+
+	for (int car = 0; car < fleet->numOfCars; car++) {
+
+		int i = fleet->cars[car];
+
+		int overflows = _elevatorPipesOutside[i]->GetOverflows() + _elevatorPipesInside[i]->GetOverflows()
+			+ _elevatorFaultPipe[i]->GetOverflows();
+
+		if (overflows > 0) {
+
+			LOG_EVENTF("overflow elevator %d %d", i, overflows);
+
+		}
+
+	}
+
+}
+
+void Dispatcher::CallForClosestElevator() {
+
+	// The elevators carry on moving while they are compared, so compare them as
+	// they were at the latest tick, and again if a newer tick overwrote it.
+	// Nothing waits for the last call to show in the elevator's status, as
+	// UpdateCosts() counts it as taken until it does.
+	long sequence;
+	const fleetSnapshot *snapshot;
+
+	do {
+
+		snapshot = _snapshot.Read(sequence);
+
+	} while (!UpdateCosts(snapshot, sequence));
+
+	// The elevators whose pipes had no room for the call
+	bool refused[maxElevators] = { false };
+	int attempt;
+
+	for (attempt = 0; attempt < dispatchAttempts; attempt++) {
+
+		int closestElevator = FindClosestElevator(refused);
+
+		// Skip if no elevator is available at all, or if the elevator found is
+		// in the wrong direction
+		if (closestElevator == -1
+			|| (_costs[closestElevator].status.direction != NODIR 
+			&& _costs[closestElevator].status.direction != _elevatorCall.direction)) {
+
+			break;
+
+		}
+
+		// An elevator that is not reading its pipe, for example while its door is
+		// open, must not hold up the calls for every other elevator
+		if (_elevatorPipesOutside[closestElevator]->Write(&_elevatorCall, sizeof(outsideElevatorData), dispatchTimeout, _overflowPolicy)) {
+
+			Sent(closestElevator, &_elevatorCall);
+			LOG_EVENTF("dispatch %c%d to elevator %d", _elevatorCall.direction, _elevatorCall.currentFloorNumber, closestElevator);
+			return;
+
+		}
+
+		LOG_EVENTF("elevator %d full, refused %c%d", closestElevator, _elevatorCall.direction, _elevatorCall.currentFloorNumber);
+		refused[closestElevator] = true;
+
+	}
+
+	if (attempt > 0) {
+
+		LOG_EVENTF("drop %c%d", _elevatorCall.direction, _elevatorCall.currentFloorNumber);
+
+	}
+
+}
+
+int Dispatcher::FindClosestElevator(const bool *refused) {
+
+	// Initialize variables
+	int closestElevator = -1;
+	int closestDistance = noDispatchCost;
+	int floor = _elevatorCall.currentFloorNumber;
+	int direction = (_elevatorCall.direction == UP) ? 0 : 1;
+
+	if (floor < 0 || floor >= numOfFloors) {
+
+		return -1;
+
+	}
+
+	// One load of the table, which stays valid until the next quiescent point
+	const fleetTable *fleet = _fleet;
+
+	// Try to find the closest elevator that is free, the first one found
+	// when several are as close
+	for (int car = 0; car < fleet->numOfCars; car++) {
+
+		int newElevator = fleet->cars[car];
+
+		// Not in a snapshot yet if it was added since
+		if (!_costs[newElevator].valid || (refused != NULL && refused[newElevator])) {
+
+			continue;
+
+		}
+
+		int newDistance = _costs[newElevator].freeCost[floor][direction];
+
+		if (newDistance < closestDistance) {
+
+			closestElevator = newElevator;
+			closestDistance = newDistance;
+
+		}
+
+	}
+
+	// If we cannot find an elevator, then we reloop through the elevators and
+	// take the closest one that is busy, the last one found when several are
+	// as close
+	if (closestElevator == -1) {
+
+		for (int car = 0; car < fleet->numOfCars; car++) {
+
+			int newElevator = fleet->cars[car];
+
+			if (!_costs[newElevator].valid || (refused != NULL && refused[newElevator])) {
+
+				continue;
+
+			}
+
+			int newDistance = _costs[newElevator].busyCost[floor][direction];
+
+			if (newDistance != noDispatchCost && newDistance <= closestDistance) {
+
+				closestElevator = newElevator;
+				closestDistance = newDistance;
+
+			}
+
+		}
+
+	}
+
+	return closestElevator;
+
+}
+
+bool Dispatcher::UpdateCosts(const fleetSnapshot *snapshot, long sequence) {
+
+	bool newTick = snapshot->tick != _costTick;
+	const fleetTable *fleet = _fleet;
+
+	_changedCosts.clear();
+
+	for (int car = 0; car < fleet->numOfCars; car++) {
+
+		int elevator = fleet->cars[car];
+		bool live = Live(elevator, snapshot->tick);
+
+		if (elevator >= snapshot->numOfElevators || (!live && !newTick)) {
+
+			continue;
+
+		}
+
+		// Copied, as an elevator's own status changes while it is looked at
+		dataPoolData status = live ? _liveStatus[elevator] : snapshot->elevators[elevator];
+		const carCost &cost = _costs[elevator];
+
+		// What the elevator does when it takes a call, done here if it has not yet
+		if (live && cost.sentCall && status.desiredFloorNumber != cost.call.currentFloorNumber) {
+
+			status.desiredFloorNumber = cost.call.currentFloorNumber;
+
+			if (status.movingStatus != MOVING && status.direction == NODIR) {
+
+				status.direction = cost.call.direction;
+
+			}
+
+		}
+
+		// Most elevators have not moved since the last call
+		if (!cost.valid || memcmp(&cost.status, &status, sizeof(dataPoolData)) != 0) {
+
+			UpdateCost(elevator, status);
+			_changedCosts.push_back(elevator);
+
+		}
+
+	}
+
+	// Costs worked out from a torn copy are thrown away, and worked out again
+	// from the snapshot read next
+	if (_snapshot.Changed(snapshot, sequence)) {
+
+		for (size_t i = 0; i < _changedCosts.size(); i++) {
+
+			_costs[_changedCosts[i]].valid = false;
+
+		}
+
+		return false;
+
+	}
+
+	_costTick = snapshot->tick;
+
+	return true;
+
+}
+
+bool Dispatcher::Live(int elevatorNumber, unsigned long long tick) const {
+
+	return _costs[elevatorNumber].sent && tick < _costs[elevatorNumber].sentTick + liveStatusTicks;
+
+}
+
+void Dispatcher::Sent(int elevatorNumber, const outsideElevatorData *call) {
+
+	_costs[elevatorNumber].sent = true;
+	_costs[elevatorNumber].sentTick = _snapshot.Tick();
+
+	if (call != NULL) {
+
+		_costs[elevatorNumber].sentCall = true;
+		_costs[elevatorNumber].call = *call;
+
+	}
+
+}
+
+bool Dispatcher::ReadStatus(int elevatorNumber, dataPoolData &status) {
+
+	long sequence;
+	const fleetSnapshot *snapshot;
+	bool found;
+
+	do {
+
+		snapshot = _snapshot.Read(sequence);
+		found = elevatorNumber < snapshot->numOfElevators;
+
+		if (found) {
+
+			status = Live(elevatorNumber, snapshot->tick) ? _liveStatus[elevatorNumber] : snapshot->elevators[elevatorNumber];
+
+		}
+
+	} while (_snapshot.Changed(snapshot, sequence));
+
+	return found;
+
+}
+
+void Dispatcher::UpdateCost(int elevatorNumber, const dataPoolData &status) {
+
+	carCost &cost = _costs[elevatorNumber];
+
+	memcpy(&cost.status, &status, sizeof(dataPoolData));
+	cost.valid = true;
+
+	for (int floor = 0; floor < numOfFloors; floor++) {
+
+		int distance = abs(status.currentFloorNumber - floor);
+
+		// If the elevator is going up and has gone past the floor where the person
+		// requests for the elevator, it ignores the request. If the elevator is going
+		// down and has gone past the floor where the person request for the elevator,
+		// it ignores the request and does nothing.
+		bool passed = (status.currentFloorNumber > floor && status.direction == UP)
+			|| (status.currentFloorNumber < floor && status.direction == DOWN);
+
+		for (int direction = 0; direction < 2; direction++) {
+
+			char userDirection = (direction == 0) ? UP : DOWN;
+			bool sameDirection = (status.direction == userDirection) || (status.direction == NODIR);
+
+			cost.freeCost[floor][direction] = noDispatchCost;
+			cost.busyCost[floor][direction] = noDispatchCost;
+
+			if (passed || !sameDirection || status.serviceStatus != NOFAULT) {
+
+				continue;
+
+			}
+
+			cost.busyCost[floor][direction] = distance;
+
+			// A free elevator has its door shut, and if it is moving the call
+			// is before the floor it is going to
+			if (status.doorStatus != OPEN && (status.movingStatus != MOVING
+				|| distance <= abs(status.desiredFloorNumber - status.currentFloorNumber))) {
+
+				cost.freeCost[floor][direction] = distance;
+
+			}
+
+		}
+
+	}
+
+}
+
+void Dispatcher::SendElevatorToDestination() {
+
+	int desiredFloor = _elevatorDestination.desiredFloorNumber;
+	int elevatorNumber = _elevatorDestination.currentElevatorNumber;
+
+	if (elevatorNumber < 0 || elevatorNumber >= maxElevators || !_fleet->inService[elevatorNumber]) {
+
+		return;
+
+	}
+
+	dataPoolData status;
+
+	if (!ReadStatus(elevatorNumber, status)) {
+
+		return;
+
+	}
+
+	int currentFloor = status.currentFloorNumber;
+	char direction = status.direction;
+	char fault = status.serviceStatus;
+
+	// If the user presses up and his direction is up, go up
+	// If the user presses down and his direction is down, go down
+	// Otherwise, the user initially called the elevator to go up but now wants to
+	// go down which is bad
+	if (((desiredFloor >= currentFloor) && (direction == UP)) ||
+		((desiredFloor <= currentFloor) && (direction == DOWN))
+		&&
+		(fault != FAULT)) {
+
+		// Built straight into the elevator's pipe rather than copied in
+		insideElevatorData *elevatorDestination = (insideElevatorData*)_elevatorPipesInside[elevatorNumber]->Reserve(sizeof(insideElevatorData), dispatchTimeout);
+
+		if (elevatorDestination == NULL) {
+
+			LOG_EVENTF("elevator %d full, drop floor %d", elevatorNumber, desiredFloor);
+			return;
+
+		}
+
+		elevatorDestination->currentElevatorNumber = elevatorNumber;
+		elevatorDestination->desiredFloorNumber = desiredFloor;
+		_elevatorPipesInside[elevatorNumber]->Commit(sizeof(insideElevatorData));
+		Sent(elevatorNumber);
+
+		LOG_EVENTF("send elevator %d to floor %d", elevatorNumber, desiredFloor);
+
+	}
+
+}
+
+void Dispatcher::TerminateElevators() {
+
+	const fleetTable *fleet = _fleet;
+
+	for (int car = 0; car < fleet->numOfCars; car++) {
+
+		TerminateElevator(fleet->cars[car]);
+
+	}
+
+	LOG_EVENTF("terminate");
+
+}
+
+void Dispatcher::SendFaultToElevator() {
+
+	if (_faultInput.elevatorNumber < 0 || _faultInput.elevatorNumber >= maxElevators || !_fleet->inService[_faultInput.elevatorNumber]) {
+
+		return;
+
+	}
+
+	dataPoolData status;
+
+	if (!ReadStatus(_faultInput.elevatorNumber, status)) {
+
+		return;
+
+	}
+
+	char fault = status.serviceStatus;
+
+	// Should not send if input is + and there is no fault currently
+	if (!(_faultInput.faultType == NOFAULT && fault == NOFAULT)) {
+
+		if (!_elevatorFaultPipe[_faultInput.elevatorNumber]->Write(&_faultInput, sizeof(faultElevatorData), dispatchTimeout, PIPE_DROP_OLDEST)) {
+
+			LOG_EVENTF("elevator %d full, drop %s", _faultInput.elevatorNumber, _faultInput.faultType == FAULT ? "fault" : "clear fault");
+			return;
+
+		}
+
+		Sent(_faultInput.elevatorNumber);
+		LOG_EVENTF("%s elevator %d", _faultInput.faultType == FAULT ? "fault" : "clear fault", _faultInput.elevatorNumber);
+
+	}
+
+}
@@ -1,307 +1,492 @@
-#include "Elevator.h"
-#include "stringcat.h"
-
-Elevator::Elevator(int elevatorNumber) :
-	_elevatorNumber(elevatorNumber),
-	_destinationFloor(-1),
-	_DispatcherElevatorMutex("IODispatcherElevator"),
-	_elevatorDataPool("Elevator" + itos(_elevatorNumber) + "Datapool", sizeof(dataPoolData)),
-	_pipeOutside("PipeOutside" + itos(_elevatorNumber)),
-	_pipeInside("PipeInside" + itos(_elevatorNumber)),
-	_faultPipe("FaultPipe" + itos(_elevatorNumber)),
-	_IOElevatorSemaphoreP("IOElevatorSemaphoreP" + itos(_elevatorNumber), 0),
-	_IOElevatorSemaphoreC("IOElevatorSemaphoreC" + itos(_elevatorNumber), 1){
-
-	_elevatorDataPoolPtr = (dataPoolData*)(_elevatorDataPool.LinkDataPool());
-
-}
-
-
-Elevator::~Elevator()
-{
-
-
-
-}
-
-int Elevator::main() {
-
-	PollForElevatorCall();
-
-	return 0;
-
-}
-
-void Elevator::PollForElevatorCall() {
-
-	while (1) {
-
-		SLEEP(50);
-
-		CheckForFaultRequest();
-
-		CheckForOutsideElevatorRequest();
-		
-		CheckForInsideElevatorRequest();
-
-	}
-
-}
-
-
-bool Elevator::CheckForFaultRequest() {
-
-	if (_faultPipe.TestForData() >= sizeof(_faultInput)) {
-
-		_faultPipe.Read(&_faultInput, sizeof(_faultInput));
-
-		if (_faultInput[0] == 'e' && _faultInput[1] == 'e') {
-
-			_IOElevatorSemaphoreP.Wait();
-			_elevatorDataPoolPtr->direction = NODIR;
-			_elevatorDataPoolPtr->doorStatus = CLOSED;
-			_IOElevatorSemaphoreC.Signal();
-
-			RemovePendingRequests();
-			queueData floorZero;
-			floorZero.destination = 0;
-			floorZero.destinationStatus = TERMINATED;
-			floorZero.direction = DOWN;
-			_destinationPQ.push(floorZero);
-			GoToFloor();
-
-		}
-		else {
-
-			if (_faultInput[0] == '-') {
-
-				_IOElevatorSemaphoreP.Wait();
-				_elevatorDataPoolPtr->serviceStatus = FAULT;
-				_elevatorDataPoolPtr->doorStatus = CLOSED;
-				_elevatorDataPoolPtr->movingStatus = IDLE;
-				_elevatorDataPoolPtr->direction = NODIR;
-				RemovePendingRequests(); // pop off all requests
-				_IOElevatorSemaphoreC.Signal();
-
-			}
-			else if (_faultInput[0] == '+') {
-
-				_IOElevatorSemaphoreP.Wait();
-				_elevatorDataPoolPtr->serviceStatus = NOFAULT;
-				_elevatorDataPoolPtr->doorStatus = CLOSED;
-				_elevatorDataPoolPtr->direction = NODIR;
-				_IOElevatorSemaphoreC.Signal();
-
-			}
-		}
-
-		return true;
-
-	}
-
-	return false;
-
-}
-
-void Elevator::CheckForOutsideElevatorRequest() {
-
-	if (_pipeOutside.TestForData() >= sizeof(outsideElevatorData)) {
-
-		outsideElevatorData elevatorCall;
-		_pipeOutside.Read(&elevatorCall, sizeof(outsideElevatorData));
-
-		queueData destination;
-		destination.destination = elevatorCall.currentFloorNumber;
-		destination.destinationStatus = PICKUP;
-		_direction = elevatorCall.direction;
-		destination.direction = _direction;
-		_elevatorDataPoolPtr->desiredFloorNumber = destination.destination;
-
-		if (_elevatorDataPoolPtr->movingStatus == MOVING) {
-
-			_destinationPQ.push(destination);
-
-			if (_elevatorDataPoolPtr->doorStatus != OPEN) {
-
-				GoToFloor();
-
-			}
-
-		}
-		else {
-
-			if (_destinationPQ.empty()) {
-
-				_elevatorDataPoolPtr->direction = elevatorCall.direction;
-
-			}
-
-			_destinationPQ.push(destination);
-
-			if (_elevatorDataPoolPtr->doorStatus != OPEN) {
-
-				GoToFloor();
-
-			}
-
-		}
-
-	}
-
-}
-
-void Elevator::CheckForInsideElevatorRequest() {
-
-	if (_pipeInside.TestForData() >= sizeof(insideElevatorData)) {
-
-		insideElevatorData elevatorDestination;
-		_pipeInside.Read(&elevatorDestination, sizeof(insideElevatorData));
-
-		queueData destination;
-		destination.destination = elevatorDestination.desiredFloorNumber;
-		destination.destinationStatus = DROPOFF;
-		destination.direction = _direction;
-
-		// Close the door
-		_IOElevatorSemaphoreP.Wait();
-		_elevatorDataPoolPtr->doorStatus = CLOSED;
-		_IOElevatorSemaphoreC.Signal();
-
-		_destinationPQ.push(destination);
-
-		GoToFloor();
-
-	}
-
-}
-
-void Elevator::GoToFloor() {
-
-	// TODO put mutex here?
-	_elevatorDataPoolPtr->movingStatus = MOVING;
-
-	_destinationFloor = _destinationPQ.top().destination;
-	_destinationStatus = _destinationPQ.top().destinationStatus;
-
-	// We do not need a semaphore here because the current floor number
-	// is only changed by the while loop below when the elevator is moving
-	if (_elevatorDataPoolPtr->currentFloorNumber < _destinationFloor) {
-
-		while (_elevatorDataPoolPtr->currentFloorNumber != _destinationFloor) {
-			
-			if (CheckForFaultRequest()) {
-
-				return;
-
-			}
-
-			_IOElevatorSemaphoreP.Wait();
-			_DispatcherElevatorMutex.Wait();
-			_elevatorDataPoolPtr->currentFloorNumber++;
-			_DispatcherElevatorMutex.Signal();
-			_IOElevatorSemaphoreC.Signal();
-			
-			if (_pipeOutside.TestForData() >= sizeof(outsideElevatorData)) {
-
-				return;
-
-			}
-
-		}
-
-	}
-	else if(_elevatorDataPoolPtr->currentFloorNumber > _destinationFloor) {
-
-		while (_elevatorDataPoolPtr->currentFloorNumber != _destinationFloor) {
-
-			if (CheckForFaultRequest()) {
-
-				return;
-
-			}
-
-			_IOElevatorSemaphoreP.Wait();
-			_DispatcherElevatorMutex.Wait();
-			_elevatorDataPoolPtr->currentFloorNumber--;
-			_DispatcherElevatorMutex.Signal();
-			_IOElevatorSemaphoreC.Signal();
-
-			if (_pipeOutside.TestForData() >= sizeof(outsideElevatorData)) {
-
-				return;
-
-			}
-
-		}
-
-	}
-
-	_destinationPQ.pop();
-
-	if (_destinationStatus == PICKUP) {
-
-		// Open the door
-		_IOElevatorSemaphoreP.Wait();
-		_elevatorDataPoolPtr->doorStatus = OPEN;
-		_elevatorDataPoolPtr->direction = _direction;
-
-		// Stopped moving
-		_elevatorDataPoolPtr->movingStatus = IDLE;
-		_IOElevatorSemaphoreC.Signal();
-
-	}
-	else if (_destinationStatus == DROPOFF) {
-
-		// Open the door to let people off for 1 second
-		_IOElevatorSemaphoreP.Wait();
-		_elevatorDataPoolPtr->doorStatus = OPEN;
-		_IOElevatorSemaphoreC.Signal();
-		SLEEP(1000);
-
-		// Close the door
-		_IOElevatorSemaphoreP.Wait();
-		_elevatorDataPoolPtr->doorStatus = CLOSED;
-
-		// Stopped moving
-		_elevatorDataPoolPtr->movingStatus = IDLE;
-		_IOElevatorSemaphoreC.Signal();
-
-		// If there are still places to go, pop it off and call this function again
-		if (!_destinationPQ.empty()) {
-
-			// Close the door
-			_IOElevatorSemaphoreP.Wait();
-			_elevatorDataPoolPtr->doorStatus = CLOSED;
-			_IOElevatorSemaphoreC.Signal();
-
-			GoToFloor();
-
-		}
-
-		_IOElevatorSemaphoreP.Wait();
-		// If we are not at a pick up, then we are done
-		if (_elevatorDataPoolPtr->doorStatus != OPEN) {
-			_elevatorDataPoolPtr->direction = NODIR;
-		}
-		_IOElevatorSemaphoreC.Signal();
-
-	}
-	else if (_destinationStatus == TERMINATED) {
-
-		_IOElevatorSemaphoreP.Wait();
-		_elevatorDataPoolPtr->doorStatus = OPEN;
-		_IOElevatorSemaphoreC.Signal();
-
-	}		
-
-}
-
-void Elevator::RemovePendingRequests() {
-
-	while (!_destinationPQ.empty()) {
-
-		_destinationPQ.pop();
-
-	}
-
-}
\ No newline at end of file
+#include "Elevator.h"
+#include "stringcat.h"
+
+Elevator::Elevator(int elevatorNumber, const std::string &prefix, bool waitForFleet, FleetDeadlines *fleetDeadlines) :
+	_elevatorNumber(elevatorNumber),
+	_allocations(ALLOCATIONS_NOT_COUNTED),
+	_destinationFloor(-1),
+	_fleetDataPool(prefix + "FleetDatapool", sizeof(fleetDataPoolData)),
+	_pipeOutside(prefix + "PipeOutside" + itos(_elevatorNumber)),
+	_pipeInside(prefix + "PipeInside" + itos(_elevatorNumber)),
+	_faultPipe(prefix + "FaultPipe" + itos(_elevatorNumber)),
+	_IOElevatorSemaphoreP(prefix + "IOElevatorSemaphoreP" + itos(_elevatorNumber), 0),
+	_IOElevatorSemaphoreC(prefix + "IOElevatorSemaphoreC" + itos(_elevatorNumber), 1),
+	_fleetReady(NULL),
+	_fleetDeadlines(fleetDeadlines),
+	_deadlineWakeup(NULL),
+	_deadlines(NULL),
+	_deadlinePassed(false),
+	_terminating(false) {
+
+	fleetDataPoolData *fleet = (fleetDataPoolData*)(_fleetDataPool.LinkDataPool());
+	_elevatorDataPoolPtr = &fleet->elevators[_elevatorNumber];
+
+	if (waitForFleet) {
+
+		_fleetReady = new CRendezvous(prefix + "FleetReady", fleetReadyThreads(fleet->numOfElevators));
+
+	}
+
+	if (_fleetDeadlines != NULL) {
+
+		_deadlineWakeup = new CSemaphore(prefix + "DeadlineWakeup" + itos(_elevatorNumber), 0);
+
+	}
+
+}
+
+
+Elevator::~Elevator()
+{
+
+	delete _fleetReady;
+	delete _deadlineWakeup;
+	delete _deadlines;
+
+}
+
+int Elevator::main() {
+
+	// Room for the one deadline it has at a time, so setting it never allocates
+	if (_fleetDeadlines == NULL) {
+
+		_deadlines = new CTimerWheel(1000);
+		_deadlines->Reserve(1);
+
+	}
+
+	// Nothing is read or moved until the whole fleet exists
+	while (_fleetReady != NULL && _fleetReady->Wait(pollPeriod) == WAIT_TIMEOUT) {
+
+		if (TerminateStatus()) {
+
+			return 0;
+
+		}
+
+	}
+
+	PollForElevatorCall();
+
+	return 0;
+
+}
+
+void Elevator::PollForElevatorCall() {
+
+	// Counting starts at the end of the first poll, as in the dispatcher
+	ULONGLONG firstAllocations = ALLOCATIONS_NOT_COUNTED;
+
+	while (!TerminateStatus()) {
+
+		ULONGLONG sleepStart = GET_TIME_US();
+
+		if (WaitForTerminate(pollPeriod)) {
+
+			break;
+
+		}
+
+		ULONGLONG slept = GET_TIME_US() - sleepStart;
+		_jitter.Add((slept > pollPeriod * 1000) ? slept - pollPeriod * 1000 : 0);
+
+		// Once the elevator has gone down to floor zero nothing more is read
+		if (CheckForFaultRequest() && TerminateStatus()) {
+
+			break;
+
+		}
+
+		CheckForOutsideElevatorRequest();
+		
+		CheckForInsideElevatorRequest();
+
+		if (firstAllocations == ALLOCATIONS_NOT_COUNTED) {
+
+			firstAllocations = GET_ALLOCATION_COUNT();
+
+		}
+
+	}
+
+	if (firstAllocations != ALLOCATIONS_NOT_COUNTED) {
+
+		_allocations = GET_ALLOCATION_COUNT() - firstAllocations;
+
+	}
+
+	DrainPipes();
+
+}
+
+void Elevator::DrainPipes() {
+
+	// Nothing more is done, but the dispatcher must not be left waiting for room
+	char discard[sizeof(insideElevatorData) + sizeof(outsideElevatorData)];
+
+	while (_pipeOutside.TestForData() >= sizeof(outsideElevatorData)) {
+
+		_pipeOutside.Read(discard, sizeof(outsideElevatorData));
+
+	}
+
+	while (_pipeInside.TestForData() >= sizeof(insideElevatorData)) {
+
+		_pipeInside.Read(discard, sizeof(insideElevatorData));
+
+	}
+
+	while (_faultPipe.TestForData() >= sizeof(faultElevatorData)) {
+
+		_faultPipe.Read(&_faultInput, sizeof(faultElevatorData));
+
+	}
+
+}
+
+
+bool Elevator::CheckForFaultRequest() {
+
+	if (_faultPipe.TestForData() >= sizeof(faultElevatorData)) {
+
+		_faultPipe.Read(&_faultInput, sizeof(faultElevatorData));
+
+		if (_faultInput.faultType == TERMINATED) {
+
+			_IOElevatorSemaphoreP.Wait();
+			_elevatorDataPoolPtr->direction = NODIR;
+			_elevatorDataPoolPtr->doorStatus = CLOSED;
+			_IOElevatorSemaphoreC.Signal();
+
+			// Calls and faults that arrive on the way down are thrown away, so
+			// GoToFloor() only stops short of floor zero on RequestTerminate()
+			_terminating = true;
+			RemovePendingRequests();
+			_direction = DOWN;
+			_destinations.Add(0, TERMINATED);
+			GoToFloor();
+
+			if (_elevatorDataPoolPtr->currentFloorNumber == 0) {
+
+				RequestTerminate(); // The elevator stops for good once it is on floor zero
+
+			}
+
+		}
+		else {
+
+			if (_faultInput.faultType == FAULT) {
+
+				_IOElevatorSemaphoreP.Wait();
+				_elevatorDataPoolPtr->serviceStatus = FAULT;
+				_elevatorDataPoolPtr->doorStatus = CLOSED;
+				_elevatorDataPoolPtr->movingStatus = IDLE;
+				_elevatorDataPoolPtr->direction = NODIR;
+				RemovePendingRequests(); // pop off all requests
+				_IOElevatorSemaphoreC.Signal();
+
+			}
+			else if (_faultInput.faultType == NOFAULT) {
+
+				_IOElevatorSemaphoreP.Wait();
+				_elevatorDataPoolPtr->serviceStatus = NOFAULT;
+				_elevatorDataPoolPtr->doorStatus = CLOSED;
+				_elevatorDataPoolPtr->direction = NODIR;
+				_IOElevatorSemaphoreC.Signal();
+
+			}
+		}
+
+		return true;
+
+	}
+
+	return false;
+
+}
+
+void Elevator::CheckForOutsideElevatorRequest() {
+
+	int count = (int)(_pipeOutside.TestForData() / sizeof(outsideElevatorData));
+
+	if (count > 0) {
+
+		// Every call waiting is used where the dispatcher put it and released
+		// before anything waits, then the elevator sets off for the best of them
+		const outsideElevatorData *elevatorCalls = (const outsideElevatorData*)_pipeOutside.Peek(count * sizeof(outsideElevatorData));
+
+		for (int i = 0; i < count; i++) {
+
+			_direction = elevatorCalls[i].direction;
+			_elevatorDataPoolPtr->desiredFloorNumber = elevatorCalls[i].currentFloorNumber;
+
+			if (_elevatorDataPoolPtr->movingStatus != MOVING && _destinations.Empty()) {
+
+				_elevatorDataPoolPtr->direction = elevatorCalls[i].direction;
+
+			}
+
+			_destinations.Add(elevatorCalls[i].currentFloorNumber, PICKUP);
+
+		}
+
+		_pipeOutside.Release(count * sizeof(outsideElevatorData));
+
+		if (_elevatorDataPoolPtr->doorStatus != OPEN) {
+
+			GoToFloor();
+
+		}
+
+	}
+
+}
+
+void Elevator::CheckForInsideElevatorRequest() {
+
+	int count = (int)(_pipeInside.TestForData() / sizeof(insideElevatorData));
+
+	if (count > 0) {
+
+		const insideElevatorData *elevatorDestinations = (const insideElevatorData*)_pipeInside.Peek(count * sizeof(insideElevatorData));
+
+		for (int i = 0; i < count; i++) {
+
+			_destinations.Add(elevatorDestinations[i].desiredFloorNumber, DROPOFF);
+
+		}
+
+		_pipeInside.Release(count * sizeof(insideElevatorData));
+
+		// Close the door
+		_IOElevatorSemaphoreP.Wait();
+		_elevatorDataPoolPtr->doorStatus = CLOSED;
+		_IOElevatorSemaphoreC.Signal();
+
+		GoToFloor();
+
+	}
+
+}
+
+void Elevator::GoToFloor() {
+
+	if (_destinations.Empty()) {
+
+		return;
+
+	}
+
+	// TODO put mutex here?
+	_elevatorDataPoolPtr->movingStatus = MOVING;
+
+	_destinationFloor = _destinations.Next(_elevatorDataPoolPtr->currentFloorNumber, _direction);
+	_destinationStatus = _destinations.Status(_destinationFloor);
+
+	// We do not need a semaphore here because the current floor number
+	// is only changed by the while loop below when the elevator is moving
+	if (_elevatorDataPoolPtr->currentFloorNumber < _destinationFloor) {
+
+		while (_elevatorDataPoolPtr->currentFloorNumber != _destinationFloor) {
+			
+			if (_terminating) {
+
+				DrainPipes();
+
+			}
+			else if (CheckForFaultRequest()) {
+
+				return;
+
+			}
+
+			if (TerminateStatus()) {
+
+				return;
+
+			}
+
+			_IOElevatorSemaphoreP.Wait();
+			_elevatorDataPoolPtr->currentFloorNumber++;
+			_IOElevatorSemaphoreC.Signal();
+			
+			if (!_terminating && _pipeOutside.TestForData() >= sizeof(outsideElevatorData)) {
+
+				return;
+
+			}
+
+		}
+
+	}
+	else if(_elevatorDataPoolPtr->currentFloorNumber > _destinationFloor) {
+
+		while (_elevatorDataPoolPtr->currentFloorNumber != _destinationFloor) {
+
+			if (_terminating) {
+
+				DrainPipes();
+
+			}
+			else if (CheckForFaultRequest()) {
+
+				return;
+
+			}
+
+			if (TerminateStatus()) {
+
+				return;
+
+			}
+
+			_IOElevatorSemaphoreP.Wait();
+			_elevatorDataPoolPtr->currentFloorNumber--;
+			_IOElevatorSemaphoreC.Signal();
+
+			if (!_terminating && _pipeOutside.TestForData() >= sizeof(outsideElevatorData)) {
+
+				return;
+
+			}
+
+		}
+
+	}
+
+	_destinations.Remove(_destinationFloor);
+
+	if (_destinationStatus == PICKUP) {
+
+		LOG_EVENTF("elevator %d pickup at floor %d", _elevatorNumber, _destinationFloor);
+
+		// Open the door
+		_IOElevatorSemaphoreP.Wait();
+		_elevatorDataPoolPtr->doorStatus = OPEN;
+		_elevatorDataPoolPtr->direction = _direction;
+
+		// Stopped moving
+		_elevatorDataPoolPtr->movingStatus = IDLE;
+		_IOElevatorSemaphoreC.Signal();
+
+	}
+	else if (_destinationStatus == DROPOFF) {
+
+		LOG_EVENTF("elevator %d dropoff at floor %d", _elevatorNumber, _destinationFloor);
+
+		// Open the door to let people off for 1 second
+		_IOElevatorSemaphoreP.Wait();
+		_elevatorDataPoolPtr->doorStatus = OPEN;
+		_IOElevatorSemaphoreC.Signal();
+		WaitForDeadline(doorDwellTime);
+
+		// Close the door
+		_IOElevatorSemaphoreP.Wait();
+		_elevatorDataPoolPtr->doorStatus = CLOSED;
+
+		// Stopped moving
+		_elevatorDataPoolPtr->movingStatus = IDLE;
+		_IOElevatorSemaphoreC.Signal();
+
+		// If there are still places to go, call this function again to go to the next
+		if (!_destinations.Empty()) {
+
+			// Close the door
+			_IOElevatorSemaphoreP.Wait();
+			_elevatorDataPoolPtr->doorStatus = CLOSED;
+			_IOElevatorSemaphoreC.Signal();
+
+			GoToFloor();
+
+		}
+
+		_IOElevatorSemaphoreP.Wait();
+		// If we are not at a pick up, then we are done
+		if (_elevatorDataPoolPtr->doorStatus != OPEN) {
+			_elevatorDataPoolPtr->direction = NODIR;
+		}
+		_IOElevatorSemaphoreC.Signal();
+
+	}
+	else if (_destinationStatus == TERMINATED) {
+
+		LOG_EVENTF("elevator %d stopped at floor %d", _elevatorNumber, _destinationFloor);
+
+		_IOElevatorSemaphoreP.Wait();
+		_elevatorDataPoolPtr->doorStatus = OPEN;
+		_IOElevatorSemaphoreC.Signal();
+
+	}		
+
+}
+
+void Elevator::RemovePendingRequests() {
+
+	_destinations.Clear();
+
+}
+
+bool Elevator::WaitForDeadline(DWORD time) {
+
+	_deadlinePassed = false;
+
+	if (_fleetDeadlines != NULL) {
+
+		TIMERWHEELID fleetDeadline = _fleetDeadlines->Set((ULONGLONG)time * 1000, DeadlinePassed, this);
+
+		while (!_deadlinePassed) {
+
+			if (TerminateStatus()) {
+
+				_fleetDeadlines->Cancel(fleetDeadline);
+				return true;
+
+			}
+
+			_deadlineWakeup->Wait(pollPeriod);
+
+		}
+
+		return false;
+
+	}
+
+	TIMERWHEELID deadline = _deadlines->Set((ULONGLONG)time * 1000, DeadlinePassed, this);
+
+	while (!_deadlinePassed) {
+
+		_deadlines->Advance();
+
+		if (_deadlinePassed) {
+
+			break;
+
+		}
+
+		ULONGLONG wait = _deadlines->TimeToNext();
+
+		if (WaitForTerminate((wait < 1000) ? 1 : (DWORD)(wait / 1000))) {
+
+			_deadlines->Cancel(deadline);
+			return true;
+
+		}
+
+	}
+
+	return false;
+
+}
+
+void Elevator::DeadlinePassed(void *elevator) {
+
+	Elevator *waiting = (Elevator*)elevator;
+	waiting->_deadlinePassed = true;
+
+	if (waiting->_deadlineWakeup != NULL) {
+
+		waiting->_deadlineWakeup->Signal();
+
+	}
+
+}
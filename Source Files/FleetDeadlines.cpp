@@ -0,0 +1,56 @@
+#include "FleetDeadlines.h"
+
+FleetDeadlines::FleetDeadlines(const std::string &prefix) :
+	_wheel(1000),
+	_deadlineSet(prefix + "FleetDeadlineSet", 0) {
+
+	_wheel.Reserve(maxElevators);
+
+}
+
+TIMERWHEELID FleetDeadlines::Set(ULONGLONG delay, TIMERWHEELPROC callback, void *arg) {
+
+	TIMERWHEELID deadline = _wheel.Set(delay, callback, arg);
+	_deadlineSet.Signal();
+
+	return deadline;
+
+}
+
+bool FleetDeadlines::Cancel(TIMERWHEELID deadline) {
+
+	return _wheel.Cancel(deadline) == TRUE;
+
+}
+
+void FleetDeadlines::Stop() {
+
+	RequestTerminate();
+	_deadlineSet.Signal();
+
+}
+
+int FleetDeadlines::main(void) {
+
+	while (!TerminateStatus()) {
+
+		_wheel.Advance();
+
+		ULONGLONG wait = _wheel.TimeToNext();
+
+		if (wait == TIMERWHEEL_NONE) {
+
+			_deadlineSet.Wait();
+
+		}
+		else {
+
+			_deadlineSet.Wait((wait < 1000) ? 1 : (DWORD)(wait / 1000));
+
+		}
+
+	}
+
+	return 0;
+
+}
@@ -0,0 +1,66 @@
+#include "FleetSnapshot.h"
+
+#include <cstring>
+
+FleetSnapshot::FleetSnapshot(fleetDataPoolData *fleet) :
+	_fleet(fleet) {
+
+}
+
+void FleetSnapshot::Publish(const dataPoolData *states, int numOfElevators) {
+
+	const fleetSnapshot *latest = &_fleet->snapshots[_fleet->latestSnapshot];
+	long back = 1 - _fleet->latestSnapshot;
+	fleetSnapshot *snapshot = &_fleet->snapshots[back];
+
+	// Odd while it is written, so a reader still on it from two ticks ago knows
+	InterlockedIncrement((volatile LONG*)&snapshot->sequence);
+
+	snapshot->tick = latest->tick + 1;
+	snapshot->numOfElevators = numOfElevators;
+	memcpy(snapshot->elevators, states, numOfElevators * sizeof(dataPoolData));
+
+	InterlockedIncrement((volatile LONG*)&snapshot->sequence);
+	InterlockedExchange((volatile LONG*)&_fleet->latestSnapshot, back);
+
+}
+
+const fleetSnapshot *FleetSnapshot::Read(long &sequence) const {
+
+	const fleetSnapshot *snapshot;
+
+	do {
+
+		snapshot = &_fleet->snapshots[_fleet->latestSnapshot];
+		sequence = snapshot->sequence;
+
+	} while (sequence & 1);
+
+	return snapshot;
+
+}
+
+unsigned long long FleetSnapshot::Tick() const {
+
+	const fleetSnapshot *snapshot;
+	long sequence;
+	unsigned long long tick;
+
+	do {
+
+		snapshot = Read(sequence);
+		tick = snapshot->tick;
+
+	} while (Changed(snapshot, sequence));
+
+	return tick;
+
+}
+
+bool FleetSnapshot::Changed(const fleetSnapshot *snapshot, long sequence) const {
+
+	MemoryBarrier();
+
+	return snapshot->sequence != sequence;
+
+}
@@ -1,401 +1,905 @@
-﻿#include "IO.h"
-#include "Dispatcher.h"
-#include "stringcat.h"
-#include <iostream>
-
-using namespace std;
-
-IO::IO() :
-	_displaySemaphore("displaySemaphore", 1),
-	_pipeOutside("PipeOutside", 1024),
-	_pipeInside("PipeInside", 1024),
-	_faultPipe("FaultPipe", 1024) {
-
-}
-
-IO::~IO()
-{
-
-	for (int i = 0; i < _numOfElevators; i++) {
-
-		delete _elevators[i];
-		delete _elevatorDataPools[i];
-		delete _elevatorDataPoolPtrs[i];
-		delete _displayThreads[i];
-		delete _IOElevatorSemaphoresC[i];
-		delete _IOElevatorSemaphoresP[i];
-
-	}
-
-	delete _dispatcher;
-
-}
-
-int IO::main(void) {
-
-	GetNumberOfElevators();
-
-	CreateElevatorSystem();
-	CreateElevatorDataPools();
-
-	CreateSemaphores();
-
-	// Get user input and put in pipe
-	ClassThread <IO> Thread1(this, &IO::PollForUserInput, ACTIVE, NULL); 
-
-	InitializeDisplay();
-	UpdateDisplays();
-
-	while (1);
-
-	return 0;
-
-}
-
-void IO::GetNumberOfElevators() {
-
-	cout << "Enter the number of elevators: ";
-	cin >> _numOfElevators;
-		
-}
-
-void IO::CreateElevatorSystem() {
-
-	for (int i = 0; i < _numOfElevators; i++) {
-
-		CreateElevator(i);
-
-	}
-
-	CreateDispatcher();
-
-}
-
-void IO::CreateElevator(int i) {
-
-	_elevators.push_back(new Elevator(i));
-	_elevators[i]->Resume();
-
-}
-
-void IO::CreateElevatorDataPools() {
-
-	for (int i = 0; i < _numOfElevators; i++) {
-
-		_elevatorDataPools.push_back(new CDataPool("Elevator" + itos(i) + "Datapool", sizeof(struct dataPoolData)));
-		_elevatorDataPoolPtrs.push_back((dataPoolData*)(_elevatorDataPools[i]->LinkDataPool()));
-		_elevatorDataPoolPtrs[i]->direction = NODIR;
-		_elevatorDataPoolPtrs[i]->doorStatus = CLOSED;
-		_elevatorDataPoolPtrs[i]->movingStatus = IDLE;
-		_elevatorDataPoolPtrs[i]->serviceStatus = NOFAULT;
-		_elevatorDataPoolPtrs[i]->currentFloorNumber = 0;
-		_elevatorDataPoolPtrs[i]->desiredFloorNumber = 0;
-
-	}
-
-}
-
-void IO::CreateDispatcher() {
-
-	_dispatcher = new Dispatcher(_numOfElevators);
-	_dispatcher->Resume();
-
-}
-
-void IO::CreateSemaphores(){
-
-	for (int i = 0; i < _numOfElevators; i++) {
-
-		_IOElevatorSemaphoresP.push_back(new CSemaphore("IOElevatorSemaphoreP" + itos(i), 0));
-		_IOElevatorSemaphoresC.push_back(new CSemaphore("IOElevatorSemaphoreC" + itos(i), 1));
-
-	}
-
-}
-
-int IO::PollForUserInput(void *ThreadArgs) {
-
-	char userInput[2];
-	
-	while (1) {
-
-		PrintGetUserCommand();
-
-		userInput[0] = _getch();
-		userInput[1] = _getch();
-
-		PrintUserCommand(userInput[0], userInput[1]);
-		
-		// If you have a fault command, send it over
-		if (((userInput[0] == '-') &&
-			(userInput[1] >= 0 + 0x30 && userInput[1] < _numOfElevators + 0x30)) 
-			|| 
-			((userInput[0] == '+') &&
-			(userInput[1] >= 0 + 0x30 && userInput[1] < _numOfElevators + 0x30))) {
-
-			_faultPipe.Write(userInput, sizeof(userInput));
-
-		}
-		// If you have a terminate command, send it over and stop polling
-		else if (userInput[0] == 'e' && userInput[1] == 'e') {
-
-			_faultPipe.Write(userInput, sizeof(userInput));
-			return 0;
-
-		}
-		// Check if input is valid and check whether it's an outside or inside the elevator input
-		else if ((userInput[0] == 'u' || userInput[0] == 'd') &&
-			(userInput[1] >= 0 + 0x30 && userInput[1] <= 9 + 0x30)) {
-
-			_elevatorCall.direction = userInput[0];
-			_elevatorCall.currentFloorNumber = userInput[1] - 0x30;
-			_pipeOutside.Write(&_elevatorCall, sizeof(outsideElevatorData));
-
-		}
-		else if ((userInput[0] >= 0 + 0x30 && userInput[0] < _numOfElevators + 0x30) &&
-			(userInput[1] >= 0 + 0x30 && userInput[1] <= 9 + 0x30)) {
-
-				_elevatorDestination.currentElevatorNumber = userInput[0] - 0x30;
-				_elevatorDestination.desiredFloorNumber = userInput[1] - 0x30;
-				_pipeInside.Write(&_elevatorDestination, sizeof(insideElevatorData));
-
-		}
-
-	}
-
-	return 0;
-	
-}
-
-void IO::InitializeDisplay() {
-
-	_displaySemaphore.Wait();
-
-	PrintTitle();
-
-	for (int i = 0; i < 10; i++){
-
-		MOVE_CURSOR(0, i * columnSpacing + columnSpacing + 10);
-		cout << 10 - i - 1;
-
-	}
-
-	int x = 5 + _numOfElevators * rowSpacing;
-	int y = 10 * columnSpacing - 10 * columnSpacing - 2 + 10;
-
-	// Display elevators
-	TEXT_COLOUR(0, 14);
-	for (int i = 0; i < _numOfElevators; i++){
-
-		for (int j = 0; j < x; j++) {
-
-			MOVE_CURSOR(50, 100);
-			cout << " ";
-
-		}
-
-	}
-	_displaySemaphore.Signal();
-
-}
-
-void IO::UpdateDisplays() {
-
-	CSemaphore elevatorMutex("elevatorSemaphore", 0);
-
-	CURSOR_OFF();
-
-	for (int i = 0; i < _numOfElevators; i++){
-
-		_displayThreads.push_back(new ClassThread <IO>(this, &IO::UpdateDisplay, ACTIVE, &i));
-		elevatorMutex.Wait();
-
-	}
-
-}
-
-int IO::UpdateDisplay(void *ThreadArgs) {
-
-	CSemaphore elevatorMutex("elevatorSemaphore", 0);
-	int x;
-	int y;
-	int floorNum;
-	int elevator = *static_cast<int*>(ThreadArgs);
-	elevatorMutex.Signal();
-	while (1) {
-
-		_IOElevatorSemaphoresC[elevator]->Wait();
-		_displaySemaphore.Wait();
-
-		SLEEP(500);
-		floorNum = _elevatorDataPoolPtrs[elevator]->currentFloorNumber;
-		x = 5 + elevator * rowSpacing;
-		y = 10 * columnSpacing - floorNum * columnSpacing - 2 + 10;
-
-		Erase(x);
-		UpdateElevator(elevator, x, y);
-		UpdateElevatorDirection(elevator, x);
-		
-		_displaySemaphore.Signal();
-		_IOElevatorSemaphoresP[elevator]->Signal();
-
-	}
-	
-	return 0;
-
-}
-
-void IO::Erase(int x) {
-
-	// Erase
-	TEXT_COLOUR(15, 0);
-	for (int i = 0; i < 10; i++){
-
-		for (int j = 0; j < 5; j++) {
-
-			for (int k = 0; k < 4; k++) {
-
-				MOVE_CURSOR(x + j, 10 * columnSpacing - 2 - i * columnSpacing + k + 10);
-				cout << " ";
-
-			}
-
-		}
-
-	}
-
-}
-
-void IO::UpdateElevator(int elevator, int x, int y) {
-
-	// Move elevator
-	if (_elevatorDataPoolPtrs[elevator]->doorStatus != OPEN) {
-
-		int textColour;
-
-		if (_elevatorDataPoolPtrs[elevator]->serviceStatus == FAULT) {
-
-			textColour = 12;
-
-		}
-		else {
-
-			textColour = 10;
-
-		}
-
-		TEXT_COLOUR(0, textColour);
-		for (int j = 0; j < 5; j++) {
-
-			for (int k = 0; k < 4; k++) {
-
-				MOVE_CURSOR(x + j, y + k);
-				cout << " ";
-
-			}
-
-		}
-
-	}
-	else {
-
-		// Open the door
-		TEXT_COLOUR(0, 10);
-		for (int j = 0; j < 5; j++) {
-
-			for (int k = 0; k < 4; k++) {
-
-				MOVE_CURSOR(x + j, y + k);
-				cout << " ";
-
-			}
-
-		}
-		TEXT_COLOUR(15, 0);
-		for (int j = 1; j < 4; j++) {
-
-			for (int k = 1; k < 4; k++) {
-
-				MOVE_CURSOR(x + j, y + k);
-				cout << " ";
-
-			}
-
-		}
-
-	}
-
-}
-
-void IO::UpdateElevatorDirection(int elevator, int x) {
-
-	if (_elevatorDataPoolPtrs[elevator]->direction == UP) {
-		TEXT_COLOUR(14, 0);
-		MOVE_CURSOR(x + 1, 8);
-		cout << " /\\";
-		MOVE_CURSOR(x + 1, 9);
-		cout << "/||\\";
-		MOVE_CURSOR(x + 1, 10);
-		cout << " || ";
-	}
-	else if (_elevatorDataPoolPtrs[elevator]->direction == DOWN) {
-		TEXT_COLOUR(14, 0);
-		MOVE_CURSOR(x + 1, 8);
-		cout << " ||";
-		MOVE_CURSOR(x + 1, 9);
-		cout << "\\||/";
-		MOVE_CURSOR(x + 1, 10);
-		cout << " \\/";
-	}
-	else {
-
-		TEXT_COLOUR(14, 0);
-		MOVE_CURSOR(x + 1, 8);
-		cout << "     ";
-		MOVE_CURSOR(x + 1, 9);
-		cout << "     ";
-		MOVE_CURSOR(x + 1, 10);
-		cout << "     ";
-
-	}
-
-}
-
-void IO::PrintGetUserCommand() {
-
-	_displaySemaphore.Wait();
-	TEXT_COLOUR(15, 0);
-	MOVE_CURSOR(0, 55);
-	cout << "Enter elevator command:";
-	_displaySemaphore.Signal();
-
-}
-
-void IO::PrintUserCommand(char input1, char input2) {
-
-	_displaySemaphore.Wait();
-	TEXT_COLOUR(15, 0);
-	MOVE_CURSOR(24, 55);
-	cout << input1 << input2;
-	_displaySemaphore.Signal();
-
-}
-
-void IO::PrintTitle() {
-
-	MOVE_CURSOR(0, 0);
-
-	const char* title =
-		" _______  __   __  _______  _______  ______      _______  ___   __   __  _______    _______  _______  _______  _______ \n"
-		"|       ||  | |  ||       ||       ||    _ |    |       ||   | |  |_|  ||       |  |       ||  _    ||  _    ||  _    |\n"
-		"|  _____||  | |  ||    _  ||    ___||   | ||    |  _____||   | |       ||  _____|  |____   || | |   || | |   || | |   |\n"
-		"| |_____ |  |_|  ||   |_| ||   |___ |   |_||_   | |_____ |   | |       || |_____    ____|  || | |   || | |   || | |   |\n"
-		"|_____  ||       ||    ___||    ___||    __  |  |_____  ||   | |       ||_____  |  | ______|| |_|   || |_|   || |_|   |\n"
-		" _____| ||       ||   |    |   |___ |   |  | |   _____| ||   | | ||_|| | _____| |  | |_____ |       ||       ||       |\n"
-		"|_______||_______||___|    |_______||___|  |_|  |_______||___| |_|   |_||_______|  |_______||_______||_______||_______|\n";
-	
-	TEXT_COLOUR(12, 0);
-	cout << title << endl;
-
-}
-
+﻿#include "IO.h"
+#include "Dispatcher.h"
+#include "stringcat.h"
+#include <iostream>
+
+using namespace std;
+
+IO::IO(const simulationConfig &config) :
+	_fleetDataPool(NULL),
+	_fleetReady(NULL),
+	_snapshot(NULL),
+	_dispatcher(NULL),
+	_fleetDeadlines(NULL),
+	_processes(NULL),
+	_displaySemaphore(config.objectPrefix + "displaySemaphore", 1),
+	_renderThread(NULL),
+	_inputThread(NULL),
+	_pipeOutside(config.objectPrefix + "PipeOutside", dispatcherQueueSize),
+	_pipeInside(config.objectPrefix + "PipeInside", dispatcherQueueSize),
+	_faultPipe(config.objectPrefix + "FaultPipe", dispatcherQueueSize),
+	_config(config),
+	_inputReader(NULL),
+	_traceWriter(NULL),
+	_traceReplayer(NULL),
+	_startTime(0),
+	_commandEchoSequence(0) {
+
+	_commandEcho[0] = '\0';
+
+	// Must be set before any of the active classes are resumed
+	if (_config.deterministic) {
+
+		SET_DETERMINISTIC(TRUE, _config.seed);
+
+	}
+	else {
+
+		SET_RANDOM_SEED(_config.seed);
+
+	}
+
+	SET_EVENT_LOG(_config.eventLogFile);
+	SET_ADAPTIVE_WAIT(_config.adaptiveWait);
+
+	if (!_config.contentionReportFile.empty()) {
+
+		SET_CONTENTION_PROFILE(_config.contentionReportFile);
+
+	}
+
+	if (_config.pinThreads && PROCESSORS() < pinnedProcessors) {
+
+		LOG_EVENTF("%d processors, fewer than %d, threads not pinned", PROCESSORS(), pinnedProcessors);
+
+	}
+
+}
+
+IO::~IO()
+{
+
+	delete _processes; // Stops the child processes
+
+	LogJitter();
+
+	delete _fleetDeadlines; // Before the elevators its deadlines wake
+
+	for (size_t i = 0; i < _elevators.size(); i++) {
+
+		delete _elevators[i];
+
+	}
+
+	for (size_t i = 0; i < _IOElevatorSemaphoresC.size(); i++) {
+
+		delete _IOElevatorSemaphoresC[i];
+		delete _IOElevatorSemaphoresP[i];
+
+	}
+
+	delete _fleetReady;
+	delete _snapshot;
+	delete _fleetDataPool; // Also unmaps the memory _elevatorDataPoolPtrs points to
+
+	delete _renderThread;
+	delete _inputThread;
+	delete _traceReplayer;
+	delete _traceWriter;
+	delete _inputReader;
+	delete _dispatcher;
+
+	SET_EVENT_LOG("");
+
+	if (!_config.contentionReportFile.empty()) {
+
+		SET_CONTENTION_PROFILE(""); // Writes the report
+
+	}
+
+}
+
+int IO::main(void) {
+
+	GetNumberOfElevators();
+
+	// Everything the elevators share is made before any of them, so none
+	// can use a datapool or semaphore before it has been set up
+	ULONGLONG createStart = GET_TIME_US();
+
+	CreateElevatorDataPools();
+	CreateSemaphores();
+
+	CreateElevatorSystem();
+	WaitForFleet(createStart);
+
+	if (_config.inputFile.empty()) {
+
+		_inputReader = new InputReader(_numOfElevators);
+
+	}
+	else {
+
+		_inputReader = new InputReader(_numOfElevators, _config.inputFile);
+
+	}
+
+	_startTime = GET_TIME_US();
+
+	if (!_config.recordFile.empty()) {
+
+		_traceWriter = new TraceWriter(_config.recordFile);
+
+	}
+
+	if (!_config.replayFile.empty()) {
+
+		_traceReplayer = new TraceReplayer(_numOfElevators, _config.replayFile, _config.replayAsFastAsPossible, _config.objectPrefix);
+		_traceReplayer->Resume();
+
+	}
+
+	// Get user input and put in pipe
+	_inputThread = new ClassThread <IO>(this, &IO::PollForUserInput, SUSPENDED, NULL);
+	PlaceThread(*_inputThread, _config.displayPriority, 0, 0);
+	_inputThread->Resume();
+
+	InitializeDisplay();
+	UpdateDisplays();
+
+	// Run until 'ee' has been entered or replayed, or this IO is asked to
+	// terminate. Wait rather than spin so the other threads keep the
+	// processor, which the deterministic scheduler relies on
+	while (!_inputReader->Terminated() && !WaitForTerminate(framePeriod)) {
+
+		if (_dispatcher != NULL && _dispatcher->WaitForThread(0) == WAIT_OBJECT_0) {
+
+			break;
+
+		}
+
+	}
+
+	StopElevatorSystem();
+
+	return 0;
+
+}
+
+void IO::StopElevatorSystem() {
+
+	// Nothing can add an elevator once the input thread has gone, so every
+	// elevator is asked to stop and waited for below
+	_inputThread->RequestTerminate();
+	_inputThread->WaitForThread();
+
+	// After 'ee' the dispatcher and elevators stop by themselves once every
+	// elevator is back on floor zero
+	if (TerminateStatus()) {
+
+		if (_dispatcher != NULL) {
+
+			_dispatcher->RequestTerminate();
+
+		}
+
+		for (size_t i = 0; i < _elevators.size(); i++) {
+
+			_elevators[i]->RequestTerminate();
+
+		}
+
+	}
+
+	if (_traceReplayer != NULL) {
+
+		_traceReplayer->RequestTerminate();
+		_traceReplayer->WaitForThread();
+
+	}
+
+	if (_dispatcher != NULL) {
+
+		_dispatcher->WaitForThread();
+
+	}
+
+	for (size_t i = 0; i < _elevators.size(); i++) {
+
+		_elevators[i]->WaitForThread();
+
+	}
+
+	// Only once no elevator is waiting for a deadline
+	if (_fleetDeadlines != NULL) {
+
+		_fleetDeadlines->Stop();
+		_fleetDeadlines->WaitForThread();
+
+	}
+
+	_renderThread->RequestTerminate();
+	_renderThread->WaitForThread();
+
+}
+
+void IO::GetNumberOfElevators() {
+
+	cout << "Enter the number of elevators: ";
+	cin >> _numOfElevators;
+
+	PERR(_numOfElevators >= 1 && _numOfElevators <= maxElevators, "Number of Elevators Must be 1 to " + itos(maxElevators));
+
+	if (_numOfElevators < 1) {
+
+		_numOfElevators = 1;
+
+	}
+	else if (_numOfElevators > maxElevators) {
+
+		_numOfElevators = maxElevators;
+
+	}
+		
+}
+
+void IO::CreateElevatorSystem() {
+
+	if (!_config.processExecutable.empty() && CreateElevatorProcesses()) {
+
+		return;
+
+	}
+
+	_fleetDeadlines = new FleetDeadlines(_config.objectPrefix);
+
+	CreateElevators();
+	CreateDispatcher();
+
+	// Only started once every object they share exists
+	PlaceThread(*_fleetDeadlines, _config.elevatorPriority, 2, PROCESSORS() - 1);
+	_fleetDeadlines->Resume();
+
+	for (int i = 0; i < _numOfElevators; i++) {
+
+		PlaceThread(*_elevators[i], _config.elevatorPriority, 2, PROCESSORS() - 1);
+		_elevators[i]->Resume();
+
+	}
+
+	PlaceThread(*_dispatcher, _config.dispatcherPriority, 1, 1);
+	_dispatcher->Resume();
+
+}
+
+bool IO::CreateElevatorProcesses() {
+
+	// Processes only share named objects, and the deterministic scheduler
+	// cannot run threads in other processes
+	bool canUseProcesses = (GET_OBJECT_SCOPE() == GLOBAL_OBJECTS && !_config.deterministic && _config.elevatorsPerProcess > 0);
+	PERR(canUseProcesses, "Cannot Run the Elevators as Processes with these Options, Using Threads");
+
+	if (!canUseProcesses) {
+
+		return false;
+
+	}
+
+	_processes = new ProcessGroup(_config.processExecutable, _config.objectPrefix, _config.processAffinity);
+	_processes->StartDispatcher(_numOfElevators);
+
+	for (int first = 0; first < _numOfElevators; first += _config.elevatorsPerProcess) {
+
+		int count = _numOfElevators - first;
+
+		if (count > _config.elevatorsPerProcess) {
+
+			count = _config.elevatorsPerProcess;
+
+		}
+
+		_processes->StartElevators(first, count);
+
+	}
+
+	return true;
+
+}
+
+void IO::CreateElevators() {
+
+	volatile LONG next = 0;
+	int workers = IS_DETERMINISTIC() ? 1 : PROCESSORS();
+
+	_elevators.reserve(maxElevators);
+	_elevators.assign(_numOfElevators, NULL);
+
+	if (workers > _numOfElevators) {
+
+		workers = _numOfElevators;
+
+	}
+
+	if (workers <= 1) {
+
+		CreateElevatorWorker((void*)&next);
+		return;
+
+	}
+
+	vector<ClassThread<IO>*> threads;
+
+	for (int i = 0; i < workers; i++) {
+
+		threads.push_back(new ClassThread<IO>(this, &IO::CreateElevatorWorker, ACTIVE, (void*)&next));
+
+	}
+
+	for (int i = 0; i < workers; i++) {
+
+		threads[i]->WaitForThread();
+		delete threads[i];
+
+	}
+
+}
+
+int IO::CreateElevatorWorker(void *ThreadArgs) {
+
+	volatile LONG *next = (volatile LONG*)ThreadArgs;
+	LONG i;
+
+	while ((i = InterlockedIncrement(next) - 1) < _numOfElevators) {
+
+		_elevators[i] = new Elevator(i, _config.objectPrefix, true, _fleetDeadlines);
+
+	}
+
+	return 0;
+
+}
+
+void IO::WaitForFleet(ULONGLONG createStart) {
+
+	while (_fleetReady->Wait(framePeriod) == WAIT_TIMEOUT) {
+
+		if (TerminateStatus()) {
+
+			return;
+
+		}
+
+	}
+
+	LOG_EVENTF("fleet ready %d elevators in %lluus", _numOfElevators, GET_TIME_US() - createStart);
+
+}
+
+void IO::LogJitter() const {
+
+	JITTERSTATISTICS elevators;
+
+	for (size_t i = 0; i < _elevators.size(); i++) {
+
+		elevators.Merge(_elevators[i]->Jitter());
+
+	}
+
+	if (_dispatcher != NULL) {
+
+		const JITTERSTATISTICS &dispatcher = _dispatcher->Jitter();
+		LOG_EVENT(string("jitter dispatcher polls ") + itos(dispatcher.Samples) + " mean " + itos((int)dispatcher.Mean())
+			+ "us max " + itos((int)dispatcher.Max) + "us late " + itos(dispatcher.Late));
+
+	}
+
+	if (elevators.Samples > 0) {
+
+		LOG_EVENT(string("jitter elevators polls ") + itos(elevators.Samples) + " mean " + itos((int)elevators.Mean())
+			+ "us max " + itos((int)elevators.Max) + "us late " + itos(elevators.Late));
+
+	}
+
+}
+
+void IO::PlaceThread(const CThread &thread, int priority, int firstProcessor, int lastProcessor) {
+
+	if (priority != THREAD_PRIORITY_NORMAL) {
+
+		thread.SetPriority(priority);
+
+	}
+
+	// With fewer processors the roles would have to share them, see the constructor
+	if (!_config.pinThreads || PROCESSORS() < pinnedProcessors) {
+
+		return;
+
+	}
+
+	int last = PROCESSORS() - 1;
+	DWORD_PTR mask = 0;
+
+	lastProcessor = (lastProcessor < last) ? lastProcessor : last;
+
+	for (int i = firstProcessor; i <= lastProcessor; i++) {
+
+		mask |= PROCESSOR_MASK(i);
+
+	}
+
+	thread.SetAffinity(mask);
+
+}
+
+void IO::CreateElevatorDataPools() {
+
+	_fleetDataPool = new CDataPool(_config.objectPrefix + "FleetDatapool", sizeof(fleetDataPoolData));
+	((fleetDataPoolData*)(_fleetDataPool->LinkDataPool()))->numOfElevators = _numOfElevators;
+
+	// Room for every elevator that could be added, so the vector never moves
+	// while the render thread reads it
+	_elevatorDataPoolPtrs.reserve(maxElevators);
+
+	for (int i = 0; i < _numOfElevators; i++) {
+
+		CreateElevatorStatus(i);
+
+	}
+
+	// The dispatcher finds the elevators where they start before the first frame
+	fleetDataPoolData *fleet = (fleetDataPoolData*)_fleetDataPool->LinkDataPool();
+	_snapshot = new FleetSnapshot(fleet);
+	_snapshot->Publish(fleet->elevators, _numOfElevators);
+
+	_fleetReady = new CRendezvous(_config.objectPrefix + "FleetReady", fleetReadyThreads(_numOfElevators));
+
+}
+
+void IO::CreateElevatorStatus(int elevator) {
+
+	dataPoolData *status = &((fleetDataPoolData*)(_fleetDataPool->LinkDataPool()))->elevators[elevator];
+
+	status->direction = NODIR;
+	status->doorStatus = CLOSED;
+	status->movingStatus = IDLE;
+	status->serviceStatus = NOFAULT;
+	status->currentFloorNumber = 0;
+	status->desiredFloorNumber = 0;
+	_elevatorDataPoolPtrs.push_back(status);
+
+}
+
+bool IO::AddElevator() {
+
+	int elevator = _numOfElevators;
+
+	// The fleet table of a dispatcher in another process is out of reach
+	if (_dispatcher == NULL || elevator >= maxElevators) {
+
+		LOG_EVENTF("cannot add elevator %d, the fleet is full or the dispatcher is a process", elevator);
+		return false;
+
+	}
+
+	CreateElevatorStatus(elevator);
+	CreateElevatorSemaphores(elevator);
+
+	// The dispatcher makes the pipes before the elevator opens them, and
+	// anything it sends before the elevator starts waits in them
+	if (!_dispatcher->AddElevator(elevator)) {
+
+		LOG_EVENTF("cannot add elevator %d, the dispatcher refused it", elevator);
+
+		delete _IOElevatorSemaphoresP.back();
+		delete _IOElevatorSemaphoresC.back();
+		_IOElevatorSemaphoresP.pop_back();
+		_IOElevatorSemaphoresC.pop_back();
+		_elevatorDataPoolPtrs.pop_back();
+		return false;
+
+	}
+
+	((fleetDataPoolData*)(_fleetDataPool->LinkDataPool()))->numOfElevators = elevator + 1;
+
+	_elevators.push_back(new Elevator(elevator, _config.objectPrefix, false, _fleetDeadlines));
+	PlaceThread(*_elevators[elevator], _config.elevatorPriority, 2, PROCESSORS() - 1);
+	_elevators[elevator]->Resume();
+
+	// The render thread only looks at the new elevator once everything it
+	// uses is there
+	InterlockedExchange((volatile LONG*)&_numOfElevators, elevator + 1);
+	_inputReader->SetNumOfElevators(elevator + 1);
+
+	return true;
+
+}
+
+bool IO::RemoveElevator(int elevator) {
+
+	if (_dispatcher == NULL || !_dispatcher->RemoveElevator(elevator)) {
+
+		LOG_EVENTF("cannot remove elevator %d, it is not in service or the dispatcher is a process", elevator);
+		return false;
+
+	}
+
+	return true;
+
+}
+
+void IO::CreateDispatcher() {
+
+	_dispatcher = new Dispatcher(_numOfElevators, _config.objectPrefix, _config.overflowPolicy);
+
+}
+
+void IO::CreateSemaphores(){
+
+	_IOElevatorSemaphoresP.reserve(maxElevators);
+	_IOElevatorSemaphoresC.reserve(maxElevators);
+
+	for (int i = 0; i < _numOfElevators; i++) {
+
+		CreateElevatorSemaphores(i);
+
+	}
+
+}
+
+void IO::CreateElevatorSemaphores(int elevator) {
+
+	_IOElevatorSemaphoresP.push_back(new CSemaphore(_config.objectPrefix + "IOElevatorSemaphoreP" + itos(elevator), 0));
+	_IOElevatorSemaphoresC.push_back(new CSemaphore(_config.objectPrefix + "IOElevatorSemaphoreC" + itos(elevator), 1));
+
+}
+
+int IO::PollForUserInput(void *ThreadArgs) {
+
+	commandBatch batch;
+
+	while (!_inputReader->Terminated() && !_inputReader->EndOfInput() && !_inputThread->TerminateStatus()) {
+
+		if (_inputReader->Read(batch) == 0) {
+
+			_inputThread->WaitForTerminate(inputPollPeriod);
+			continue;
+
+		}
+
+		bool accepted = PostUserCommands(batch);
+		batch.Clear();
+
+		// Show the command on the next frame without touching the display here.
+		// The sequence is odd while the echo is being written
+		InterlockedIncrement(&_commandEchoSequence);
+		strcpy_s(_commandEcho, accepted ? _inputReader->LastCommand() : refusedCommandEcho);
+		InterlockedIncrement(&_commandEchoSequence);
+
+	}
+
+	if (_traceWriter != NULL) {
+
+		_traceWriter->Flush();
+
+	}
+
+	return 0;
+	
+}
+
+bool IO::PostUserCommands(const commandBatch &batch) {
+
+	bool accepted = true;
+
+	for (size_t i = 0; i < batch.fleetChanges.size(); i++) {
+
+		if (batch.fleetChanges[i].faultType == ADDED) {
+
+			accepted = AddElevator() && accepted;
+
+		}
+		else {
+
+			accepted = RemoveElevator(batch.fleetChanges[i].elevatorNumber) && accepted;
+
+		}
+
+	}
+
+	if (_traceWriter != NULL) {
+
+		_traceWriter->Write(GET_TIME_US() - _startTime, batch);
+
+	}
+
+	batch.Post(_pipeOutside, _pipeInside, _faultPipe, *_inputThread);
+
+	return accepted;
+
+}
+
+void IO::InitializeDisplay() {
+
+	_displaySemaphore.Wait();
+
+	SET_CONSOLE_BACKEND(consoleBackend);
+
+	PrintTitle();
+
+	for (int i = 0; i < 10; i++){
+
+		MOVE_CURSOR(0, i * columnSpacing + columnSpacing + 10);
+		CONSOLE() << 10 - i - 1;
+
+	}
+
+	int x = 5 + _numOfElevators * rowSpacing;
+	int y = 10 * columnSpacing - 10 * columnSpacing - 2 + 10;
+
+	// Display elevators
+	TEXT_COLOUR(0, 14);
+	for (int i = 0; i < _numOfElevators; i++){
+
+		for (int j = 0; j < x; j++) {
+
+			MOVE_CURSOR(50, 100);
+			CONSOLE() << " ";
+
+		}
+
+	}
+	FLUSH_CONSOLE();
+	_displaySemaphore.Signal();
+
+}
+
+void IO::UpdateDisplays() {
+
+	_displaySemaphore.Wait();
+	CURSOR_OFF();
+	FLUSH_CONSOLE();
+	_displaySemaphore.Signal();
+
+	// Sized for every elevator that could be added while the render thread runs
+	_frame.resize(maxElevators);
+	_frameChanged.resize(maxElevators, false);
+
+	_renderThread = new ClassThread <IO>(this, &IO::RenderDisplay, SUSPENDED, NULL);
+	PlaceThread(*_renderThread, _config.displayPriority, 0, 0);
+	_renderThread->Resume();
+
+}
+
+int IO::RenderDisplay(void *ThreadArgs) {
+
+	// Keep collecting until told to stop, as an elevator cannot stop while
+	// it is waiting for its state to be collected
+	while (!_renderThread->TerminateStatus()) {
+
+		_renderThread->WaitForTerminate(framePeriod);
+
+		int numOfElevators = _numOfElevators;
+
+		// One snapshot of the whole fleet per frame, for the dispatcher. Taken
+		// before the states are collected, when every elevator let go at the
+		// last frame has made its change and is waiting to be collected again
+		_snapshot->Publish(((fleetDataPoolData*)_fleetDataPool->LinkDataPool())->elevators, numOfElevators);
+
+		// Collect the state of every elevator that changed since the last frame
+		// and let it carry on while we draw
+		for (int elevator = 0; elevator < numOfElevators; elevator++) {
+
+			_frameChanged[elevator] = (_IOElevatorSemaphoresC[elevator]->Wait(0) == WAIT_OBJECT_0);
+
+			if (_frameChanged[elevator]) {
+
+				_frame[elevator] = *_elevatorDataPoolPtrs[elevator];
+				_IOElevatorSemaphoresP[elevator]->Signal();
+
+			}
+
+		}
+
+		_displaySemaphore.Wait();
+
+		for (int elevator = 0; elevator < numOfElevators; elevator++) {
+
+			if (_frameChanged[elevator]) {
+
+				UpdateDisplay(elevator);
+
+			}
+
+		}
+
+		PrintGetUserCommand();
+		PrintUserCommand();
+
+		FLUSH_CONSOLE();
+		_displaySemaphore.Signal();
+
+	}
+	
+	return 0;
+
+}
+
+void IO::UpdateDisplay(int elevator) {
+
+	int floorNum = _frame[elevator].currentFloorNumber;
+	int x = 5 + elevator * rowSpacing;
+	int y = 10 * columnSpacing - floorNum * columnSpacing - 2 + 10;
+
+	Erase(x);
+	UpdateElevator(elevator, x, y);
+	UpdateElevatorDirection(elevator, x);
+
+}
+
+void IO::Erase(int x) {
+
+	// Erase
+	TEXT_COLOUR(15, 0);
+	for (int i = 0; i < 10; i++){
+
+		for (int j = 0; j < 5; j++) {
+
+			for (int k = 0; k < 4; k++) {
+
+				MOVE_CURSOR(x + j, 10 * columnSpacing - 2 - i * columnSpacing + k + 10);
+				CONSOLE() << " ";
+
+			}
+
+		}
+
+	}
+
+}
+
+void IO::UpdateElevator(int elevator, int x, int y) {
+
+	// Move elevator
+	if (_frame[elevator].doorStatus != OPEN) {
+
+		int textColour;
+
+		if (_frame[elevator].serviceStatus == FAULT) {
+
+			textColour = 12;
+
+		}
+		else {
+
+			textColour = 10;
+
+		}
+
+		TEXT_COLOUR(0, textColour);
+		for (int j = 0; j < 5; j++) {
+
+			for (int k = 0; k < 4; k++) {
+
+				MOVE_CURSOR(x + j, y + k);
+				CONSOLE() << " ";
+
+			}
+
+		}
+
+	}
+	else {
+
+		// Open the door
+		TEXT_COLOUR(0, 10);
+		for (int j = 0; j < 5; j++) {
+
+			for (int k = 0; k < 4; k++) {
+
+				MOVE_CURSOR(x + j, y + k);
+				CONSOLE() << " ";
+
+			}
+
+		}
+		TEXT_COLOUR(15, 0);
+		for (int j = 1; j < 4; j++) {
+
+			for (int k = 1; k < 4; k++) {
+
+				MOVE_CURSOR(x + j, y + k);
+				CONSOLE() << " ";
+
+			}
+
+		}
+
+	}
+
+}
+
+void IO::UpdateElevatorDirection(int elevator, int x) {
+
+	if (_frame[elevator].direction == UP) {
+		TEXT_COLOUR(14, 0);
+		MOVE_CURSOR(x + 1, 8);
+		CONSOLE() << " /\\";
+		MOVE_CURSOR(x + 1, 9);
+		CONSOLE() << "/||\\";
+		MOVE_CURSOR(x + 1, 10);
+		CONSOLE() << " || ";
+	}
+	else if (_frame[elevator].direction == DOWN) {
+		TEXT_COLOUR(14, 0);
+		MOVE_CURSOR(x + 1, 8);
+		CONSOLE() << " ||";
+		MOVE_CURSOR(x + 1, 9);
+		CONSOLE() << "\\||/";
+		MOVE_CURSOR(x + 1, 10);
+		CONSOLE() << " \\/";
+	}
+	else {
+
+		TEXT_COLOUR(14, 0);
+		MOVE_CURSOR(x + 1, 8);
+		CONSOLE() << "     ";
+		MOVE_CURSOR(x + 1, 9);
+		CONSOLE() << "     ";
+		MOVE_CURSOR(x + 1, 10);
+		CONSOLE() << "     ";
+
+	}
+
+}
+
+void IO::PrintGetUserCommand() {
+
+	TEXT_COLOUR(15, 0);
+	MOVE_CURSOR(0, 55);
+	CONSOLE() << "Enter elevator command:";
+
+}
+
+void IO::PrintUserCommand() {
+
+	char command[commandLength];
+	LONG sequence;
+
+	// Copied again if the input thread wrote it meanwhile, as two commands in
+	// one frame would otherwise show half of each
+	do {
+
+		sequence = _commandEchoSequence;
+		MemoryBarrier();
+		memcpy(command, _commandEcho, commandLength);
+		MemoryBarrier();
+
+	} while ((sequence & 1) || _commandEchoSequence != sequence);
+
+	command[commandLength - 1] = '\0';
+
+	TEXT_COLOUR(15, 0);
+	MOVE_CURSOR(24, 55);
+	CONSOLE() << command << "        "; // Clear any longer command shown before
+
+}
+
+void IO::PrintTitle() {
+
+	MOVE_CURSOR(0, 0);
+
+	const char* title =
+		" _______  __   __  _______  _______  ______      _______  ___   __   __  _______    _______  _______  _______  _______ \n"
+		"|       ||  | |  ||       ||       ||    _ |    |       ||   | |  |_|  ||       |  |       ||  _    ||  _    ||  _    |\n"
+		"|  _____||  | |  ||    _  ||    ___||   | ||    |  _____||   | |       ||  _____|  |____   || | |   || | |   || | |   |\n"
+		"| |_____ |  |_|  ||   |_| ||   |___ |   |_||_   | |_____ |   | |       || |_____    ____|  || | |   || | |   || | |   |\n"
+		"|_____  ||       ||    ___||    ___||    __  |  |_____  ||   | |       ||_____  |  | ______|| |_|   || |_|   || |_|   |\n"
+		" _____| ||       ||   |    |   |___ |   |  | |   _____| ||   | | ||_|| | _____| |  | |_____ |       ||       ||       |\n"
+		"|_______||_______||___|    |_______||___|  |_|  |_______||___| |_|   |_||_______|  |_______||_______||_______||_______|\n";
+	
+	TEXT_COLOUR(12, 0);
+	CONSOLE() << title << endl;
+
+}
+
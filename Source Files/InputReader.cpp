@@ -0,0 +1,422 @@
+#include "InputReader.h"
+
+#include <cctype>
+#include <cstring>
+#include <iostream>
+
+using namespace std;
+
+template <class T>
+static bool PostMessages(CTypedMessageQueue<T> &queue, const vector<T> &messages, const ActiveClass &poster) {
+
+	for (size_t i = 0; i < messages.size(); i++) {
+
+		while (!queue.Write(&messages[i], pollPeriod)) {
+
+			if (poster.TerminateStatus()) {
+
+				return false;
+
+			}
+
+		}
+
+	}
+
+	return true;
+
+}
+
+bool commandBatch::Post(outsideCallQueue &pipeOutside, insideCallQueue &pipeInside, faultQueue &faultPipe, const ActiveClass &poster) const {
+
+	return PostMessages(pipeOutside, outsideCalls, poster) &&
+		PostMessages(pipeInside, insideCalls, poster) &&
+		PostMessages(faultPipe, faults, poster);
+
+}
+
+InputReader::InputReader(int numOfElevators) :
+	_numOfElevators(numOfElevators),
+	_input(GET_STDIN()),
+	_ownsInput(false),
+	_terminated(false),
+	_endOfInput(false),
+	_tokenLength(0) {
+
+	_inputType = GetFileType(_input);
+	_token[0] = '\0';
+	_lastCommand[0] = '\0';
+
+}
+
+InputReader::InputReader(int numOfElevators, const std::string &fileName) :
+	_numOfElevators(numOfElevators),
+	_ownsInput(true),
+	_inputType(FILE_TYPE_DISK),
+	_terminated(false),
+	_endOfInput(false),
+	_tokenLength(0) {
+
+	_input = CreateFile(fileName.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+	PERR(_input != INVALID_HANDLE_VALUE, string("Cannot Open Input File: ") + fileName);
+
+	if (_input == INVALID_HANDLE_VALUE) {
+
+		_ownsInput = false;
+		_endOfInput = true;
+
+	}
+
+	_token[0] = '\0';
+	_lastCommand[0] = '\0';
+
+}
+
+InputReader::~InputReader() {
+
+	if (_ownsInput) {
+
+		CloseHandle(_input);
+
+	}
+
+}
+
+int InputReader::Read(commandBatch &batch) {
+
+	if (_terminated || _endOfInput) {
+
+		return 0;
+
+	}
+
+	int bytesRead = ReadBufferedStream();
+
+	if (bytesRead == 0) {
+
+		bytesRead = ReadAvailable();
+
+	}
+
+	int commands = Parse(_buffer, bytesRead, batch);
+
+	// The last command of a pipe or file does not need a separator after it
+	if (_endOfInput && _tokenLength > 0 && !_terminated) {
+
+		if (ParseToken(batch)) {
+
+			commands++;
+
+		}
+
+		_tokenLength = 0;
+
+	}
+
+	return commands;
+
+}
+
+int InputReader::Parse(const char *data, int size, commandBatch &batch) {
+
+	int commands = 0;
+
+	for (int i = 0; i < size && !_terminated; i++) {
+
+		char c = data[i];
+
+		if (c == ' ' || c == '\t' || c == '\r' || c == '\n' || c == ',' || c == ';') {
+
+			if (_tokenLength > 0 && ParseToken(batch)) {
+
+				commands++;
+
+			}
+
+			_tokenLength = 0;
+			continue;
+
+		}
+
+		_token[_tokenLength++] = c;
+		_token[_tokenLength] = '\0';
+
+		// Take the command as soon as it is complete, or give up on it if it
+		// is too long to be valid
+		if (TokenComplete() || _tokenLength == commandLength - 1) {
+
+			if (ParseToken(batch)) {
+
+				commands++;
+
+			}
+
+			_tokenLength = 0;
+
+		}
+
+	}
+
+	return commands;
+
+}
+
+int InputReader::ReadBufferedStream() {
+
+	if (_ownsInput) {
+
+		return 0;
+
+	}
+
+	streambuf *buffer = cin.rdbuf();
+	streamsize available = buffer->in_avail();
+
+	if (available <= 0) {
+
+		return 0;
+
+	}
+
+	if (available > inputBufferSize) {
+
+		available = inputBufferSize;
+
+	}
+
+	return (int)buffer->sgetn(_buffer, available);
+
+}
+
+int InputReader::ReadAvailable() {
+
+	DWORD bytesRead = 0;
+
+	if (_inputType == FILE_TYPE_CHAR) {
+
+		// Keyboard: take every key that has already been pressed
+		while (bytesRead < inputBufferSize && TEST_FOR_KEYBOARD()) {
+
+			_buffer[bytesRead++] = (char)_getch();
+
+		}
+
+	}
+	else if (_inputType == FILE_TYPE_PIPE) {
+
+		// Pipe: only read what is there so ReadFile does not block
+		DWORD available = 0;
+
+		if (!PeekNamedPipe(_input, NULL, 0, NULL, &available, NULL)) {
+
+			_endOfInput = true; // The writing end has been closed
+
+		}
+		else if (available > 0) {
+
+			if (available > inputBufferSize) {
+
+				available = inputBufferSize;
+
+			}
+
+			ReadFile(_input, _buffer, available, &bytesRead, NULL);
+
+		}
+
+	}
+	else {
+
+		// File: reads never wait for more data, zero bytes means the end of the file
+		if (!ReadFile(_input, _buffer, inputBufferSize, &bytesRead, NULL) || bytesRead == 0) {
+
+			_endOfInput = true;
+
+		}
+
+	}
+
+	return (int)bytesRead;
+
+}
+
+bool InputReader::TokenComplete() const {
+
+	if (_token[0] == 'e') {
+
+		return _tokenLength == 2;
+
+	}
+
+	if (_token[0] == ADDED) {
+
+		return true;
+
+	}
+
+	if (_token[0] == REMOVED) {
+
+		return NumberComplete(_token + 1, _numOfElevators);
+
+	}
+
+	if (_token[0] == UP || _token[0] == DOWN) {
+
+		return NumberComplete(_token + 1, numOfFloors);
+
+	}
+
+	if (_token[0] == '+' || _token[0] == '-') {
+
+		return NumberComplete(_token + 1, _numOfElevators);
+
+	}
+
+	const char *colon = strchr(_token, ':');
+
+	if (colon != NULL) {
+
+		return NumberComplete(colon + 1, numOfFloors);
+
+	}
+
+	// Two digits on their own are only unambiguous when every elevator and
+	// floor number is a single digit
+	return _tokenLength == 2 && _numOfElevators <= 10 && numOfFloors <= 10;
+
+}
+
+bool InputReader::ParseToken(commandBatch &batch) {
+
+	int number;
+	int floor;
+
+	if (strcmp(_token, "ee") == 0) {
+
+		faultElevatorData fault;
+		fault.faultType = TERMINATED;
+		fault.elevatorNumber = 0;
+		batch.faults.push_back(fault);
+		_terminated = true;
+
+	}
+	else if (strcmp(_token, "a") == 0) {
+
+		faultElevatorData change;
+		change.faultType = ADDED;
+		change.elevatorNumber = 0;
+		batch.fleetChanges.push_back(change);
+
+	}
+	else if (_token[0] == REMOVED && ParseNumber(_token + 1, _numOfElevators, number)) {
+
+		faultElevatorData change;
+		change.faultType = REMOVED;
+		change.elevatorNumber = number;
+		batch.fleetChanges.push_back(change);
+
+	}
+	else if ((_token[0] == UP || _token[0] == DOWN) && ParseNumber(_token + 1, numOfFloors, floor)) {
+
+		outsideElevatorData elevatorCall;
+		elevatorCall.direction = _token[0];
+		elevatorCall.currentFloorNumber = floor;
+		batch.outsideCalls.push_back(elevatorCall);
+
+	}
+	else if ((_token[0] == '+' || _token[0] == '-') && ParseNumber(_token + 1, _numOfElevators, number)) {
+
+		faultElevatorData fault;
+		fault.faultType = (_token[0] == '-') ? FAULT : NOFAULT;
+		fault.elevatorNumber = number;
+		batch.faults.push_back(fault);
+
+	}
+	else if (strchr(_token, ':') != NULL) {
+
+		char car[commandLength];
+		int carLength = (int)(strchr(_token, ':') - _token);
+
+		memcpy(car, _token, carLength);
+		car[carLength] = '\0';
+
+		if (!ParseNumber(car, _numOfElevators, number) || !ParseNumber(_token + carLength + 1, numOfFloors, floor)) {
+
+			return false;
+
+		}
+
+		insideElevatorData elevatorDestination;
+		elevatorDestination.currentElevatorNumber = number;
+		elevatorDestination.desiredFloorNumber = floor;
+		batch.insideCalls.push_back(elevatorDestination);
+
+	}
+	else if (_tokenLength == 2 && isdigit(_token[0]) && isdigit(_token[1])
+		&& _token[0] - '0' < _numOfElevators && _token[1] - '0' < numOfFloors) {
+
+		insideElevatorData elevatorDestination;
+		elevatorDestination.currentElevatorNumber = _token[0] - '0';
+		elevatorDestination.desiredFloorNumber = _token[1] - '0';
+		batch.insideCalls.push_back(elevatorDestination);
+
+	}
+	else {
+
+		return false;
+
+	}
+
+	strcpy_s(_lastCommand, _token);
+
+	return true;
+
+}
+
+bool InputReader::ParseNumber(const char *text, int limit, int &number) {
+
+	// No empty numbers and no leading zeros
+	if (text[0] == '\0' || (text[0] == '0' && text[1] != '\0')) {
+
+		return false;
+
+	}
+
+	number = 0;
+
+	for (int i = 0; text[i] != '\0'; i++) {
+
+		if (!isdigit(text[i])) {
+
+			return false;
+
+		}
+
+		number = number * 10 + (text[i] - '0');
+
+		if (number >= limit) {
+
+			return false;
+
+		}
+
+	}
+
+	return true;
+
+}
+
+bool InputReader::NumberComplete(const char *text, int limit) {
+
+	int number;
+
+	if (!ParseNumber(text, limit, number)) {
+
+		// Complete if it is already invalid, so it gets thrown away
+		return text[0] != '\0';
+
+	}
+
+	return number == 0 || number * 10 >= limit;
+
+}
@@ -0,0 +1,157 @@
+#include "ProcessGroup.h"
+#include "Dispatcher.h"
+#include "Elevator.h"
+#include "stringcat.h"
+
+#include <cstdlib>
+#include <cstring>
+
+using namespace std;
+
+ProcessGroup::ProcessGroup(const std::string &executable, const std::string &prefix, int affinity) :
+	_executable(executable),
+	_prefix(prefix),
+	_affinity(affinity),
+	_stopEvent(prefix + "ProcessStop") {
+
+}
+
+ProcessGroup::~ProcessGroup() {
+
+	_stopEvent.Signal();
+
+	for (size_t i = 0; i < _processes.size(); i++) {
+
+		if (_processes[i]->WaitForProcess(processExitTimeout) != WAIT_OBJECT_0) {
+
+			::TerminateProcess(_processes[i]->GetProcessHandle(), 1);
+
+		}
+
+		CloseHandle(_processes[i]->GetThreadHandle());
+		CloseHandle(_processes[i]->GetProcessHandle());
+		delete _processes[i];
+
+	}
+
+}
+
+void ProcessGroup::StartDispatcher(int numOfElevators) {
+
+	Start("-dispatcher " + itos(numOfElevators) + " " + itos((int)GetCurrentProcessId()) + " \"" + _prefix + "\"");
+
+}
+
+void ProcessGroup::StartElevators(int first, int count) {
+
+	Start("-elevators " + itos(first) + " " + itos(count) + " " + itos((int)GetCurrentProcessId()) + " \"" + _prefix + "\"");
+
+}
+
+void ProcessGroup::Start(const std::string &arguments) {
+
+	CProcess *process = new CProcess(_executable, NORMAL_PRIORITY_CLASS, PARENT_WINDOW, SUSPENDED, arguments);
+	int index = (int)_processes.size();
+
+	if (_affinity == coreAffinity) {
+
+		process->SetAffinity(PROCESSOR_MASK(index + 1));
+
+	}
+	else if (_affinity == numaAffinity) {
+
+		process->SetAffinity(NUMA_NODE_MASK(index));
+
+	}
+
+	process->Resume();
+	_processes.push_back(process);
+
+}
+
+bool ProcessGroup::RunChild(int argc, char *argv[]) {
+
+	bool dispatcher = (argc == 5 && strcmp(argv[1], "-dispatcher") == 0);
+	bool elevators = (argc == 6 && strcmp(argv[1], "-elevators") == 0);
+
+	if (!dispatcher && !elevators) {
+
+		return false;
+
+	}
+
+	DWORD parentId = (DWORD)atoi(argv[argc - 2]);
+	string prefix = argv[argc - 1];
+	vector<ActiveClass*> children;
+
+	if (dispatcher) {
+
+		children.push_back(new Dispatcher(atoi(argv[2]), prefix));
+
+	}
+	else {
+
+		for (int i = 0; i < atoi(argv[3]); i++) {
+
+			children.push_back(new Elevator(atoi(argv[2]) + i, prefix));
+
+		}
+
+	}
+
+	for (size_t i = 0; i < children.size(); i++) {
+
+		children[i]->Resume();
+
+	}
+
+	// Run until the group is deleted, or the parent has gone and nobody will
+	HANDLE parent = OpenProcess(SYNCHRONIZE, FALSE, parentId);
+	CEvent stopEvent(prefix + "ProcessStop");
+
+	while (stopEvent.Wait(processCheckPeriod) == WAIT_TIMEOUT) {
+
+		if (parent == NULL || WaitForSingleObject(parent, 0) == WAIT_OBJECT_0) {
+
+			break;
+
+		}
+
+	}
+
+	for (size_t i = 0; i < children.size(); i++) {
+
+		children[i]->RequestTerminate();
+
+	}
+
+	// Once IO has gone nobody collects the elevators' states, so let an
+	// elevator waiting for that take its step and find it has to stop
+	for (int i = 0; elevators && i < atoi(argv[3]); i++) {
+
+		CSemaphore step(prefix + "IOElevatorSemaphoreP" + itos(atoi(argv[2]) + i), 0);
+		step.Signal();
+
+	}
+
+	for (size_t i = 0; i < children.size(); i++) {
+
+		// One still running is left for the end of the process to stop, as
+		// deleting it would free what it is using
+		if (children[i]->WaitForThread(processExitTimeout) == WAIT_OBJECT_0) {
+
+			delete children[i];
+
+		}
+
+	}
+
+	if (parent != NULL) {
+
+		CloseHandle(parent);
+
+	}
+
+	return true;
+
+}
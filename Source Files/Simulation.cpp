@@ -0,0 +1,413 @@
+#include "Simulation.h"
+#include "stringcat.h"
+
+#include <cmath>
+
+using namespace std;
+
+void waitTimeHistogram::Add(double waitTime) {
+
+	int bucket = (int)waitTime;
+
+	if (bucket >= waitTimeBuckets) {
+
+		bucket = waitTimeBuckets - 1;
+
+	}
+
+	buckets[bucket]++;
+	passengers++;
+	totalWait += waitTime;
+
+	if (waitTime > maxWait) {
+
+		maxWait = waitTime;
+
+	}
+
+}
+
+void waitTimeHistogram::Merge(const waitTimeHistogram &o) {
+
+	for (int i = 0; i < waitTimeBuckets; i++) {
+
+		buckets[i] += o.buckets[i];
+
+	}
+
+	passengers += o.passengers;
+	unserved += o.unserved;
+	totalWait += o.totalWait;
+
+	if (o.maxWait > maxWait) {
+
+		maxWait = o.maxWait;
+
+	}
+
+}
+
+double waitTimeHistogram::Mean() const {
+
+	return (passengers > 0) ? totalWait / passengers : 0;
+
+}
+
+double waitTimeHistogram::Percentile(double fraction) const {
+
+	int count = 0;
+
+	for (int i = 0; i < waitTimeBuckets; i++) {
+
+		count += buckets[i];
+
+		if (count > 0 && count >= fraction * passengers) {
+
+			return (i == waitTimeBuckets - 1) ? maxWait : i + 1;
+
+		}
+
+	}
+
+	return 0;
+
+}
+
+Simulation::Simulation(const simulationParameters &parameters, const std::string &prefix) :
+	_parameters(parameters),
+	_prefix(prefix),
+	_pipeOutside(prefix + "PipeOutside", dispatcherQueueSize),
+	_pipeInside(prefix + "PipeInside", dispatcherQueueSize),
+	_faultPipe(prefix + "FaultPipe", dispatcherQueueSize),
+	_dispatcher(NULL),
+	_fleetDeadlines(NULL),
+	_hotPathAllocations(ALLOCATIONS_NOT_COUNTED),
+	_fleetDataPool(NULL),
+	_fleetReady(NULL),
+	_snapshot(NULL),
+	_retryTimers(NULL) {
+
+	for (int floor = 0; floor < numOfFloors; floor++) {
+
+		for (int i = 0; i < 2; i++) {
+
+			hallButton button;
+			button.simulation = this;
+			button.floor = floor;
+			button.direction = (i == 0) ? UP : DOWN;
+			button.waiting = 0;
+			button.retry = 0;
+			_hallButtons.push_back(button);
+
+		}
+
+	}
+
+	PERR(_parameters.numOfElevators >= 1 && _parameters.numOfElevators <= maxElevators, "Number of Elevators Must be 1 to " + itos(maxElevators));
+
+	if (_parameters.numOfElevators < 1) {
+
+		_parameters.numOfElevators = 1;
+
+	}
+	else if (_parameters.numOfElevators > maxElevators) {
+
+		_parameters.numOfElevators = maxElevators;
+
+	}
+
+}
+
+Simulation::~Simulation() {
+
+}
+
+int Simulation::main(void) {
+
+	CreateElevatorSystem();
+
+	ULONGLONG endOfDay = GET_TIME_US() + (ULONGLONG)_parameters.dayLength * 1000000;
+	_retryTimers = new CTimerWheel(1000);
+
+	while (GET_TIME_US() < endOfDay) {
+
+		SLEEP(simulationStep);
+
+		CollectElevatorStates();
+
+		for (int elevator = 0; elevator < _parameters.numOfElevators; elevator++) {
+
+			BoardPassengers(elevator);
+
+		}
+
+		GeneratePassengers();
+		_retryTimers->Advance();
+
+		_batch.Post(_pipeOutside, _pipeInside, _faultPipe, *this);
+		_batch.Clear();
+
+	}
+
+	_waitTimes.unserved += (int)_waiting.size();
+
+	delete _retryTimers;
+	_retryTimers = NULL;
+
+	DestroyElevatorSystem();
+
+	return 0;
+
+}
+
+void Simulation::CreateElevatorSystem() {
+
+	// Everything the elevators share is set up before any of them is made
+	_fleetDataPool = new CDataPool(_prefix + "FleetDatapool", sizeof(fleetDataPoolData));
+	fleetDataPoolData *fleet = (fleetDataPoolData*)(_fleetDataPool->LinkDataPool());
+	fleet->numOfElevators = _parameters.numOfElevators;
+
+	for (int i = 0; i < _parameters.numOfElevators; i++) {
+
+		_elevatorDataPoolPtrs.push_back(&fleet->elevators[i]);
+		_elevatorDataPoolPtrs[i]->direction = NODIR;
+		_elevatorDataPoolPtrs[i]->doorStatus = CLOSED;
+		_elevatorDataPoolPtrs[i]->movingStatus = IDLE;
+		_elevatorDataPoolPtrs[i]->serviceStatus = NOFAULT;
+		_elevatorDataPoolPtrs[i]->currentFloorNumber = 0;
+		_elevatorDataPoolPtrs[i]->desiredFloorNumber = 0;
+
+		_IOElevatorSemaphoresP.push_back(new CSemaphore(_prefix + "IOElevatorSemaphoreP" + itos(i), 0));
+		_IOElevatorSemaphoresC.push_back(new CSemaphore(_prefix + "IOElevatorSemaphoreC" + itos(i), 1));
+
+		_state.push_back(*_elevatorDataPoolPtrs[i]);
+		_stopServed.push_back(false);
+
+	}
+
+	_snapshot = new FleetSnapshot(fleet);
+	_snapshot->Publish(fleet->elevators, _parameters.numOfElevators);
+
+	_fleetReady = new CRendezvous(_prefix + "FleetReady", fleetReadyThreads(_parameters.numOfElevators));
+
+	_fleetDeadlines = new FleetDeadlines(_prefix);
+
+	for (int i = 0; i < _parameters.numOfElevators; i++) {
+
+		_elevators.push_back(new Elevator(i, _prefix, true, _fleetDeadlines));
+
+	}
+
+	_dispatcher = new Dispatcher(_parameters.numOfElevators, _prefix);
+	_fleetDeadlines->Resume();
+
+	for (int i = 0; i < _parameters.numOfElevators; i++) {
+
+		_elevators[i]->Resume();
+
+	}
+
+	_dispatcher->Resume();
+	_fleetReady->Wait();
+
+}
+
+void Simulation::DestroyElevatorSystem() {
+
+	_dispatcher->RequestTerminate();
+
+	for (int i = 0; i < _parameters.numOfElevators; i++) {
+
+		_elevators[i]->RequestTerminate();
+
+	}
+
+	bool running = true;
+
+	while (running) {
+
+		CollectElevatorStates();
+
+		running = (_dispatcher->WaitForThread(0) != WAIT_OBJECT_0);
+
+		for (int i = 0; i < _parameters.numOfElevators; i++) {
+
+			running = running || (_elevators[i]->WaitForThread(0) != WAIT_OBJECT_0);
+
+		}
+
+		if (running) {
+
+			SLEEP(simulationStep);
+
+		}
+
+	}
+
+	// Only once no elevator is waiting for a deadline
+	_fleetDeadlines->Stop();
+	_fleetDeadlines->WaitForThread();
+
+	_hotPathAllocations = _dispatcher->Allocations();
+
+	for (int i = 0; i < _parameters.numOfElevators && _hotPathAllocations != ALLOCATIONS_NOT_COUNTED; i++) {
+
+		_hotPathAllocations += _elevators[i]->Allocations();
+
+	}
+
+	delete _dispatcher;
+	delete _fleetDeadlines;
+
+	for (int i = 0; i < _parameters.numOfElevators; i++) {
+
+		delete _elevators[i];
+		delete _IOElevatorSemaphoresP[i];
+		delete _IOElevatorSemaphoresC[i];
+
+	}
+
+	delete _fleetReady;
+	delete _snapshot;
+	delete _fleetDataPool;
+
+}
+
+void Simulation::CollectElevatorStates() {
+
+	// Published before collecting, when the elevators let go last time have
+	// made their change
+	_snapshot->Publish(((fleetDataPoolData*)_fleetDataPool->LinkDataPool())->elevators, _parameters.numOfElevators);
+
+	for (int elevator = 0; elevator < _parameters.numOfElevators; elevator++) {
+
+		if (_IOElevatorSemaphoresC[elevator]->Wait(0) == WAIT_OBJECT_0) {
+
+			_state[elevator] = *_elevatorDataPoolPtrs[elevator];
+			_IOElevatorSemaphoresP[elevator]->Signal();
+
+		}
+
+	}
+
+}
+
+void Simulation::BoardPassengers(int elevator) {
+
+	const dataPoolData &state = _state[elevator];
+
+	// Only a pickup leaves the elevator stopped with its doors open
+	if (state.doorStatus != OPEN || state.movingStatus != IDLE) {
+
+		_stopServed[elevator] = false;
+		return;
+
+	}
+
+	if (_stopServed[elevator]) {
+
+		return;
+
+	}
+
+	_stopServed[elevator] = true;
+
+	ULONGLONG now = GET_TIME_US();
+	insideElevatorData elevatorDestination;
+	elevatorDestination.currentElevatorNumber = elevator;
+	size_t stillWaiting = 0;
+
+	for (size_t i = 0; i < _waiting.size(); i++) {
+
+		const passenger &p = _waiting[i];
+
+		if (p.floor == state.currentFloorNumber && (state.direction == NODIR || state.direction == p.direction)) {
+
+			_waitTimes.Add((now - p.callTime) / 1000000.0);
+			elevatorDestination.desiredFloorNumber = p.destination;
+			_batch.insideCalls.push_back(elevatorDestination);
+
+			hallButton &button = HallButton(p.floor, p.direction);
+
+			if (--button.waiting == 0) {
+
+				_retryTimers->Cancel(button.retry);
+				button.retry = 0;
+
+			}
+
+		}
+		else {
+
+			_waiting[stillWaiting++] = p;
+
+		}
+
+	}
+
+	// Nobody got on, so let the elevator close its doors and carry on
+	if (stillWaiting == _waiting.size()) {
+
+		elevatorDestination.desiredFloorNumber = state.currentFloorNumber;
+		_batch.insideCalls.push_back(elevatorDestination);
+
+	}
+
+	_waiting.resize(stillWaiting);
+
+}
+
+void Simulation::GeneratePassengers() {
+
+	// Poisson arrivals with the mean number for one step
+	double limit = exp(-_parameters.arrivalRate / 60.0 * simulationStep / 1000.0);
+	double product = Uniform();
+	ULONGLONG now = GET_TIME_US();
+
+	while (product > limit) {
+
+		passenger p;
+		p.callTime = now;
+		p.floor = (int)(Uniform() * numOfFloors);
+		p.destination = (p.floor + 1 + (int)(Uniform() * (numOfFloors - 1))) % numOfFloors;
+		p.direction = (p.destination > p.floor) ? UP : DOWN;
+
+		// Only the first passenger waiting to go this way presses the button
+		hallButton &button = HallButton(p.floor, p.direction);
+
+		if (button.waiting++ == 0) {
+
+			PressHallCall(button);
+
+		}
+
+		_waiting.push_back(p);
+		product *= Uniform();
+
+	}
+
+}
+
+void Simulation::PressHallCall(hallButton &button) {
+
+	outsideElevatorData elevatorCall;
+	elevatorCall.direction = button.direction;
+	elevatorCall.currentFloorNumber = button.floor;
+	_batch.outsideCalls.push_back(elevatorCall);
+
+	button.retry = _retryTimers->Set((ULONGLONG)hallCallRetryPeriod * 1000, RetryHallCall, &button);
+
+}
+
+void Simulation::RetryHallCall(void *arg) {
+
+	hallButton *button = (hallButton*)arg;
+	button->simulation->PressHallCall(*button);
+
+}
+
+double Simulation::Uniform() {
+
+	return RANDOM() / 4294967296.0;
+
+}
@@ -0,0 +1,311 @@
+#include "TraceReplayer.h"
+
+#include <cctype>
+#include <cstring>
+
+using namespace std;
+
+TraceReplayer::TraceReplayer(int numOfElevators, const std::string &fileName, bool asFastAsPossible, const std::string &prefix) :
+	_numOfElevators(numOfElevators),
+	_fileName(fileName),
+	_asFastAsPossible(asFastAsPossible),
+	_pipeOutside(prefix + "PipeOutside", dispatcherQueueSize),
+	_pipeInside(prefix + "PipeInside", dispatcherQueueSize),
+	_faultPipe(prefix + "FaultPipe", dispatcherQueueSize),
+	_parser(numOfElevators),
+	_startTime(0),
+	_terminated(false),
+	_commandsReplayed(0) {
+
+}
+
+TraceReplayer::~TraceReplayer() {
+
+}
+
+int TraceReplayer::main(void) {
+
+	HANDLE file = CreateFile(_fileName.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+	PERR(file != INVALID_HANDLE_VALUE, string("Cannot Open Trace File: ") + _fileName);
+
+	if (file == INVALID_HANDLE_VALUE) {
+
+		return 0;
+
+	}
+
+	LARGE_INTEGER fileSize;
+	GetFileSizeEx(file, &fileSize);
+	ULONGLONG size = (ULONGLONG)fileSize.QuadPart;
+
+	// An empty file cannot be mapped and has nothing to replay anyway
+	HANDLE mapping = NULL;
+
+	if (size > 0) {
+
+		mapping = CreateFileMapping(file, NULL, PAGE_READONLY, 0, 0, NULL);
+		PERR(mapping != NULL, string("Cannot Map Trace File: ") + _fileName);
+
+	}
+
+	bool binary = false;
+	ULONGLONG offset = 0;
+
+	_startTime = GET_TIME_US();
+
+	while (mapping != NULL && offset < size && !_terminated && !TerminateStatus()) {
+
+		// Views start on a multiple of traceViewSize, which is a multiple of the
+		// allocation granularity and of the record size
+		ULONGLONG viewSize = (size - offset < traceViewSize) ? size - offset : traceViewSize;
+		const char *view = (const char*)MapViewOfFile(mapping, FILE_MAP_READ, (DWORD)(offset >> 32), (DWORD)(offset & 0xFFFFFFFF), (SIZE_T)viewSize);
+		PERR(view != NULL, string("Cannot Map View Of Trace File: ") + _fileName);
+
+		if (view == NULL) {
+
+			break;
+
+		}
+
+		ULONGLONG start = 0;
+
+		if (offset == 0) {
+
+			binary = viewSize >= sizeof(traceHeader) && memcmp(view, traceMagic, sizeof(traceMagic)) == 0;
+
+			if (binary) {
+
+				const traceHeader *header = (const traceHeader*)view;
+				PERR(header->version == traceVersion, string("Unknown Trace Version: ") + _fileName);
+
+				if (header->version != traceVersion) {
+
+					UnmapViewOfFile(view);
+					break;
+
+				}
+
+				start = sizeof(traceHeader);
+
+			}
+
+		}
+
+		if (binary) {
+
+			ReplayBinary(view + start, viewSize - start);
+
+		}
+		else {
+
+			ReplayText(view, viewSize);
+
+		}
+
+		UnmapViewOfFile(view);
+		offset += viewSize;
+
+	}
+
+	// The last line of a text trace does not need a new line after it
+	if (!binary && !_partialLine.empty() && !_terminated) {
+
+		ReplayLine(_partialLine.data(), _partialLine.size());
+
+	}
+
+	PostBatch();
+
+	if (mapping != NULL) {
+
+		CloseHandle(mapping);
+
+	}
+
+	CloseHandle(file);
+
+	return 0;
+
+}
+
+void TraceReplayer::ReplayBinary(const char *data, ULONGLONG size) {
+
+	const traceRecord *records = (const traceRecord*)data;
+	ULONGLONG count = size / sizeof(traceRecord); // A cut off last record is ignored
+
+	for (ULONGLONG i = 0; i < count && !_terminated && !TerminateStatus(); i++) {
+
+		ReplayRecord(records[i]);
+
+	}
+
+}
+
+void TraceReplayer::ReplayText(const char *data, ULONGLONG size) {
+
+	ULONGLONG lineStart = 0;
+
+	for (ULONGLONG i = 0; i < size && !_terminated && !TerminateStatus(); i++) {
+
+		if (data[i] != '\n') {
+
+			continue;
+
+		}
+
+		if (_partialLine.empty()) {
+
+			ReplayLine(data + lineStart, i - lineStart);
+
+		}
+		else {
+
+			// Finish the line that was cut off by the end of the previous view
+			_partialLine.append(data + lineStart, data + i);
+			ReplayLine(_partialLine.data(), _partialLine.size());
+			_partialLine.clear();
+
+		}
+
+		lineStart = i + 1;
+
+	}
+
+	if (!_terminated) {
+
+		_partialLine.append(data + lineStart, data + size);
+
+	}
+
+}
+
+void TraceReplayer::ReplayLine(const char *line, ULONGLONG length) {
+
+	ULONGLONG i = 0;
+
+	while (i < length && isspace((unsigned char)line[i])) {
+
+		i++;
+
+	}
+
+	if (i == length || line[i] == '#' || !isdigit((unsigned char)line[i])) {
+
+		return;
+
+	}
+
+	ULONGLONG time = 0;
+
+	while (i < length && isdigit((unsigned char)line[i])) {
+
+		time = time * 10 + (line[i] - '0');
+		i++;
+
+	}
+
+	WaitUntil(time * 1000);
+
+	// The new line ends the last command on the line
+	int commands = _parser.Parse(line + i, (int)(length - i), _batch);
+	commands += _parser.Parse("\n", 1, _batch);
+
+	_commandsReplayed += commands;
+	_terminated = _parser.Terminated();
+
+	CheckBatch();
+
+}
+
+void TraceReplayer::ReplayRecord(const traceRecord &record) {
+
+	bool validFloor = record.floor >= 0 && record.floor < numOfFloors;
+	bool validElevator = record.elevatorNumber >= 0 && record.elevatorNumber < _numOfElevators;
+
+	WaitUntil(record.time);
+
+	if (record.type == HALLCALL && (record.command == UP || record.command == DOWN) && validFloor) {
+
+		outsideElevatorData elevatorCall;
+		elevatorCall.direction = record.command;
+		elevatorCall.currentFloorNumber = record.floor;
+		_batch.outsideCalls.push_back(elevatorCall);
+
+	}
+	else if (record.type == CARCALL && validElevator && validFloor) {
+
+		insideElevatorData elevatorDestination;
+		elevatorDestination.currentElevatorNumber = record.elevatorNumber;
+		elevatorDestination.desiredFloorNumber = record.floor;
+		_batch.insideCalls.push_back(elevatorDestination);
+
+	}
+	else if (record.type == FAULTCALL && 
+		(record.command == TERMINATED || ((record.command == FAULT || record.command == NOFAULT) && validElevator))) {
+
+		faultElevatorData fault;
+		fault.faultType = record.command;
+		fault.elevatorNumber = (record.command == TERMINATED) ? 0 : record.elevatorNumber;
+		_batch.faults.push_back(fault);
+		_terminated = (record.command == TERMINATED);
+
+	}
+	else {
+
+		// Skip records for a bigger building than this one
+		return;
+
+	}
+
+	_commandsReplayed++;
+
+	CheckBatch();
+
+}
+
+void TraceReplayer::WaitUntil(ULONGLONG time) {
+
+	if (_asFastAsPossible || time <= GET_TIME_US() - _startTime) {
+
+		return;
+
+	}
+
+	// Everything recorded before this time goes out before we wait
+	PostBatch();
+
+	ULONGLONG now = GET_TIME_US() - _startTime;
+
+	if (time > now && WaitForTerminate((UINT)((time - now + 999) / 1000))) {
+
+		_terminated = true; // Stop replaying, the system is shutting down
+
+	}
+
+}
+
+void TraceReplayer::CheckBatch() {
+
+	if (_batch.Size() >= replayBatchSize) {
+
+		PostBatch();
+
+	}
+
+}
+
+void TraceReplayer::PostBatch() {
+
+	if (_batch.Size() > 0) {
+
+		if (!_batch.Post(_pipeOutside, _pipeInside, _faultPipe, *this)) {
+
+			_terminated = true; // Stop replaying, the system is shutting down
+
+		}
+
+		_batch.Clear();
+
+	}
+
+}
@@ -0,0 +1,127 @@
+#include "TraceWriter.h"
+
+#include <cstring>
+
+using namespace std;
+
+TraceWriter::TraceWriter(const std::string &fileName) :
+	_file(NULL),
+	_recordsWritten(0) {
+
+	_text = fileName.size() >= 4 && fileName.compare(fileName.size() - 4, 4, ".txt") == 0;
+
+	fopen_s(&_file, fileName.c_str(), _text ? "w" : "wb");
+	PERR(_file != NULL, string("Cannot Create Trace File: ") + fileName);
+
+	if (_file != NULL && !_text) {
+
+		traceHeader header;
+		memcpy(header.magic, traceMagic, sizeof(header.magic));
+		header.version = traceVersion;
+		header.reserved = 0;
+		fwrite(&header, sizeof(traceHeader), 1, _file);
+
+	}
+
+}
+
+TraceWriter::~TraceWriter() {
+
+	if (_file != NULL) {
+
+		fclose(_file);
+
+	}
+
+}
+
+void TraceWriter::Write(unsigned long long time, const commandBatch &batch) {
+
+	traceRecord record;
+	record.time = time;
+
+	for (size_t i = 0; i < batch.outsideCalls.size(); i++) {
+
+		record.type = HALLCALL;
+		record.command = batch.outsideCalls[i].direction;
+		record.floor = (short)batch.outsideCalls[i].currentFloorNumber;
+		record.elevatorNumber = 0;
+		Write(record);
+
+	}
+
+	for (size_t i = 0; i < batch.insideCalls.size(); i++) {
+
+		record.type = CARCALL;
+		record.command = 0;
+		record.floor = (short)batch.insideCalls[i].desiredFloorNumber;
+		record.elevatorNumber = batch.insideCalls[i].currentElevatorNumber;
+		Write(record);
+
+	}
+
+	for (size_t i = 0; i < batch.faults.size(); i++) {
+
+		record.type = FAULTCALL;
+		record.command = batch.faults[i].faultType;
+		record.floor = 0;
+		record.elevatorNumber = batch.faults[i].elevatorNumber;
+		Write(record);
+
+	}
+
+}
+
+void TraceWriter::Write(const traceRecord &record) {
+
+	if (_file == NULL) {
+
+		return;
+
+	}
+
+	if (!_text) {
+
+		fwrite(&record, sizeof(traceRecord), 1, _file);
+
+	}
+	else {
+
+		unsigned long long milliseconds = record.time / 1000;
+
+		if (record.type == HALLCALL) {
+
+			fprintf(_file, "%llu %c%d\n", milliseconds, record.command, record.floor);
+
+		}
+		else if (record.type == CARCALL) {
+
+			fprintf(_file, "%llu %d:%d\n", milliseconds, record.elevatorNumber, record.floor);
+
+		}
+		else if (record.command == TERMINATED) {
+
+			fprintf(_file, "%llu ee\n", milliseconds);
+
+		}
+		else {
+
+			fprintf(_file, "%llu %c%d\n", milliseconds, (record.command == FAULT) ? '-' : '+', record.elevatorNumber);
+
+		}
+
+	}
+
+	_recordsWritten++;
+
+}
+
+void TraceWriter::Flush() {
+
+	if (_file != NULL) {
+
+		fflush(_file);
+
+	}
+
+}
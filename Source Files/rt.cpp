@@ -1,1811 +1,4132 @@
-///////////////////////////////////////////////////////////////////////////////////////////////
-//	Notes for using this code on Microsofts Visual C++ V6.0
-//
-//	If you have trouble linking the program, with errors relating to
-//	_beginthreadex() undefined or similar, then see the project settings options in your handout
-//	on creating concurrent software using Visual C++
-///////////////////////////////////////////////////////////////////////////////////////////////
-
-
-//#include <StdAfx.h>		// delete this line if you are NOT using Microsoft MFC in your project
-						// for example, delete this line if you are creating a Console project
-						// but if you are creating a GUI or window type application, leave it in
-
-// NOTE You will have to change the pathlist to the 'rt.h' header file below to indicate
-// to the compiler where it can find this file. This will of course depend upon where it resides
-// on your computer i.e. where you copied it to.
-
-#include "rt.h"
-
-// constructor to create a child process, takes four 
-//arguments, note that the last 3 make use
-//	of default argument, that is, if you do not supply 
-//real arguments in the call, then the default values will
-//	be used for the ones you do NOT supply
-//	this means that wehn you create a new CProcess object, 
-//the only argument you HAVE to supply is the Name of the 
-//executable
-//	all other values can be supplied by default
-
-//##ModelId=3DE6123A0037
-CProcess::CProcess(	
-		const string &Name,		// path/name of executable program (.exe)
-		int Priority,			// Priority of the process
-		BOOL bUseNewWindow,		// use OWN_WINDOW to make new process run in its own window
-								// use PARENT_WINDOW to make it share its parent window
-		BOOL bCreateSuspended,	// use SUSPENDED to make new child process's main thread suspended when process is created
-								// use ACTIVE to make new child processes main thread active when process iscreated
-		
-		const string &ChildProcessArgString)
-
-		: ProcessName(Name)
-{
-	// Check priority level is valid
-
-	
-
-	PERR((	(Priority == HIGH_PRIORITY_CLASS) ||
-			(Priority == IDLE_PRIORITY_CLASS) ||
-			(Priority == NORMAL_PRIORITY_CLASS) ||
-			(Priority == REALTIME_PRIORITY_CLASS)) ,
-			string("Illegal 2nd Argument (Process Priority) for Process: ") + Name) ;
-
-	
-	PERR ((bUseNewWindow == OWN_WINDOW || bUseNewWindow == PARENT_WINDOW), 
-		string("Use OWN_WINDOW or PARENT_WINDOW as 3rd argument for Process: ") + Name ) ;
-	PERR ((bCreateSuspended == SUSPENDED || bCreateSuspended == ACTIVE), 
-		string("Use SUSPENDED or ACTIVE as 4th Argument for Process: ") + Name) ;
-
-
-	STARTUPINFO	StartupInfo = {
-		sizeof(STARTUPINFO) ,
-		NULL ,			// reserved
-		NULL ,			// ignored in console applications
-		(char *)(Name.c_str()) ,	// displayed in title bar for console applications
-		0,0,			// dwx, dwy, offset of top left of new window relative to top left of screen in pixel
-						// flags below must specify STARTF_USEPOSITION. Ignored for console apps'
-		0,0,			// dwxsize, dwysize: Width and height of the window if new window specified
-						// must use flags STARTF_USESIZE. Ignored for console apps'
-		0,0,			// size of console in characters, only if STARTF_USECOUNTCHARS flag specified, 
-						// Ignored for console apps
-		0,				// Colour control, for background and text. Ignored for console apps
-		0,				// Flags. Ignored for console applications
-		0,				// ignored unless showwindow flag set
-		0 ,
-		NULL,
-		0,0,0			// stdin, stdout and stderr handles (inherited from parent)
-	} ;
-
-	UINT flags = Priority ; // Priority,
-
-	if(bUseNewWindow == OWN_WINDOW)		// if caller has specified that child should have its won window
-		flags |= CREATE_NEW_CONSOLE ;
-	
-	if(bCreateSuspended == SUSPENDED)	// if caller has specified that child process should be immediately suspended
-		flags |= CREATE_SUSPENDED ;
-
-	BOOL Success = CreateProcess(	NULL,	// application name
-					(char *)(Name.c_str()),			// Command line to the process if you want to pass one to main() in the process
-					NULL,			// process attributes
-					NULL,			// thread attributes
-					TRUE,			// inherits handles of parent
-					flags,			// Priority and Window control flags,
-					NULL,			// use environent of parent
-					NULL,			// use same drive and directory as parent
-					&StartupInfo ,	// controls appearance of process (see above)
-					&pInfo			// Stored process handle and ID into this object
-	); 
-	PERR( Success == TRUE, string("CProcess Call Unable to Create New Process: ") + Name) ;	// check for error and print message if appropriate
-}
-
-
-////////////////////////////////////////////////////////////////////////////////////////////
-//	The following function can be used to change the 'base' priority of a process once it has been
-//	created (irrespective of whether it is active or suspended. Processes with higher priority
-//	will block/stop processes with lower priority from executing so be careful
-//
-//	All you need is the handle for the process obtained from FORK_PROCESS() (see above)
-//	Windows NT has a limited number of thread priorities and the following symbolic
-//	constants can be used as a valid value for the parameter 'Priority' in the function
-//	Normally a thread will inherit a 'base' priority from its parent thread, or, if it is
-//	the primary thread, from its parent process (See FORK_PROCESS() above
-//	The constant below simply allow you to make small adjustments to these value
-/////////////////////////////////////////////////////////////////////////////////////////////
-//
-//	HIGH_PRIORITY_CLASS		Specify this class for a process that performs time-critical tasks that must be executed immediately. The threads of the process preempt the threads of normal or idle priority class processes. An example is Windows Task List, which must respond quickly when called by the user, regardless of the load on the operating system. Use extreme care when using the high-priority class, because a high-priority class application can use nearly all available CPU time. 
-//	IDLE_PRIORITY_CLASS		Specify this class for a process whose threads run only when the system is idle. The threads of the process are preempted by the threads of any process running in a higher priority class. An example is a screen saver. The idle-priority class is inherited by child processes. 
-//	NORMAL_PRIORITY_CLASS	Specify this class for a process with no special scheduling needs. 
-//	REALTIME_PRIORITY_CLASS Specify this class for a process that has the highest possible priority. The threads of the process preempt the threads of all other processes, including operating system processes performing important tasks. For example, a real-time process that executes for more than a very brief interval can cause disk caches not to flush or cause the mouse to be unresponsive. 
-//
-//	Returns TRUE on Success/False on failure
-//
-
-//##ModelId=3DE6123A009C
-BOOL CProcess::SetPriority(int Priority) const
-{
-	BOOL Success;
-
-	// Check priority level 
-
-	PERR(((Priority == HIGH_PRIORITY_CLASS) || (Priority == IDLE_PRIORITY_CLASS) ||
-			(Priority == NORMAL_PRIORITY_CLASS) || (Priority == REALTIME_PRIORITY_CLASS)) ,
-			string("Illegal Priority value in call to SetPiority()")) ;
-
-	Success = SetPriorityClass(GetProcessHandle(), Priority) ;
-	PERR( Success == TRUE, string("Unable to Set Thread Priority of Process: ") + ProcessName) ;	// check for error and print error message as appropriate
-	
-	return Success ;
-}
-
-//
-//	These two functions can be called to suspend and resume a processes activity. 
-//	Actually, it suspend/resumes the process primary thread and not necessarily any
-//	other child threads it may have. Once suspended	the thread will no longer 
-//	run and consume CPU time. Note that if you suspend a process more than once, 
-//	then it will require the appropriate number	of resumes to allow it to continue
-//
-//
-//	Returns TRUE on Success, FALSE on Failure
-//
-
-//##ModelId=3DE6123A007F
-BOOL CProcess::Suspend() const
-{
-	UINT	Result = SuspendThread(GetThreadHandle()) ;
-	PERR( Result != 0xffffffff, string("Cannot Suspend Process: ") + ProcessName) ;
-
-	if(Result != 0xffffffff)	// if no error
-		return TRUE ;
-	else
-		return FALSE ;
-}
-
-//##ModelId=3DE6123A0088
-BOOL CProcess::Resume() const
-{
-	UINT	Result = ResumeThread(GetThreadHandle()) ;
-	PERR( Result != 0xffffffff, string("Cannot Resume Process: ") + ProcessName) ;
-
-	if(Result != 0xffffffff)	// if no error
-		return TRUE ;
-	else
-		return FALSE ;
-}
-
-
-///////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-//	This function waits for a child process to terminate provide it has been
-//	created as a CProcess Object. Or returns if the specified time elapses before the process has terminates
-//
-//	Note that if the child process has already terminated, when the call to wait for
-//	it is made, then this is deemed a success, NOT a failure and the function returns immediately without waiting
-//
-//	This function returns WAIT_FAILED if there was an error, WAIT_TIMEOUT if the wait operation timed out
-//	of WAIT_OBJECT_0 if the operation did in fact wait and then returned
-///////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-
-//##ModelId=3DE6123A0092
-BOOL	CProcess::WaitForProcess(DWORD Time) const
-{
-	UINT Result = WaitForSingleObject(GetProcessHandle(), Time) ;	
-	PERR( Result != WAIT_FAILED, string("Cannot Wait for Child Process: ") + ProcessName + string(" to Terminate.\n It might already be dead")) ;	// check for error and print message if appropriate== WAIT_OBJECT_0 ) 
-
-	return Result ;
-}
-
-
-//	The following function sends a message to a process' main thread
-//	If the thread is currently suspended, waiting for a message, then posting it a message
-//	will wake it up and allow it to continue
-//
-//	The Message must be in the range 0 - 32000
-//	In order to receive messages, the thread receiving the message must have created a message queue.
-//	(See CMessageQueue later)
-//
-
-//##ModelId=3DE6123A00AF
-BOOL CProcess::Post(UINT Message) const	// message value and ID of thread
-{
-	BOOL Result ;
-
-	if(Message > 32000)	{
-		PERR( Message <= 32000, string("Could not Signal Process:") + ProcessName + string("\nReason: Message Value > 32000")) ;	// check for error and print error message as appropriate
-		return FALSE ;
-	}
-	else {
-		Result = PostThreadMessage(GetThreadId(), WM_USER + Message, 0, 0L) ;
-		PERR( Result != 0, string("Could not Signal Process:") + ProcessName + string("\nProcess May be Dead")) ;	// check for error and print error message as appropriate
-		return Result ;
-	}
-}
-
-//
-//	This calls standard exit() function to terminate the process
-//
-
-//##ModelId=3DE6123A00BA
-void CProcess::Exit(UINT ExitCode) const
-{
-	exit(ExitCode) ;
-}
-
-//	This function create a parallel thread within a process (do not confuse this
-//	with creating a new process. Each and every process (i.e. program/application)
-//	can have many threads. At startup, a process will have just 1 thread which commences
-//	with the execution of main() in your 'C' program. Once started, this 'primary' thread
-//	can create secondary threads which run in parallel with each other AND the main thread
-//	
-//	A thread is simply a 'C' style function (see examples below) defined in a special way.
-//	A thread inherits the priority of its parent thread, but can be changed later
-//
-//	A Thread function MUST be declared in a prescribed style (see example below). 
-//	A process can create/maintain many such threads and they can share global variables 
-//	thus implementing thread-to-thread communication in a simple and effective way
-
-//	and even call the same functions.
-
-
-//##ModelId=3DE6123A0182
-CThread::CThread(UINT __stdcall Function( void *), // name/pointer to function that is to be the new thread
-				 BOOL bCreateState,		// A flag indicating if the thread should commence SUSPENDED (TRUE) or ACTIVE (FALSE)
-				 void *ThreadArgs		// a generic pointer (can point to anything) to any data the calling thread
-										// wishes to pass to the child thread
-					 )
-{
-	UINT		ThreadControlFlags = 0 ;
-
-	if(bCreateState == SUSPENDED)		// if caller wants thread initially suspended
-		ThreadControlFlags = CREATE_SUSPENDED ;
-
-	ThreadHandle = (HANDLE)(_beginthreadex(NULL, 0, Function, ThreadArgs, ThreadControlFlags, &ThreadID)) ;
-	PERR( ThreadHandle != 0, string("Unable to Create Thread")) ;	// check for error and print message if appropriate
-}
-
-
-/*
-**	The following two functions work together to assist in the design of CThread derived classes with a main() to simulate the main of the thread
-**	All active class objects have their root thread within this function
-*/
-
-UINT __stdcall __GlobalThreadMain__(void *theThreadPtr) 	// receives a pointer to the thread object 
-{
-	ExitThread(((ActiveClass *)(theThreadPtr))->main()) ;	// run the activeclass virtual main function it should be overridden in derived class
-	return 0 ;
-}
-
-
-//##ModelId=3DE6123A0178
-CThread::CThread(BOOL bCreateState)			// A flag indicating if the thread should commence SUSPENDED (TRUE) or ACTIVE (FALSE)
-{
-	UINT		ThreadControlFlags = 0 ;
-
-	if(bCreateState == SUSPENDED)		// if caller wants thread initially suspended
-		ThreadControlFlags = CREATE_SUSPENDED ;
-
-	ThreadHandle = (HANDLE)(_beginthreadex(NULL, 
-							0, 
-							__GlobalThreadMain__,	
-							this,				//pointer to cthread derived object passed to __GlobalThreadMain__() above
-							ThreadControlFlags,	// thread is created in suspended state 
-							&ThreadID)) ;
-
-	PERR( ThreadHandle != 0, string("Unable to Create Thread")) ;	// check for error and print message if appropriate
-}
-
-
-//##ModelId=3DE6123A0223
-ActiveClass::ActiveClass()
-: TerminateFlag(FALSE) ,
-CThread()		// Call base class constructor to create the SUSPENDED thread, i.e. main in derived class does not yet run
-				// All objects derived from active class are thus initially created in the suspended state and have to
-				// be RESUMED before they become active. This is the safest way, as it allows control over the
-				// order in which objects run and avoids potential race hazards.
-{}				// Note that active class objects like all derived classes are constructed from the base upwards 
-				// and thus we have to make sure that base/derived class constructors are run to completion
-				// before the thread for the class (which is created in the base class) is allowed to resume
-				// otherwise the thread could run BEFORE the active class object had completed its construction
-				// this was the main reason for creating all ActiveClass objects in the Suspended state so don't change it
-				// I learn't the hard way and it was painful to debug !!!
-
-
-// this is important as we want to allow the derived 
-//classes constructor i.e. the one
-// written by the user, to complete its constructor 
-//before the class main() is run
-// otherwise the class might run with unitialised 
-//variables/state
-// This means that the user has to call Resume() for the 
-//class object to allow it to run.
-//##ModelId=3DE6123A022C
-ActiveClass::~ActiveClass()
-{}
-
-
-
-//
-//	The following can be used to terminate a thread at any point in the thread execution
-//	If the thread reaches the end of its 'thread function' then executing return 0 does the same trick.
-//
-
-//##ModelId=3DE6123A01D4
-void CThread::Exit(UINT	ExitCode) const
-{
-	ExitThread(ExitCode) ;
-}
-	
-/////////////////////////////////////////////////////////////////////////////////////////////
-//	These two functions can be called to suspend and resume a threads activity. Once suspended
-//	the thread will no longer run and consume CPU time
-//
-//	Note that if you suspend a thread more than once, then it will require that many number
-//	of resumes to allow it to continue
-//
-//	Both functions require the thread HANDLE, which can be obtained when the thread is created
-///////////////////////////////////////////////////////////////////////////////////////////////
-
-//##ModelId=3DE6123A01AA
-BOOL CThread::Suspend() const
-{
-	UINT	Result = SuspendThread(ThreadHandle) ;
-	PERR( Result != 0xffffffff, string("Cannot Suspend Thread\n")) ;	// check for error and print message if appropriate
-
-	if(Result != 0xffffffff)
-		return TRUE ;
-	else
-		return FALSE ;
-}
-
-//##ModelId=3DE6123A01B4
-BOOL CThread::Resume() const
-{
-	UINT	Result = ResumeThread(ThreadHandle) ;
-	PERR( Result != 0xffffffff, string("Cannot Resume Thread\n")) ;	// check for error and print message if appropriate
-
-	if(Result != 0xffffffff)
-		return TRUE ;
-	else
-		return FALSE ;
-}
-
-////////////////////////////////////////////////////////////////////////////////////////////
-//	The following function can be used to change the priority of a thread once it has been
-//	created (irrespective of whether it is active or suspended). Threads with higher priority
-//	will block/stop threads with lower priority from executing so be careful.
-//
-//	All you need is the handle for the thread obtained from CREATE_THREAD() (see above)
-//	Windows NT has a limited number of thread priorities and the following symbolic
-//	constants can be used as a valid value for the parameter 'Priority' in the function
-//	Normally a thread will inherit a 'base' priority from its parent thread, or, if it is
-//	the primary thread, from its parent process (See FORK_PROCESS() above
-//	The constant below simply allow you to make small adjustments to the thread priority
-/////////////////////////////////////////////////////////////////////////////////////////////
-//
-//	THREAD_PRIORITY_ABOVE_NORMAL  = Indicates 1 point above normal priority for the priority class. 
-//	THREAD_PRIORITY_BELOW_NORMAL  = Indicates 1 point below normal priority for the priority class. 
-//	THREAD_PRIORITY_HIGHEST = Indicates 2 points above normal priority for the priority class. 
-//	THREAD_PRIORITY_IDLE = Indicates a base priority level of 1 for IDLE_PRIORITY_CLASS, NORMAL_PRIORITY_CLASS, or HIGH_PRIORITY_CLASS processes, and a base priority level of 16 for REALTIME_PRIORITY_CLASS processes. 
-//	THREAD_PRIORITY_LOWEST = Indicates 2 points below normal priority for the priority class. 
-//	THREAD_PRIORITY_NORMAL = Indicates normal priority for the priority class. 
-//	THREAD_PRIORITY_TIME_CRITICAL = Indicates a base priority level of 15 for IDLE_PRIORITY_CLASS, NORMAL_PRIORITY_CLASS, or HIGH_PRIORITY_CLASS processes, and a base priority level of 31 for REALTIME_PRIORITY_CLASS processes. 
-/////////////////////////////////////////////////////////////////////////////////////////////
-
-//##ModelId=3DE6123A01BF
-BOOL CThread::SetPriority(UINT Priority) const
-{	
-	BOOL Success;
-
-	// check for error in priority value and print message if appropriate
-
-	PERR(((Priority == THREAD_PRIORITY_ABOVE_NORMAL) ||
-			(Priority == THREAD_PRIORITY_BELOW_NORMAL) ||
-			(Priority == THREAD_PRIORITY_HIGHEST) ||
-			(Priority == THREAD_PRIORITY_IDLE) ||
-			(Priority == THREAD_PRIORITY_LOWEST) ||
-			(Priority == THREAD_PRIORITY_NORMAL) ||
-			(Priority == THREAD_PRIORITY_TIME_CRITICAL)) ,
-			string("Illegal Priority value specified for Thread in call to CThread::SetPriority()")) ;
-
-	Success = SetThreadPriority(ThreadHandle, Priority) ;	// set priority
-
-	PERR( Success == TRUE, string("Cannot Set Thread Priority\n")) ;	// check for error and print message if appropriate
-	
-	return Success ;
-}
-
-
-//
-//	This function will wait for the child thread specified by ThreadHandle to terminate
-//	main or parent threads can use this to wait for their child thread to terminate
-//
-//	A time period can be specified indicating the maximum time to attempt a wait
-//
-//	This function returns WAIT_FAILED if there was an error, WAIT_TIMEOUT if the wait operation timed out
-//	of WAIT_OBJECT_0 if the operation did in fact wait and then returned
-//
-
-//##ModelId=3DE6123A01B6
-UINT CThread::WaitForThread(DWORD Time) const		
-{
-	UINT Result = WaitForSingleObject(ThreadHandle, Time) ;	// return WAIT_FAILED on error
-	PERR( Result != WAIT_FAILED, string("Cannot Wait For Thread")) ;	// check for error and print error message as appropriate
-
-	return Result ;
-}
-
-//	The following function sends a message to a thread
-//	If the thread is currently suspended, waiting for a message, then posting it a message
-//	will wake it up and allow it to continue
-//
-//	Message must bve in the range 0 - 32000
-//	In order to use messages, the thread receiving the message must have created a message queue.
-//	(See CMessageQueue later )
-//
-
-//##ModelId=3DE6123A01CA
-BOOL CThread::Post(UINT Message) const	// message value and ID of thread
-{
-	BOOL Result ;
-
-	if(Message > 32000)	{
-		PERR( Message <= 32000, string("Could not Post User Message: Message > 32000")) ;	// check for error and print error message as appropriate
-		return FALSE ;
-	}
-	else {
-		Result = PostThreadMessage(ThreadID, WM_USER + Message, 0, 0L) ;
-		PERR( Result != 0, string("Could not Post User Message. The Thread might have died")) ;	// check for error and print error message as appropriate
-		return Result ;
-	}
-}
-
-
-// constructs mutex with name and indicates whether 
-// object protected by mutex is owned by creator or not
-// Note use of default argument, i.e. if you do not 
-// specifiy a value for bOwned argument
-// then it will default to NOTOWNED
-
-//##ModelId=3DE6123A0397
-CMutex::CMutex(const string &Name, BOOL bOwned)		// needs a name for the mutex (i.e. a string) and a flag 
-													// indicating if the mutex is owned by the process that created it (Use OWNED or NOTOWNED for this value)
-	:MutexName(Name)
-{
-	if(bOwned == OWNED)	bOwned = TRUE ;
-	else				bOwned = FALSE ;
-
-	MutexHandle  = CreateMutex(NULL, bOwned, (char *)(Name.c_str())) ;
-	PERR( MutexHandle != NULL, string("Cannot Create Mutex: ") + Name) ;	// check for error and print message if appropriate
-}
-
-
-//////////////////////////////////////////////////////////////////////
-//	unlinks a thread from a Mutex, provided you have its handle
-//	Returns TRUE/FALSE on SUCCESS/FAIL
-//	when all threads have unlinked from a mutex it will be destroyed automatically
-//////////////////////////////////////////////////////////////////////
-
-//##ModelId=3DE6123A0383
-BOOL	CMutex::Unlink() const
-{
-	BOOL Success = CloseHandle(MutexHandle) ;
-	PERR( Success == TRUE, string("Cannot Unlink from Mutex:") + MutexName) ;	// check for error and print message if appropriate
-	return Success ;
-}		
-
-
-//
-//	This function will attempt to perform a WAIT on a Mutex. If the Mutex has been signalled
-//	(new mutexs are created in the 'signalled' or free state), then the process will be allowed to
-//	continue and the mutex will be set to the non-signalled state. This would mean
-//	that any other process coming along and performing a wait would be blocked until the mutex
-//	is signalled once again.
-//	
-//	This function returns WAIT_FAILED if there was an error, WAIT_TIMEOUT if the wait operation timed out
-//	of WAIT_OBJECT_0 if the operation did in fact wait and then returned
-//
-
-//##ModelId=3DE6123A036D
-UINT CMutex::Wait(DWORD Time) const				// return an unsigned int or UINT
-{
-	UINT	Result = WaitForSingleObject(MutexHandle, Time) ;				// returns WAIT_FAILED on error
-	PERR( Result != WAIT_FAILED, string("Cannot Perfom WAIT operation on Mutex: ") + MutexName) ;	// check for error and print message if appropriate
-	return Result ;
-}
-
-
-//
-//	This function will attempt to 'signal' a Mutex. This will allow one blocked
-//	process to proceed (setting the mutex back to the non-signalled state), otherwise
-//	if no processes are waiting/blocked, the mutex remains in the signalled state
-//	
-
-
-//##ModelId=3DE6123A0377
-BOOL CMutex::Signal() const
-{
-	BOOL Success = ReleaseMutex( MutexHandle) ;		// FALSE on failure, TRUE on success
-	PERR( Success == TRUE, string("Cannot Perfom SIGNAL operation on Mutex: ") + MutexName) ;	// check for error and print message if appropriate
-	return Success ;
-}
-
-//
-//	This function reads the value of a Mutex, without signalling or waiting on it
-//	it can be used to poll the value of the Mutex to perhaps determine if it is safe to
-//	perform a wait without getting suspended/blocked
-//	returns WAIT_FAILED if there was an error.
-//
-//	If the Mutex has been signalled, then this function returns TRUE
-//	if the Mutex has NOT been signalled, then this function returns FALSE
-//
-
-//##ModelId=3DE6123A0381
-BOOL CMutex::Read() const	// Handle of the Mutex needed
-{							// returns true/false state of Mutex
-	BOOL Signalled ;
-
-	// first wait for the object. Timeout is zero, so function
-	// should immediately wait and decrement the Mutex value if it is signalled (i.e. >1)
-	
-	Signalled = WaitForSingleObject(MutexHandle, 0) ;	// see of Mutex is signalled or not
-	PERR( Signalled != WAIT_FAILED, string("Cannot Perfom READ operation on Mutex: ") + MutexName) ;	// check for error and print message if appropriate	
-	
-	// Now if we did a wait and managed to decrement the Mutex, then
-	// the above function call should have returned WAIT_OBJECT_0, thus the process
-	// of attempting to read the Mutex has unfortunately resulted in its value
-	// being decremented, so we have to put that write by signalling it again. This should be
-	// safe, since we cannot exceed the limits of the Mutex max value as we are
-	// only putting it back to what it was before we attempted this
-
-	if(Signalled == WAIT_FAILED) 
-		return WAIT_FAILED ;
-
-	if(Signalled == WAIT_OBJECT_0)	{
-		BOOL Success = ReleaseMutex(MutexHandle) ;			// signal mutex if we decremented it
-		PERR( Success == TRUE, string("Cannot Perfom READ operation on Mutex: ") + MutexName) ;		// check for error and print message if appropriate
-		return (UINT)TRUE ;
-	}
-	else 
-		return (UINT)FALSE ;			// non-signalled
-
-}
-
-////////////////////////////////////////////////////////////
-//	ReaderWriters Mutex Problem
-////////////////////////////////////////////////////////////
-
-//
-//	This version gives preference to readers rather than writers
-//
-
-CReadersWritersMutex::CReadersWritersMutex(const string &MyName) : Name(MyName)
-{
-	ReadersWritersMutex = new CMutex(string("__CReadersWritersMutex__") + MyName) ;
-	ReadersWritersSemaphore = new CSemaphore(string("__CReadersWritersSemaphore__") + MyName, 1, 1) ;
-	ReadersWritersDataPool = new CDataPool(string("__CReadersWritersDataPool__") + MyName, sizeof(struct Data)) ;
-	ptr = (struct Data *)(ReadersWritersDataPool->LinkDataPool()) ;
-		
-	if(strcmp(ptr->Initialised, "Initialised") != 0)	{	// if pool not initialised
-		ptr->NumberOfReaders = 0 ;
-		strcpy_s(ptr->Initialised, "Initialised");			// show me as initialised
-	}
-}
-
-CReadersWritersMutex::~CReadersWritersMutex()
-{
-	delete ReadersWritersMutex;
-	delete ReadersWritersSemaphore;
-	strcpy_s(ptr->Initialised, "") ;
-	delete ReadersWritersDataPool;
-}
-
-//
-// called by a reader when they wish to access to the resource
-//
-void CReadersWritersMutex::WaitToRead()
-{
-	ReadersWritersMutex->Wait();			// wait for exclusive access
-
-	// increment the number of waiting readers
-
-	if(++(ptr->NumberOfReaders) == 1)		// if this is the 1st reader
-		ReadersWritersSemaphore->Wait();	// wait on the semaphore as a writer may be using the resource
-
-	ReadersWritersMutex->Signal() ;		// release access to resource
-}
-
-
-// 
-// called by a reader when they have finished with the resource
-//
-
-void CReadersWritersMutex::DoneReading() 
-{
-	ReadersWritersMutex->Wait();			// wait for exclusive access
-
-	// decrement the number of waiting readers
-	if(--(ptr->NumberOfReaders) == 0)			// if no readers
-		ReadersWritersSemaphore->Signal() ;		// signal that writers may now enter
-
-	ReadersWritersMutex->Signal() ;			// release access to resource
-}
-
-//
-// called by a writer when they wish to access to the resource
-//
-
-void CReadersWritersMutex::WaitToWrite()
-{
-	ReadersWritersSemaphore->Wait() ;		// used to exclude all readers
-}
-
-// 
-// called by a writer when they have finished with the resource
-//
-
-void CReadersWritersMutex::DoneWriting()
-{		
-	PERR((ptr->NumberOfReaders < 2) , "HELP");
-	ReadersWritersSemaphore->Signal() ;		// allow readers in
-}
-
-////////////////////////////////////////////////////////////
-//	WritersReader Mutex Problem
-////////////////////////////////////////////////////////////
-
-//
-//	This version gives preference to writers rather than readers
-//
-
-
-CWritersReadersMutex::CWritersReadersMutex(const string &MyName) : Name(MyName)
-{
-	WritersReadersMutex = new CMutex(string("__CWritersReadersMutex__") + MyName) ;
-	WritersReadersSemaphore = new CSemaphore(string("__CWritersReadersSemaphore__") + MyName, 1, 1) ;
-	WritersReadersCondition = new CCondition(string("__CWritersReadersCondition__") + MyName, MANUAL, SIGNALLED) ;
-
-	WritersReadersDataPool = new CDataPool(string("__CWritersReadersDataPool__") + MyName, sizeof(struct Data)) ;
-	ptr = (struct Data *)(WritersReadersDataPool->LinkDataPool()) ;
-		
-	if(strcmp(ptr->Initialised, "Initialised") != 0)	{	// if pool not initialised
-		ptr->NumberOfReaders = 0 ;
-		ptr->NumberOfWriters = 0 ;
-		strcpy_s(ptr->Initialised, "Initialised");			// show me as initialised
-	}
-}
-
-CWritersReadersMutex::~CWritersReadersMutex()
-{
-	delete WritersReadersMutex;
-	delete WritersReadersSemaphore;
-	delete WritersReadersCondition ;
-	strcpy_s(ptr->Initialised, "") ;
-	delete WritersReadersDataPool;
-}
-
-//
-// called by a reader when they wish to access to the resource
-//
-void CWritersReadersMutex::WaitToRead()
-{
-	WritersReadersCondition->Wait() ;		// wait until no writers
-	WritersReadersMutex->Wait();			// wait for exclusive access
-
-	// increment the number of waiting readers
-
-	if(++(ptr->NumberOfReaders) == 1)		// if this is the 1st reader
-		WritersReadersSemaphore->Wait();	// wait on the semaphore as a writer may be waiting to use the resource
-
-	WritersReadersMutex->Signal() ;		// release access to resource
-}
-
-
-// 
-// called by a reader when they have finished with the resource
-//
-void CWritersReadersMutex::DoneReading() 
-{
-	WritersReadersMutex->Wait();				// wait for exclusive access
-
-	if(--(ptr->NumberOfReaders) == 0)			// if no readers
-		WritersReadersSemaphore->Signal() ;		// signal last reader has left and that any waiting writers may now enter
-
-	WritersReadersMutex->Signal() ;				// release access to resource
-}
-
-//
-// called by a writer when they wish to access to the resource
-//
-void CWritersReadersMutex::WaitToWrite()
-{
-	WritersReadersMutex->Wait();				// wait for exclusive access to data
-
-	if(++(ptr->NumberOfWriters) == 1 )			// if I am the only writer waiting
-		WritersReadersCondition->Reset() ;		// block future readers until this writer has gained access and has released it
-
-	WritersReadersMutex->Signal() ;				// release access to data
-	
-	WritersReadersSemaphore->Wait() ;			// wait until all other process have left resource (readers or writers)
-}
-
-// 
-// called by a writer when they have finished with the resource
-//
-void CWritersReadersMutex::DoneWriting()
-{		
-	WritersReadersSemaphore->Signal() ;				// allow next writer or reader in depending on who is first in line
-
-	WritersReadersMutex->Wait();					// wait for exclusive access to data
-
-	if(--(ptr->NumberOfWriters) == 0 )				// if there are no more waiting writers
-		WritersReadersCondition->Signal() ;			// remove the condition blocking entry by readers
-		
-	WritersReadersMutex->Signal() ;					// release access to data
-	
-}
-
-///////////////////////////////////////////////////////////////////////////////////////////////////////////
-//	CRendezvous Class
-///////////////////////////////////////////////////////////////////////////////////////////////////////////
-
-CRendezvous::CRendezvous(const string &TheRendezvousName, int NumberThreads) : RendezvousName(TheRendezvousName)
-{
-	RendezvousMutex = new CMutex(string("__RendezvousMutex__") + RendezvousName) ;
-	RendezvousEvent = new CEvent(string("__RendezvousEvent__") + RendezvousName) ;
-		
-	RendezvousDataPool = new CDataPool(string("__RendezvousDataPool__") + RendezvousName, sizeof(struct RendezvousData)) ;
-	ptr = (struct RendezvousData *)(RendezvousDataPool->LinkDataPool()) ;
-
-	RendezvousMutex->Wait() ;
-	if(strcmp(ptr->Initialised, "Initialised") != 0)	// if not initialised
-	{
-		strcpy_s(ptr->Initialised, "Initialised") ;							// initialise it
-		ptr->NumberWaiting = NumberThreads ;					// set number of threads waiting to rendezvous
-		ptr->NumThreads = NumberThreads ;
-	}
-	else								// check the number is the same as previous initialisation of this rendezvous
-		PERR(NumberThreads == ptr->NumThreads, string("Rendezvous '") + RendezvousName + string("' Already Created with a Different Number of Clients")) ;
-
-	RendezvousMutex->Signal() ;
-}
-
-void CRendezvous::Wait() {
-	RendezvousMutex->Wait() ;
-	if(--(ptr->NumberWaiting) == 0)
-	{
-		ptr->NumberWaiting = ptr->NumThreads ;			// reset the count
-		RendezvousEvent->Signal() ;			// release all waiting threads
-		RendezvousMutex->Signal() ;
-	}
-	else	
-	{
-		RendezvousMutex->Signal() ;
-		RendezvousEvent->Wait() ;
-	}
-}
-
-CRendezvous::~CRendezvous()
-{
-	strcpy_s(ptr->Initialised, "") ;
-	delete RendezvousDataPool ;
-	delete RendezvousMutex ;
-	delete RendezvousEvent ;
-}
-
-
-////////////////////////////////////////////////////////////
-//	Event Functions
-////////////////////////////////////////////////////////////
-
-
-CEvent::CEvent(const string &Name, BOOL bType, BOOL bState)			// btype = SINGLE_RELEASE or MULTIPLE_RELEASE to allow one or many thread to resume when event is signalled
-{																	// bState = SIGNALLED or NOTSIGNALLED to indicate the initial or creation state of the event
-	PERR(bState == SIGNALLED || bState == NOTSIGNALLED, string("Illegal Signalled/NotSignalled Type specified when creating CEvent: ") + EventName) ;
-	
-	if(bState == SIGNALLED)		
-		bState = TRUE ;
-	else
-		bState = FALSE ;
-
-	PERR(bType == SINGLE_RELEASE || bType == MULTIPLE_RELEASE, string("Illegal Single or Multithread Type specified when creating CEvent: ") + EventName) ;
-	
-	if(bType == SINGLE_RELEASE)
-		bType = FALSE ;			// Win32 Auto-reset event
-	else
-		bType = TRUE ;			// Win32 manual-reset event
-	
-	EventHandle = CreateEvent(NULL, bType, bState, (char *)(Name.c_str())) ;		
-	PERR( EventHandle != NULL, string("Cannot Create CEvent: ") + Name) ;	// check for error and print message if appropriate
-}
-	
-BOOL CEvent::Unlink() const {								// unlink from event, i.e. we have finished using it
-	BOOL Success = CloseHandle(EventHandle) ;
-	PERR(Success != 0, string("Cannot Unlink the CEvent: ") + EventName) ;	// check for error and print message if appropriate
-	return Success ;
-}
-
-// Signal() sets the event and will release ONLY ONE Waiting thread. It is then automatically reset.
-// If no thread is waiting at the time it is signalled, then it is STILL RESET immediately
-
-BOOL CEvent::Signal() const 
-{ 	
-	BOOL Success = PulseEvent(EventHandle) ;
-	PERR( Success != 0, string("Cannot SignalAndReset() the CEvent: ") + EventName) ;	// check for error and print message if appropriate
-	return Success ; 
-}
-	
-UINT CEvent::Wait(DWORD Time) const 			// perform a wait on an event for ever or until specified time
-{
-	UINT	Status = WaitForSingleObject(EventHandle, Time) ;
-	PERR(Status != WAIT_FAILED, string("Cannot Wait for CEvent: ") + EventName) ;	// check for error and print message if appropriate
-	return Status ;
-}
-
-////////////////////////////////////////////////////////////
-//	Condition Functions
-////////////////////////////////////////////////////////////
-
-CCondition::CCondition(const string &Name, BOOL bType, BOOL bState) 
-{
-	PERR(bState == SIGNALLED || bState == NOTSIGNALLED, string("Illegal Signalled/NotSignalled Type specified when creating CCondition: ") + ConditionName) ;
-
-	if(bState == SIGNALLED)		bState = TRUE ;
-	else						bState = FALSE ;
-
-	PERR(bType == MANUAL || bType == AUTORESET, string("Illegal Signalled/NotSignalled Type specified when creating CCondition: ") + ConditionName) ;
-
-	if(bType == MANUAL)		bType = TRUE ;
-	else					bType = FALSE ;
-
-	
-	ConditionHandle = CreateEvent(NULL, bType, bState, (char *)(Name.c_str())) ;		// based around a Win32 manual event
-	PERR( ConditionHandle != NULL, string("Cannot Create CCondition: ") + Name) ;	// check for error and print message if appropriate
-}
-
-BOOL CCondition::Unlink() const {								// unlink from Condition, i.e. we have finished using it
-	BOOL Success = CloseHandle(ConditionHandle) ;
-	PERR(Success != 0, string("Cannot Unlink the CCondition: ") + ConditionName) ;	// check for error and print message if appropriate
-	return Success ;
-}
-
-
-// Signal() sets the Condition and will release ALL Waiting threads. It can be reset by calling Reset()
-BOOL CCondition::Signal() const { 	
-	BOOL Success = SetEvent(ConditionHandle) ;
-	PERR( Success != 0, string("Cannot Set() the CCondition: ") + ConditionName) ;	// check for error and print message if appropriate
-	return Success ; 
-}	
-	
-
-UINT CCondition::Wait(DWORD Time) const 			// perform a wait on a Condition for ever or until specified time
-{
-	UINT	Status = WaitForSingleObject(ConditionHandle, Time) ;
-	PERR(Status != WAIT_FAILED, string("Cannot Wait for CCondition: ") + ConditionName) ;	// check for error and print message if appropriate
-	return Status ;
-}
-
-BOOL CCondition::Reset() const		// reset the condition back to false or not signalled
-{
-	BOOL Success = ResetEvent(ConditionHandle) ;
-	PERR( Success != 0, string("Cannot Reset CCondition: ") + ConditionName) ;	// check for error and print message if appropriate
-	return Success ;
-}
-	
-BOOL CCondition::Test() const 									// see if condition is signalled	
-{
-	UINT	Status = WaitForSingleObject(ConditionHandle, 0) ;
-	PERR( Status != WAIT_FAILED, string("Cannot Test Value of CAutoResetCondition: ") + ConditionName) ;	// check for error and print message if appropriate
-
-	if(Status == WAIT_FAILED)
-		return WAIT_FAILED ;
-	else if(Status == WAIT_OBJECT_0)		// if event signalled
-		return TRUE ;						// return TRUE
-	else 
-		return FALSE ;						// esle return FALSE
-}
-
-
-////////////////////////////////////////////////////////////
-//	Semaphore Functions
-////////////////////////////////////////////////////////////
-//
-//	Semaphore's are used primarily by processes that need to make sure that a limited number of
-//	processes are allowed to access a resource at any one time.
-//
-//	In order to use a Semaphore, create one using the function below, giving it a name
-//	if the Semaphore is new, i.e. there is not already a Semaphore with that name in existence, 
-//	then a new one will be created using the initial value specified and limiting its maximum value to that specified
-//	However, if one already exists, then the function below simply links to it 
-//	or creates a reference to it. (the max and initial values will in this instance be ignored)
-//
-//	In essence, all processes that wish to use the Semaphore attempt to create it.
-//	Only one process will actually create it, the others simply reference or share the Semaphore
-//	with the same name. In either case, the function returns a HANDLE to the object.
-//	This handle can be used in subsequent calls relating to the use of Semaphores. In the event
-//	that an error occurs, the returned value of the Handle will be NULL. the calling process
-//	can check this and take appropriate action
-//
-//	An alternative is to use the LINK_SEMAPHORE() function below if you only want to
-//	use the Semaphore and not create it
-//
-//	For a Binary semaphore specify Max value as 1
-
-
-// construct semaphore by name with initial and max 
-//permissible values
-//##ModelId=3DE6123B02A6
-CSemaphore::CSemaphore(const string &Name, int InitialVal, int MaxVal)	// name, starting value and Maximum value needed
-	:SemaphoreName(Name)
-{
-	SemaphoreHandle = CreateSemaphore(0, InitialVal, MaxVal, (char *)(Name.c_str())) ;
-	PERR( SemaphoreHandle != NULL, string("Cannot Create Semaphore: ") + Name) ;	// check for error and print message if appropriate
-}
-
-
-
-//////////////////////////////////////////////////////////////////////
-//	unlinks a Semaphore, provided you have its handle
-//	Returns TRUE/FALSE on SUCCESS/FAIL
-//	
-//	A sempahore is removed when all threads have unlinked from it
-//////////////////////////////////////////////////////////////////////
-
-//##ModelId=3DE6123B0293
-BOOL	CSemaphore::Unlink() const	// Handle of the semaphore needed
-{													// return TRUE/FALSE on Success/Failure
-	BOOL Success = CloseHandle(SemaphoreHandle) ;
-	PERR( Success == TRUE, string("Cannot Unlink from Semaphore: ") + SemaphoreName ) ;	// check for error and print message if appropriate
-	return Success ;
-}
-
-
-//
-//	This function will attempt to perform a wait on a sempahore. If the sempahore has been signalled
-//	(new sempahores are NOT necessarily created in the 'signalled' state), then the process will be allowed to
-//	continue and the sempahore will be set to the non-signalled state. This would mean
-//	that any other process coming along and performing a wait would be blocked until the sempahore
-//	is signalled once again.
-//
-//	This function returns WAIT_FAILED if there was an error, WAIT_TIMEOUT if the wait operation timed out
-//	of WAIT_OBJECT_0 if the operation did in fact wait and then returned
-///
-
-//##ModelId=3DE6123B0277
-UINT CSemaphore::Wait(DWORD Time) const	// Handle of the semaphore needed
-{
-	UINT Result = WaitForSingleObject(SemaphoreHandle, Time) ;		// return WAIT_FAILED on error
-	PERR( Result != WAIT_FAILED, string("Cannot Wait on Semaphore: ") + SemaphoreName ) ;	// check for error and print message if appropriate
-	return Result ;
-}
-
-
-//
-//	This function will attempt to 'signal' a semaphore. This will allow one or more blocked
-//	process to proceed (setting the mutex back to the non-signalled state), otherwise
-//	if no processes are waiting/blocked, the sempahore remains in the signalled state
-//	
-
-//##ModelId=3DE6123B027F
-BOOL CSemaphore::Signal( int Increment)	const	// value by which sempahore increases (default is 1)
-{											// return TRUE/FALSE on Success/Failure
-	BOOL Success = ReleaseSemaphore( SemaphoreHandle, Increment, NULL) ; 
-	PERR( Success == TRUE, string("Cannot Signal Semaphore: ") + SemaphoreName + string("\nMaxmimum Value may have been exceeded")) ;	// check for error and print message if appropriate
-	return Success ;
-}
-
-
-
-//
-//	This function reads the value of a Semaphore, without signalling or waiting on it
-//	it can be used to poll the value of the Semaphore to perhaps determine if it is safe to
-//	perform a wait without getting suspended/blocked
-//	returns WAIT_FAILED if there was an error	
-//
-//	If the Semaphore has been signalled, then this function returns TRUE
-//	if the Semaphore has NOT been signalled, then this function returns FALSE
-//
-
-
-//##ModelId=3DE6123B0289
-UINT CSemaphore::Read() const	// Handle of the semaphore needed
-{												// returns current value of semaphore
-	BOOL Signalled ;
-
-	// first wait for the object. Timeout is zero, so function
-	// should immediately wait and decrement the sempahores value if it is signalled (i.e. >1)
-	
-	Signalled = WaitForSingleObject(SemaphoreHandle, 0) ;	// see of semaphore is signalled or not
-	PERR( Signalled != WAIT_FAILED, string("Cannot Read Semaphore: ") + SemaphoreName ) ;	// check for error and print message if appropriate	
-	
-	// Now if we did a wait and managed to decrement the semaphore, then
-	// the above function call should have returned WAIT_OBJECT_0, thus the process
-	// of attempting to read the semaphore has unfortunately resulted in its value
-	// being decremented, so we have to put that write by signalling it again. This should be
-	// safe, since we cannot exceed the limits of the sempahores max value as we are
-	// only putting it back to what it was before we attempted this
-	//
-	//	In the process of putting it back, we also get the value of the semaphore as
-	//	a bonus (+1 added to make sure it the value before be decremented it
-	//
-	//	You might well ask why we cannot simply just use ReleaseSemaphore and specify an
-	//	increment of 0 in place of all this code, so that the sempahore doesn't change at all
-	//	but we get the previous value back. That is what we are after in the end isn't it ?
-	//	The answer is that it work in Windoes 95/98 but not on NT which insists
-	//	on having a release value > 0 and thus doesn't have a future in windows 2000
-
-	if(Signalled == WAIT_OBJECT_0)	{
-		LONG Prev ;		// to hold the previous value of the semapahore
-		BOOL Success = ReleaseSemaphore(SemaphoreHandle, 1, &Prev) ;
-		PERR( Success == TRUE, string("Cannot Signal Semaphore") + SemaphoreName ) ;	// check for error and print message if appropriate
-		return (UINT)(Prev+1) ;	// returns true if semaphore signalled
-	}
-
-	else if(Signalled == WAIT_TIMEOUT)	// the operation timed-out and the sempahore is not-signalled
-		return (UINT)0 ;				// non-signalled
-
-	else
-		return WAIT_FAILED ;			// error, possibly invalid handle
-
-}
-
-
-//
-//	The following function can be used to prevent DEADLOCK in a multi-threaded
-//	application where several thread/processes are competing to acquire resources
-//
-//	For example consider two processes A and B, both waiting for both resources X and Y.
-//	If Process A manages to acquire X (via a wait on it Mutex) and Process B acquires Y (via its mutex)
-//	and then both A and B try to acquire the other resource that is now owned by the other
-//	process, a deadlock arises, where each process blocks the other.
-//
-//	One way around this would be for one or other process to release its currently owned resource
-//	and try again some short time later and hope that it then successful in acquiring
-//	both resources, but you can never be sure and its not a good solution in real-time systems
-//
-//	Windows therefore provides this function to allow a thread/process to simply wait until
-//	all the resources it requires are free, and then grab them all in one indivisible
-//	operation, that is, no other thread can grab half of them while this is going on
-//
-//	In essence, the function simply requires an array of HANDLES. These handles 
-//	are the handles to objects such as mutex's, semaphores, events etc that protect a required resource.
-//	If the objects have been signalled, then they are free and not owned by a thread.
-//	This function will wait until all handles are in their signalled state and then acquire
-//	them by setting them back to their non-signalled state (as it you had done a wait on them)
-//	thus preventing other threads from acquiring them.
-//	Of course you have to remember to release the resource EACH resource when you have finished
-//
-//	This function returns WAIT_FAILED if there was an error or WAIT_TIMEOUT if the wait operation timed out
-//
-
-UINT	WAIT_FOR_MULTIPLE_OBJECTS(	UINT nCount,             // number of handles in the handle array
-									CONST HANDLE *lpHandles,  // pointer to the object-handle array
-									DWORD Time
-								)
-{
-	UINT Result = WaitForMultipleObjects(nCount, lpHandles, TRUE, Time) ;
-	PERR( Result != WAIT_FAILED, string("Cannot Wait for Multiple Objects")) ;	// check for error and print message if appropriate
-	return Result;
-}
-
-
-///////////////////////////////////////////////////////////////////////
-// Example
-//////////////////////////////////////////////////////////////////////
-/*
-
-#include <stdio.h>
-#include "rt.h"
-  
-int main()
-{
-	...
-	...
-	CSemaphore c1(.....) , c2(.....) ;					// two sempahore objects
-	CEvent		e1(.....), e2(.....) ;					// two event objects
-
-	
-	HANDLE	hArray[4] = {c1.GetHandle(), c2.GetHandle(), e1.GetHandle(), e2.GetHandle() } ;
-	
-	WAIT_FOR_MULTIPLE_OBJECTS(4,hArray) ;	// wait for all objects
-
-	...
-	...
-	return 0 ;
-}
-
-*/
-
-//////////////////////////////////////////////////////////////////////////////////////////////////////
-//	PIPELINE Functions
-//	
-//	The following functions are C++ member function for the CPipe class
-//	See example usage later, after the code for all the functions has been shown
-//////////////////////////////////////////////////////////////////////////////////////////////////////
-//
-//	This is the constructor to create a Pipeline object. All you need is the name of the pipeline
-//	The size of the pipeline is controlled by the '__PIPESIZE__' constant in the "rt.h" header file
-//
-//	Note that this function will attempt to create the pipeline and then open it. If the pipeline already exists
-//	then it does not create it, it simply opens it
-//	
-//	In this implementation, the pipeline will be destroyed when both reading and writing process
-//	terminate
-//
-
-
-//##ModelId=3DE6123C03AB
-CPipe::CPipe(const string &Name, UINT SizeOfPipe) :PipeName(Name)
-{
-	// check the pipeline meets minimum size requirements of 2 bytes
-
-	if(SizeOfPipe < 1)	{
-		printf("Sorry Pipeline size is too small, Minimum is 1 byte.\n") ;	// check for error and print error message as appropriate
-		getchar() ;
-		exit(0) ;
-	}
-
-
-	const string PipeName = "__PipeLine__" + Name;
-	const string PipeDataName = "__PipeLineData__" + Name;
-	const string MutexName = "__PipelineMutex__" + Name;
-	const string ProdSemaName = "__PipelineProducerSemaphore__" + Name;
-	const string ConSemaName = "__PipelineConsumerSemaphore__" + Name;
-		
-	////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-	// now create the pipeline as a small data pool based around the contents of the struct PipeContents 
-	////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-
-	hPipe = CreateFileMapping((HANDLE)0xFFFFFFFF, 
-						NULL, 
-						PAGE_READWRITE,
-						0,
-						sizeof(PIPECONTROL),
-						(char *)(PipeName.c_str())
-	) ;
-	
-	PERR(hPipe != NULL, string("Cannot Make Datapool For Pipeline ") + Name) ;	// check for error and print error message as appropriate
-	
-	PipePointer = (PIPECONTROL *)MapViewOfFile(
-		hPipe,						// file-mapping object to map into 
-									// address space
-		FILE_MAP_WRITE ,
-		0,							// high-order 32 bits of file offset
-		0,							// low-order 32 bits of file offset
-		0							// number of bytes to map, 0 means all
-	) ;
-
-
-	PERR(PipePointer != NULL, string("Cannot Make Datapool For Pipeline ") + Name) ;	// check for error and print error message as appropriate
-	
-	if(PipePointer == NULL)		{
-		CloseHandle(hPipe) ;	// close datapool handle
-		exit(0) ;
-	} 
-
-
-	/////////////////////////////////////////////////////////////////////////////////////////////
-	// now a datapool for the data in the pipeline itself
-	/////////////////////////////////////////////////////////////////////////////////////////////
-
-	hData = CreateFileMapping((HANDLE)0xFFFFFFFF, 
-						NULL, 
-						PAGE_READWRITE,
-						0,
-						sizeof(SizeOfPipe),
-						(char *)(PipeDataName.c_str())
-	) ;
-	
-	PERR(hData != NULL, string("Cannot Make Datapool For Pipeline ") + Name) ;	// check for error and print error message as appropriate
-	
-	DataPointer = (BYTE *)MapViewOfFile(
-		hData,						// file-mapping object to map into 
-									// address space
-		FILE_MAP_WRITE ,
-		0,							// high-order 32 bits of file offset
-		0,							// low-order 32 bits of file offset
-		0							// number of bytes to map, 0 means all
-	) ;
-
-
-	PERR(DataPointer != NULL, string("Cannot Make Datapool For Pipeline ") + Name) ;	// check for error and print error message as appropriate
-	
-	if(DataPointer == NULL)		{
-		CloseHandle(hPipe) ;	// close datapool handle
-		CloseHandle(hData) ;
-		exit(0) ;
-	}
-
-
-	// create mutex name for this pipeline and create the producer and consumer semaphores
-
-	pMutex = new CMutex(MutexName) ;
-	pProdSemaphore = new CSemaphore(ProdSemaName,  0, SizeOfPipe) ;					// create semaphore NOTE value of 0
-	pConSemaphore = new CSemaphore(ConSemaName, SizeOfPipe, SizeOfPipe) ;		// create semaphore note value of SizeofPipe
-
-	// now allocate some storage for the datapool and initialise the pointers which are all in the datapool
-	// for cross process communication
-
-	pMutex->Wait() ;
-	if(PipePointer->Initialised != 0x4afc)	{		// if datapool not initialised
-		PipePointer->Initialised = 0x4afc ;			// show as being initialised
-		PipePointer->ReadingIndex = 0 ;		
-		PipePointer->WritingIndex = 0 ;
-		PipePointer->NumBytes = 0 ;
-		PipePointer->SizeOfPipe = SizeOfPipe ;
-	}
-	else	{	// if it is initialised, make sure the size was specified the same in all processes creating it
-		PERR( SizeOfPipe == PipePointer->SizeOfPipe, string("Size of Pipeline Name:") + PipeName + string(" Conflicts with size already specified by another process"));	// check for error and print error message as appropriate
-		if(SizeOfPipe != PipePointer->SizeOfPipe)	{
-			CloseHandle(hPipe) ;	// close datapool handles
-			CloseHandle(hData) ;
-			exit(0);
-		}
-	}
-
-	pMutex->Signal() ;
-}
-
-
-
-//the constant __PIPESIZE__ in rt.h header file, 
-//currently set to 1024 bytes
-
-//##ModelId=3DE6123C03B5
-CPipe::~CPipe()
-{
-	pMutex->Wait() ;
-
-	if(PipePointer->NumBytes == 0)	{			// if no data in pipeline
-		PipePointer->Initialised = 0 ;			// show pipeline as uninitialised
-
-		BOOL Success = UnmapViewOfFile(PipePointer) ;	// unlink from data pool view
-		PERR( Success == TRUE, string("Cannot Destroy Datapool Object for Pipeline: ") + PipeName);	// check for error and print error message as appropriate
-
-		Success = CloseHandle(hPipe) ;	// close handle to pipeline
-		PERR( Success == TRUE, string("Cannot Destroy Datapool Object for Pipeline: ") + PipeName);	// check for error and print error message as appropriate
-
-		Success = UnmapViewOfFile(DataPointer) ;	// unlink from data pool view
-		PERR( Success == TRUE, string("Cannot Destroy Datapool Object for Pipeline: ") + PipeName);	// check for error and print error message as appropriate
-
-		Success = CloseHandle(hData) ;	// close handle to pipeline
-		PERR( Success == TRUE, string("Cannot Destroy Datapool Object for Pipeline: ") + PipeName);	// check for error and print error message as appropriate
-	
-	}
-
-	pMutex->Signal() ;
-
-	delete pMutex ;
-	delete pConSemaphore ;
-	delete pProdSemaphore ;
-}
-
-
-//
-//	This functions handles writing data to a pipeline. All you need is the address of the programs
-//	data that is to be transferred to the pipline, and the size of that data. The write function takes
-//	care of the rest. Note that a process/thread writing to a full pipeline will be suspended until
-//	the process at the other end of the pipeline reads some out
-//
-
-//##ModelId=3DE6123C03CA
-BOOL CPipe::Write(void *Data, UINT Size)	// producer process
-{
-	//  transfer data from application address to pipeline and update the writing pointers
-
-	LPBYTE	Addr = (LPBYTE)(Data) ;		// cast from void to byte pointer
-	
-	for(UINT i = 0; i < Size; i ++)	{
-		pConSemaphore->Wait() ;	// make sure there is space in the pipeline, if not, suspend
-		pMutex->Wait() ;		// make sure no other process is using the pipeline, if not grab it
-
-		if(PipePointer->WritingIndex == PipePointer->SizeOfPipe)			// if we have GONE PAST the end of the pipeline buffer
-			PipePointer->WritingIndex = 0 ;									// reset it back to the start
-		
-		DataPointer[(PipePointer->WritingIndex)++] = *(BYTE *)(Addr++) ;	// store next byte
-		++ (PipePointer->NumBytes) ;										// Increment count of bytes in pipeline
-		
-		pMutex->Signal() ;													// release the process/thread blocking mutex
-		pProdSemaphore->Signal();											// wake it up after the write operation
-
-	}
-	return TRUE ;
-}
-
-//
-//	This functions handles reading data from a pipeline. All you need is the address of the programs
-//	data and the size of that data. The read function takes	care of the rest. 
-//	Note that a process/thread reading from an empty pipeline will be suspended until
-//	the process at the other end of the pipeline writes some in
-//
-
-//##ModelId=3DE6123C03B7
-BOOL CPipe::Read(void *Data, UINT Size) 
-{
-
-	//  transfer data from pipeline to application and update the reading pointers
-	//	if we attempt to overtake the writing process then suspend the thread. 
-	//	We will need a Mutex somewhere in here to avoid two processes accessing the pipeline 
-	//	at the same instant.
-
-	LPBYTE	Addr = (LPBYTE)(Data) ;								// cast from void to byte pointer
-
-	for(UINT i = 0; i < Size; i ++)	{
-		pProdSemaphore->Wait() ;								// make sure there is data to read in the pipeline, if not suspend
-		pMutex->Wait() ;										// make sure no other process is using the pipeline, if not grab it
-
-		if(PipePointer->ReadingIndex == PipePointer->SizeOfPipe)			// if we have GONE PAST the end of the pipeline buffer
-			PipePointer->ReadingIndex = 0 ;		// reset it back to the start
-		
-		*(BYTE *)(Addr++) = DataPointer[(PipePointer->ReadingIndex)++] ;		// read and store next byte
-		-- (PipePointer->NumBytes) ;							// decrement count of bytes in pipeline
-		
-		pMutex->Signal() ;									// release the process/thread blocking mutex
-		pConSemaphore->Signal() ;								// wake it up after the write operation
-
-	}
-	return TRUE ;
-}
-
-
-//
-//	This function returns the number of bytes in a pipeline
-//
-
-//##ModelId=3DE6123C03D5
-UINT CPipe::TestForData() const 
-{
-	pMutex->Wait() ;						// make sure no other process is using the pipeline, if not grab it
-	int NumBytesInPipe =  PipePointer->NumBytes ;
-	pMutex->Signal() ;						// make sure no other process is using the pipeline, if not grab it
-	return NumBytesInPipe ;
-}
-
-//
-//	Constructor creates a named datapool object with a 
-//specified size
-
-//##ModelId=3DE6123C01CB
-CDataPool::CDataPool(const string &Name, UINT size)
-	:DataPoolName(Name)
-{
-	DPInfo.DataPoolHandle = CreateFileMapping((HANDLE)0xFFFFFFFF, 
-						NULL, 
-						PAGE_READWRITE,
-						0,
-						size,
-						(char *)(Name.c_str())
-	) ;
-	
-	PERR(DPInfo.DataPoolHandle != NULL, string("Cannot Make Datapool: ") + Name) ;	// check for error and print error message as appropriate
-	
-	DPInfo.DataPoolPointer = MapViewOfFile(
-		DPInfo.DataPoolHandle,			// file-mapping object to map into 
-									// address space
-		FILE_MAP_WRITE ,
-		0,							// high-order 32 bits of file offset
-		0,							// low-order 32 bits of file offset
-		0							// number of bytes to map, 0 means all
-	) ;
-
-
-	PERR(DPInfo.DataPoolPointer != NULL,  string("Cannot Make Datapool: ") + Name) ;	// check for error and print error message as appropriate
-	
-	if(DPInfo.DataPoolPointer == NULL)	
-		CloseHandle(DPInfo.DataPoolHandle) ;	// close datapool handle
-}
-
-
-//
-//	This function unlinks from a datapools 'view', when the thread/process has finished using it
-//	call this only as many times as you Link to it
-//
-
-//##ModelId=3DE6123C01E0
-BOOL	CDataPool::Unlink()	const // DataPoolHandle obtained by calling Link_Datapool()
-{
-	BOOL Success = UnmapViewOfFile(DPInfo.DataPoolPointer) ;	// unlink from data pool view
-	PERR( Success == TRUE, string("Cannot UnLink from Datapool: ") + DataPoolName ) ;		// check for error and print error message as appropriate
-
-	Success = CloseHandle(DPInfo.DataPoolHandle) ;
-	PERR( Success == TRUE, string("Cannot UnLink from Datapool: ") + DataPoolName ) ;		// check for error and print error message as appropriate
-
-	return Success ;
-}
-
-
-////////////////////////////////////////////////////////////////////////////////////////////////////
-//	This example makes a datapool and puts value into it
-/*
-
-#include <stdio.h>
-#include "rt.h"
-  
-struct test {
-		int floor;
-		int direction ;
-		int floors[1000] ;
-} ;
-
-int main()
-{
-	...
-	...
-	DATAPOOLINFO dp = MAKE_DATAPOOL("Car1", sizeof(struct test)) ;
-	
-	// check the validity of the above operation
-
-	if(dp.DataPoolHandle == NULL || dp.DataPoolPointer == NULL)	{
-		perror("Cannot make Datapool \n") ;
-		EXIT_PROCESS(0) ;
-	}
-
-  // now get the datapool pointer from the DATAPOOLINFO object 'dp' and cast it to a 'struct test' pointer
-	
-	struct test *MyDataPool = (struct test *)(dp.DataPoolPointer) ;
-
-
-	// put data into the datapool
-
-	MyDataPool->floor = 55 ;
-	MyDataPool->direction = 11 ;
-
-	printf("Floor = %d\n", MyDataPool->floor);
-	printf("Direction = %d\n", MyDataPool->direction) ; ;
-
-	for(int i = 0; i < 1000; i ++)
-		MyDataPool->floors[i] = i ;
-
-	UNLINK_DATAPOOL(dp) ;				// this call indicates the process has finished using the datapool
-										// if no other process are using it, then the O.System will remove it
-										// automatically.
-	return 0 ;
-}
-////////////////////////////////////////////////////////////////////////////////////////////////*/
-
-
-////////////////////////Message/Signal Functions///////////////////////////////////////////////
-//	Call this function to force windows to create a message queue for the process/thread
-//	The queue will only be created the 1st time it is called, so it can be called many times
-//	without problem. If you have multiple threads, then each can create its own message queue
-//	to deal with messages sent to it
-//
-//	An example of the use of messages and timers can be seen further down the file after
-//	the functions have been discussed
-//////////////////////////////////////////////////////////////////////////////////////////////
-
-//##ModelId=3DE6123B035A
-CMailbox::CMailbox()
-{
-	MSG	MessageBuff ;			// tempory buffer for use with PeekMessage Below
-
-	PeekMessage(&MessageBuff, NULL, WM_USER, WM_USER, PM_NOREMOVE) ;
-}
-
-//
-//	This function will suspend the current thread until the arrival of a message, the thread
-//	can then access the message using GET_USER_MESSAGE(). In order to use messages, the thread
-//	must have created a message queue. (See Create_User_Message_Queue() above )
-//	
-//	Once a message has been received, you must read it to remove it 
-//
-
-//##ModelId=3DE6123B035B
-void CMailbox::WaitForMessage() const
-{
-	BOOL Success = WaitMessage() ;
-	PERR( Success != 0, string("Unable to Wait For Message from Message Queue"))	;
-}
-
-//
-//	This function looks into the thread message queue to determine if there are any user messages
-//	that can be read. If the function returns TRUE, then at least one message exists. In order to use messages, the thread
-//	must have created a message queue. (See Create_User_Message_Queue() above )
-//
-//	Note that the header file 'rt.h' supplies default arguments for the parameters MinMessageValue and MaxMessageValue
-//	this means that you do not have to supply any arguments of your own when you call TEST_FOR_MESSAGE(), in which case
-//	the function tests to see if ANY message has been sent to the thread regardless of its value.
-//
-//	However, you can test for tha arrival of messages within a specified range by supplying the min and max values
-//	If you supply these arguments, then the function TEST_FOR_MESSAGE() tests for the existence of a message
-//	in the message queue that falls within the bounds of Min and MaxMessage Value (inclusive)
-//
-
-//##ModelId=3DE6123B0365
-BOOL CMailbox::TestForMessage(UINT MinMessageValue, UINT MaxMessageValue) const
-{
-	MSG	MessageBuff ;
-	return PeekMessage(&MessageBuff, NULL, WM_USER+MinMessageValue, WM_USER + MaxMessageValue, PM_NOREMOVE) ;
-}
-
-//
-//	This function retrives a message from the threads message queue. 
-//
-
-//##ModelId=3DE6123B0370
-UINT	CMailbox::GetMessage(UINT MinMessageValue, UINT MaxMessageValue) const
-{
-	MSG	Message ;
-	LPMSG	Mess = &Message ;
-	BOOL Result = ::GetMessage(Mess, NULL, WM_USER+MinMessageValue, WM_USER+MaxMessageValue) ;
-	PERR( Result != -1, string("Could Not Get Message from Message Queue")) ;	// check for error and print error message as appropriate
-	return Message.message - WM_USER ;
-}
-
-
-//
-//	This function sets up a timer to go off at the specified time interval.
-//	The system posts WM_TIMER signals/messages to the thread that sets the timer, thus it's probably
-//	a good idea to have a separate thread for each timer that you need, each thread can then
-//	carry out one action in repsonse to one timer.
-//	
-//	In order for a thread to deal with or intercept messages from timers or messages in general
-//	it must have created a message queue, see the function CREATE_MESSAGE_QUEUE() or 
-//	CMessageQueue class
-//
-//	Note: A thread can suspend itself waiting for a timer using the WAIT_FOR_TIMER() function, 
-//	which removes the timer message from the message queue when it arrives and wakes up the thread
-//
-//	Note that timers are repetitive and continue to go at the specified time interval
-//	until Stopped with the Stop() function
-//
-
-//##ModelId=3DE6123C00BC
-
-CTimer::CTimer() 	// Constructor 1: Create the Timer but don't set it running, use SetTimer() later to start timer
-	: TimerID(0)	// sets the timer id to 0
-{}	
-
-
-// create a running timer
-//	If callbackfn is not supplied or is NULL, then timer 
-//posts messages to the threads message queues
-//	if callbackfn is supplied, then the callback function 
-//is invoked rather than a message being sent to the 
-//threads message queue
-//##ModelId=3DE6123C00BD
-CTimer::CTimer(UINT Timer, TIMERPROC callbackfn) 	// create a running timer that uses call backs rather than messages
-	: TimerID(0)
-{
-	TimerID = SetTimer(Timer, callbackfn) ;
-}
-
-
-//##ModelId=3DE6123C00C7
-CTimer::~CTimer() {						// destructor tidies up by killing the timer so that
-	if(TimerID != 0)					// no longer posts timer messages to the thread
-		StopTimer(); 						// kill timer
-}
-
-
-//	Setup timer to go off at the specified rate in mSec
-//	If callbackfn is not supplied or is NULL, then timer 
-//posts messages to the threads message queue
-//	if callbackfn is supplied, then the callback function 
-//is invoked rather than a message being sent to the 
-//threads message queue
-//##ModelId=3DE6123C00D1
-UINT CTimer::SetTimer(UINT Timer, TIMERPROC callbackfn)
-{
-	if(TimerID != 0)						// if timer already running
-		StopTimer() ;						// kill it i.e. stop it
-	
-	TimerID = ::SetTimer(NULL, 0, Timer, callbackfn) ;
-	PERR( TimerID != 0, string("Error Could NOT  Set Timer")) ;	// check for error and print error message as appropriate
-
-	return TimerID ;		// TRUE if timer successfully set, FALSE otherwise
-}
-
-//##ModelId=3DE6123C00DB
-BOOL CTimer::TestForTimer()  				// returns TRUE if timer gone off and posted message
-{
-	MSG	MessageBuff ;
-	return PeekMessage(&MessageBuff, NULL, WM_TIMER, WM_TIMER, PM_REMOVE) ; 
-}
-
-//##ModelId=3DE6123C00D0
-BOOL CTimer::StopTimer()		// kills a timer so that it no longer posts timer messages to thread
-{ 
-	BOOL Success = ::KillTimer(NULL, TimerID) ;
-	PERR( Success == TRUE, string("Error Could Not Kill Timer")) ;	// check for error and print error message as appropriate
-	TimerID = 0 ;
-
-	return Success ;
-}
-
-//##ModelId=3DE6123C00E4
-void CTimer::WaitForTimer()
-{
-	MSG	MessageBuff ;
-
-	do {
-		WaitMessage() ;		// for any message
-	}while(!GetMessage(&MessageBuff, NULL, WM_TIMER, WM_TIMER)) ; // is it WM_TIMER
-}
-	
-
-//
-//	This function suspends the current thread until the specified time has elapsed
-//	This allows other processes with the same priority to run. Co-operative processing
-//	can be implemented with the help of this function,as processes voluntarily relinquish
-//	control of the CPU. If the delay is 0, the processes simply gives up the remainder of
-//	its CPU time. If the value is 'INFINITE', then the process waits forever. 
-//	If the delay is somewhere inbetween, the process is suspended for the duration specified
-//	sending it a message will not wake it up prematurely.
-//
-
-void	SLEEP(UINT	Time) 
-{
-	Sleep(Time) ;
-}
-
-//
-//	This function tests the keyboard to see if a key has been pressed. If so, the value TRUE is
-//	returned and the thread can read the character without getting suspended using a function
-//	such as _getch(), _getche() etc.
-//
-
-BOOL	TEST_FOR_KEYBOARD()
-{
-	return _kbhit() ;
-}
-
-
-//
-//	These functions returns handles to a console standard input/output and error device
-//	i.e. keyboard, screen and screen respectively. NULL is returned on error
-//	For more example of console functions read the Vis C++ Help/Win32 functions by category/console functions
-//
-
-HANDLE	GET_STDIN()
-{
-	return GetStdHandle(STD_INPUT_HANDLE) ;
-}
-
-HANDLE	GET_STDOUT()
-{
-	return GetStdHandle(STD_OUTPUT_HANDLE) ;
-}
-
-HANDLE	GET_STDERR()
-{
-	return GetStdHandle(STD_ERROR_HANDLE) ;
-}
-
-//
-//	This function pauses the thread/process until user input is entered at the keyboard
-//
-//	This function returns WAIT_FAILED if there was an error, WAIT_TIMEOUT if the wait operation timed out
-//	of WAIT_OBJECT_0 if the operation did in fact wait and then returned
-//
-
-UINT WAIT_FOR_CONSOLE_INPUT(HANDLE hEvent, DWORD Time)
-{
-	UINT	Status = WaitForSingleObject(hEvent, Time) ;
-	PERR( Status != WAIT_FAILED, string("Cannot Wait for Console Input")) ;	// check for error and print message if appropriate
-	return Status ;
-}
-
-//	moves the cursor to the x,y coord on the screen. [0,0] is top left
-//	all calls to printf cause output to occur at the current cursor position
-//	obviously, the cursor moves with text output operations
-
-void MOVE_CURSOR(int x, int y)
-{
-	COORD	c = {(short)x, (short)y}  ;
-	SetConsoleCursorPosition(GET_STDOUT(), c) ;
-}
-
-//
-//	These two function turns off/on the cursor so that it is not visible
-//	but it still operates and output text still occurs at the current curso
-//	position
-//
-
-void CURSOR_OFF()
-{
-	CONSOLE_CURSOR_INFO	cci = {1, FALSE} ;
-	SetConsoleCursorInfo(GET_STDOUT(), &cci) ;
-}
-
-void CURSOR_ON()
-{
-	CONSOLE_CURSOR_INFO	cci = {1, TRUE} ;
-	SetConsoleCursorInfo(GET_STDOUT(), &cci) ;
-}
-
-//
-//	These two functions turns on/off reverse video, so that text comes black on white background
-//	For more details set the SetConsoleTextAttribute() function in on-line
-//	help
-//
-
-void REVERSE_ON()
-{
-	SetConsoleTextAttribute(GET_STDOUT(), 
-		BACKGROUND_RED | BACKGROUND_GREEN | BACKGROUND_BLUE) ;
-}
-
-void REVERSE_OFF()
-{
-	SetConsoleTextAttribute(GET_STDOUT(), 
-		FOREGROUND_RED | FOREGROUND_GREEN | FOREGROUND_BLUE) ;
-}
-
-void CLEAR_SCREEN()
-{
-	for(int i = 0; i < 50; i ++)
-		putchar('\n') ;
-}
-
-/*Contains a function to change the text colour.
-
-  To Use:
-
-  This function takes 2 arguments, foreground and background.
-  foreground and background select one of 15 colours numbered as follows:
-
-  0 - Black
-  1 - Dark Blue
-  2 - Dark Green
-  3 - Dark Cyan
-  4 - Dark Red
-  5 - Dark Magenta
-  6 - Dark Yellow
-  7 - Grey
-  8 - Black (again)
-  9 - Blue
-  10 - Green
-  11 - Cyan
-  12 - Red
-  13 - Magenta
-  14 - Yellow
-  15 - White
-
-  Note... background and foreground cannot be the same value, and an
-  error (-1) will be returned.
-
-  If colours are valid, and operation was successful, 0 will be returned.
-
-  Use TEXT_COLOUR with no arguements to return values to default.
-
-  A foreground colour only can be specified, eg TEXT_COLOUR(4) will make text dark red .*/  
-
-int TEXT_COLOUR(unsigned char foreground, unsigned char background)
-{
-	if ((foreground>15)||(foreground<0)||(background>15)||(background<0)||(background==foreground))
-	{
-		return -1;
-	}
-	int colour=0;
-	background=background<<4;
-	colour=colour|background|foreground;
-	SetConsoleTextAttribute(GET_STDOUT(), colour);
-	return 0;
-}
-
-
-void flush(istream &is)		// can be used to flush an input stream, useful for removing operator entered rubbish
-{
-	is.clear() ;
-	streambuf  *ptr = is.rdbuf() ;		// get pointer to stream buffer
-	int avail = ptr->in_avail() ;			// get number of chars waiting to be read
-	is.ignore(avail) ;						// ignore this many characters
-	is.clear() ;
-}
-
-void PERR(bool bSuccess, string ErrorMessageString)
-{		
-	UINT LastError = GetLastError() ;
-
-	if(!(bSuccess)) {
-		char buff[512] ;
-		Beep(500, 100);
-		MOVE_CURSOR(0,0) ;
-		REVERSE_ON() ;
-		FormatMessage( FORMAT_MESSAGE_FROM_SYSTEM, NULL, LastError,
-		MAKELANGID(LANG_NEUTRAL, SUBLANG_DEFAULT), buff, 1024, NULL );
-		printf(" Error %d in Process %s: line %d:\n", LastError, __FILE__, __LINE__);
-		printf(" Translation: %s Error: %s", buff, ErrorMessageString.c_str()) ;
-		REVERSE_OFF() ;
-		printf("\n\nPress Return to Continue...") ;
-		_getch();
-	}
+///////////////////////////////////////////////////////////////////////////////////////////////
+//	Notes for using this code on Microsofts Visual C++ V6.0
+//
+//	If you have trouble linking the program, with errors relating to
+//	_beginthreadex() undefined or similar, then see the project settings options in your handout
+//	on creating concurrent software using Visual C++
+///////////////////////////////////////////////////////////////////////////////////////////////
+
+
+//#include <StdAfx.h>		// delete this line if you are NOT using Microsoft MFC in your project
+						// for example, delete this line if you are creating a Console project
+						// but if you are creating a GUI or window type application, leave it in
+
+// NOTE You will have to change the pathlist to the 'rt.h' header file below to indicate
+// to the compiler where it can find this file. This will of course depend upon where it resides
+// on your computer i.e. where you copied it to.
+
+#include "rt.h"
+#include <algorithm>
+#include <cstdarg>
+#include <iomanip>
+#include <map>
+#include <new>
+#include <sstream>
+#include <vector>
+
+// constructor to create a child process, takes four 
+//arguments, note that the last 3 make use
+//	of default argument, that is, if you do not supply 
+//real arguments in the call, then the default values will
+//	be used for the ones you do NOT supply
+//	this means that wehn you create a new CProcess object, 
+//the only argument you HAVE to supply is the Name of the 
+//executable
+//	all other values can be supplied by default
+
+//##ModelId=3DE6123A0037
+CProcess::CProcess(	
+		const string &Name,		// path/name of executable program (.exe)
+		int Priority,			// Priority of the process
+		BOOL bUseNewWindow,		// use OWN_WINDOW to make new process run in its own window
+								// use PARENT_WINDOW to make it share its parent window
+		BOOL bCreateSuspended,	// use SUSPENDED to make new child process's main thread suspended when process is created
+								// use ACTIVE to make new child processes main thread active when process iscreated
+		
+		const string &ChildProcessArgString)
+
+		: ProcessName(Name)
+{
+	// Check priority level is valid
+
+	
+
+	PERR((	(Priority == HIGH_PRIORITY_CLASS) ||
+			(Priority == IDLE_PRIORITY_CLASS) ||
+			(Priority == NORMAL_PRIORITY_CLASS) ||
+			(Priority == REALTIME_PRIORITY_CLASS)) ,
+			string("Illegal 2nd Argument (Process Priority) for Process: ") + Name) ;
+
+	
+	PERR ((bUseNewWindow == OWN_WINDOW || bUseNewWindow == PARENT_WINDOW), 
+		string("Use OWN_WINDOW or PARENT_WINDOW as 3rd argument for Process: ") + Name ) ;
+	PERR ((bCreateSuspended == SUSPENDED || bCreateSuspended == ACTIVE), 
+		string("Use SUSPENDED or ACTIVE as 4th Argument for Process: ") + Name) ;
+
+
+	STARTUPINFO	StartupInfo = {
+		sizeof(STARTUPINFO) ,
+		NULL ,			// reserved
+		NULL ,			// ignored in console applications
+		(char *)(Name.c_str()) ,	// displayed in title bar for console applications
+		0,0,			// dwx, dwy, offset of top left of new window relative to top left of screen in pixel
+						// flags below must specify STARTF_USEPOSITION. Ignored for console apps'
+		0,0,			// dwxsize, dwysize: Width and height of the window if new window specified
+						// must use flags STARTF_USESIZE. Ignored for console apps'
+		0,0,			// size of console in characters, only if STARTF_USECOUNTCHARS flag specified, 
+						// Ignored for console apps
+		0,				// Colour control, for background and text. Ignored for console apps
+		0,				// Flags. Ignored for console applications
+		0,				// ignored unless showwindow flag set
+		0 ,
+		NULL,
+		0,0,0			// stdin, stdout and stderr handles (inherited from parent)
+	} ;
+
+	UINT flags = Priority ; // Priority,
+
+	if(bUseNewWindow == OWN_WINDOW)		// if caller has specified that child should have its won window
+		flags |= CREATE_NEW_CONSOLE ;
+	
+	if(bCreateSuspended == SUSPENDED)	// if caller has specified that child process should be immediately suspended
+		flags |= CREATE_SUSPENDED ;
+
+	string CommandLine = Name ;			// arguments follow the program name, as main() expects
+	if(ChildProcessArgString != "")
+		CommandLine += string(" ") + ChildProcessArgString ;
+
+	BOOL Success = CreateProcess(	NULL,	// application name
+					(char *)(CommandLine.c_str()),	// Command line to the process if you want to pass one to main() in the process
+					NULL,			// process attributes
+					NULL,			// thread attributes
+					TRUE,			// inherits handles of parent
+					flags,			// Priority and Window control flags,
+					NULL,			// use environent of parent
+					NULL,			// use same drive and directory as parent
+					&StartupInfo ,	// controls appearance of process (see above)
+					&pInfo			// Stored process handle and ID into this object
+	); 
+	PERR( Success == TRUE, string("CProcess Call Unable to Create New Process: ") + Name) ;	// check for error and print message if appropriate
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////
+//	The following function can be used to change the 'base' priority of a process once it has been
+//	created (irrespective of whether it is active or suspended. Processes with higher priority
+//	will block/stop processes with lower priority from executing so be careful
+//
+//	All you need is the handle for the process obtained from FORK_PROCESS() (see above)
+//	Windows NT has a limited number of thread priorities and the following symbolic
+//	constants can be used as a valid value for the parameter 'Priority' in the function
+//	Normally a thread will inherit a 'base' priority from its parent thread, or, if it is
+//	the primary thread, from its parent process (See FORK_PROCESS() above
+//	The constant below simply allow you to make small adjustments to these value
+/////////////////////////////////////////////////////////////////////////////////////////////
+//
+//	HIGH_PRIORITY_CLASS		Specify this class for a process that performs time-critical tasks that must be executed immediately. The threads of the process preempt the threads of normal or idle priority class processes. An example is Windows Task List, which must respond quickly when called by the user, regardless of the load on the operating system. Use extreme care when using the high-priority class, because a high-priority class application can use nearly all available CPU time. 
+//	IDLE_PRIORITY_CLASS		Specify this class for a process whose threads run only when the system is idle. The threads of the process are preempted by the threads of any process running in a higher priority class. An example is a screen saver. The idle-priority class is inherited by child processes. 
+//	NORMAL_PRIORITY_CLASS	Specify this class for a process with no special scheduling needs. 
+//	REALTIME_PRIORITY_CLASS Specify this class for a process that has the highest possible priority. The threads of the process preempt the threads of all other processes, including operating system processes performing important tasks. For example, a real-time process that executes for more than a very brief interval can cause disk caches not to flush or cause the mouse to be unresponsive. 
+//
+//	Returns TRUE on Success/False on failure
+//
+
+//##ModelId=3DE6123A009C
+BOOL CProcess::SetPriority(int Priority) const
+{
+	BOOL Success;
+
+	// Check priority level 
+
+	PERR(((Priority == HIGH_PRIORITY_CLASS) || (Priority == IDLE_PRIORITY_CLASS) ||
+			(Priority == NORMAL_PRIORITY_CLASS) || (Priority == REALTIME_PRIORITY_CLASS)) ,
+			string("Illegal Priority value in call to SetPiority()")) ;
+
+	Success = SetPriorityClass(GetProcessHandle(), Priority) ;
+	PERR( Success == TRUE, string("Unable to Set Thread Priority of Process: ") + ProcessName) ;	// check for error and print error message as appropriate
+	
+	return Success ;
+}
+
+//
+//	These two functions can be called to suspend and resume a processes activity. 
+//	Actually, it suspend/resumes the process primary thread and not necessarily any
+//	other child threads it may have. Once suspended	the thread will no longer 
+//	run and consume CPU time. Note that if you suspend a process more than once, 
+//	then it will require the appropriate number	of resumes to allow it to continue
+//
+//
+//	Returns TRUE on Success, FALSE on Failure
+//
+
+//##ModelId=3DE6123A007F
+BOOL CProcess::Suspend() const
+{
+	UINT	Result = SuspendThread(GetThreadHandle()) ;
+	PERR( Result != 0xffffffff, string("Cannot Suspend Process: ") + ProcessName) ;
+
+	if(Result != 0xffffffff)	// if no error
+		return TRUE ;
+	else
+		return FALSE ;
+}
+
+//##ModelId=3DE6123A0088
+BOOL CProcess::Resume() const
+{
+	UINT	Result = ResumeThread(GetThreadHandle()) ;
+	PERR( Result != 0xffffffff, string("Cannot Resume Process: ") + ProcessName) ;
+
+	if(Result != 0xffffffff)	// if no error
+		return TRUE ;
+	else
+		return FALSE ;
+}
+
+
+//
+//	Limits the child process to the processors whose bits are set in the mask, for example to keep
+//	processes that talk to each other through datapools and pipelines on one NUMA node, or apart
+//	on processors of their own. Start the process SUSPENDED and Resume() it afterwards so that it
+//	never runs anywhere else.
+//
+
+BOOL CProcess::SetAffinity(DWORD_PTR Mask) const
+{
+	BOOL Success = SetProcessAffinityMask(GetProcessHandle(), Mask) ;
+	PERR( Success == TRUE, string("Unable to Set Processor Affinity of Process: ") + ProcessName) ;
+
+	return Success ;
+}
+
+//
+//	These functions give the affinity masks to use with CProcess::SetAffinity(). Processors are
+//	counted among those this process is allowed to run on, and both functions count round so that
+//	any number of child processes can be spread over the processors or nodes in turn.
+//
+
+static DWORD_PTR PROCESS_MASK()
+{
+	DWORD_PTR ProcessMask = 0, SystemMask = 0 ;
+
+	if(!GetProcessAffinityMask(GetCurrentProcess(), &ProcessMask, &SystemMask) || ProcessMask == 0)
+		ProcessMask = 1 ;
+
+	return ProcessMask ;
+}
+
+int PROCESSORS()
+{
+	DWORD_PTR Mask = PROCESS_MASK() ;
+	int	Count = 0 ;
+
+	for(; Mask != 0; Mask &= Mask - 1)
+		Count ++ ;
+
+	return Count ;
+}
+
+DWORD_PTR PROCESSOR_MASK(int Processor)
+{
+	DWORD_PTR Mask = PROCESS_MASK() ;
+
+	for(int i = Processor % PROCESSORS(); i > 0; i --)
+		Mask &= Mask - 1 ;					// drop the lowest processors
+
+	return Mask & (~Mask + 1) ;				// and keep the next one
+}
+
+int NUMA_NODES()
+{
+	ULONG Highest = 0 ;
+
+	if(!GetNumaHighestNodeNumber(&Highest))
+		return 1 ;
+
+	return (int)(Highest) + 1 ;
+}
+
+DWORD_PTR NUMA_NODE_MASK(int Node)
+{
+	ULONGLONG NodeMask = 0 ;
+	DWORD_PTR Mask = PROCESS_MASK() ;
+
+	if(GetNumaNodeProcessorMask((UCHAR)(Node % NUMA_NODES()), &NodeMask) && (Mask & (DWORD_PTR)(NodeMask)) != 0)
+		Mask &= (DWORD_PTR)(NodeMask) ;		// otherwise the node has none of our processors, use them all
+
+	return Mask ;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//	This function waits for a child process to terminate provide it has been
+//	created as a CProcess Object. Or returns if the specified time elapses before the process has terminates
+//
+//	Note that if the child process has already terminated, when the call to wait for
+//	it is made, then this is deemed a success, NOT a failure and the function returns immediately without waiting
+//
+//	This function returns WAIT_FAILED if there was an error, WAIT_TIMEOUT if the wait operation timed out
+//	of WAIT_OBJECT_0 if the operation did in fact wait and then returned
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+//##ModelId=3DE6123A0092
+BOOL	CProcess::WaitForProcess(DWORD Time) const
+{
+	UINT Result = WaitForSingleObject(GetProcessHandle(), Time) ;	
+	PERR( Result != WAIT_FAILED, string("Cannot Wait for Child Process: ") + ProcessName + string(" to Terminate.\n It might already be dead")) ;	// check for error and print message if appropriate== WAIT_OBJECT_0 ) 
+
+	return Result ;
+}
+
+
+//	The following function sends a message to a process' main thread
+//	If the thread is currently suspended, waiting for a message, then posting it a message
+//	will wake it up and allow it to continue
+//
+//	The Message must be in the range 0 - 32000
+//	In order to receive messages, the thread receiving the message must have created a message queue.
+//	(See CMessageQueue later)
+//
+
+//##ModelId=3DE6123A00AF
+BOOL CProcess::Post(UINT Message) const	// message value and ID of thread
+{
+	BOOL Result ;
+
+	if(Message > 32000)	{
+		PERR( Message <= 32000, string("Could not Signal Process:") + ProcessName + string("\nReason: Message Value > 32000")) ;	// check for error and print error message as appropriate
+		return FALSE ;
+	}
+	else {
+		Result = PostThreadMessage(GetThreadId(), WM_USER + Message, 0, 0L) ;
+		PERR( Result != 0, string("Could not Signal Process:") + ProcessName + string("\nProcess May be Dead")) ;	// check for error and print error message as appropriate
+		return Result ;
+	}
+}
+
+//
+//	This calls standard exit() function to terminate the process
+//
+
+//##ModelId=3DE6123A00BA
+void CProcess::Exit(UINT ExitCode) const
+{
+	exit(ExitCode) ;
+}
+
+////////////////////////////////////////////////////////////
+//	Deterministic Scheduler Functions
+////////////////////////////////////////////////////////////
+//
+//	Normally every active class runs on its own Win32 thread and the order they run in, and so the
+//	order of everything they do, depends on the O.S. scheduler and on how long SLEEP() really takes.
+//	Two runs of the same program with the same input will not do things in the same order.
+//
+//	SET_DETERMINISTIC(TRUE, Seed) changes this for active classes resumed afterwards. Each one still
+//	has its own thread, but only one of them runs at a time. A thread runs until it calls SLEEP() or
+//	waits on a mutex, semaphore, event, condition or thread, then the thread with the earliest wake
+//	up time on a logical clock runs next. Ties are broken with RANDOM(), so the seed chooses the
+//	interleaving. SLEEP() moves the logical clock on instead of really sleeping, GET_TIME_US() returns
+//	the logical clock and a blocked wait checks its object again after a short logical delay. The same
+//	program, input and seed therefore always run in exactly the same order, as fast as the processor allows.
+//
+//	A CDeterministicScheduler object does the same for just the active classes resumed by the thread
+//	that created it, and the ones they resume in turn, each with its own logical clock and RANDOM()
+//	sequence. Several can run side by side on different threads, one per core, each running one
+//	self-contained simulation deterministically.
+//
+//	Threads created from a plain thread function and the program's primary thread are not scheduled
+//	and run as normal. Keyboard input, and CEvent::Signal() which only releases threads waiting at
+//	that instant, should not be relied on in deterministic mode.
+//
+
+#define	SCHEDULER_MAX_WAIT_POLL		16000		// longest logical time in microseconds between two tests of a blocked wait
+
+struct DeterministicScheduler ;
+
+struct DeterministicTask {
+	UINT		ThreadID ;		// thread of the active class
+	HANDLE		Wakeup ;		// auto-reset event the thread waits on until it is its turn to run
+	ULONGLONG	WakeTime ;		// logical time in microseconds the thread next wants to run at
+	DeterministicScheduler *Scheduler ;
+} ;
+
+struct DeterministicScheduler {
+	CriticalSection	Lock ;
+	vector<DeterministicTask *> Tasks ;		// scheduled threads in the order they were resumed
+	DeterministicTask *RunningTask ;		// the one scheduled thread allowed to run, NULL if none
+	ULONGLONG	LogicalTime ;				// microseconds since the scheduler was created
+	ULONGLONG	RandomState ;				// RANDOM() state for this scheduler's threads
+} ;
+
+static CriticalSection SchedulerRegistryLock ;
+static vector<DeterministicScheduler *> Schedulers ;			// every scheduler in the process
+static DeterministicScheduler *ProcessScheduler = NULL ;		// the one set up by SET_DETERMINISTIC()
+static PerThreadStorage DeterministicScheduler *ThreadScheduler = NULL ;	// set up by a CDeterministicScheduler on this thread
+static PerThreadStorage DeterministicTask *CurrentTask = NULL ;	// task of the calling thread, NULL if not scheduled
+
+static CriticalSection RandomLock ;
+static ULONGLONG RandomState = 0x9E3779B97F4A7C15ULL ;			// RANDOM() state outside any scheduler
+
+static ULONGLONG RANDOM_STATE(UINT Seed)
+{
+	return ((ULONGLONG)(Seed) << 32) ^ 0x9E3779B97F4A7C15ULL ;	// never zero, which xorshift cannot leave
+}
+
+static UINT NEXT_RANDOM(ULONGLONG &State)		// xorshift64*, caller holds the lock protecting State
+{
+	State ^= State >> 12 ;
+	State ^= State << 25 ;
+	State ^= State >> 27 ;
+	return (UINT)((State * 2685821657736338717ULL) >> 32) ;
+}
+
+static DeterministicScheduler *CURRENT_SCHEDULER()	// the scheduler the calling thread runs on or resumes threads into
+{
+	if(CurrentTask != NULL)
+		return CurrentTask->Scheduler ;
+	if(ThreadScheduler != NULL)
+		return ThreadScheduler ;
+	return ProcessScheduler ;
+}
+
+static DeterministicScheduler *NEW_SCHEDULER(UINT Seed)
+{
+	DeterministicScheduler *Scheduler = new DeterministicScheduler ;
+	Scheduler->RunningTask = NULL ;
+	Scheduler->LogicalTime = 0 ;
+	Scheduler->RandomState = RANDOM_STATE(Seed) ;
+
+	SchedulerRegistryLock.Enter() ;
+	Schedulers.push_back(Scheduler) ;
+	SchedulerRegistryLock.Leave() ;
+	return Scheduler ;
+}
+
+static DeterministicTask *NEXT_TASK(DeterministicScheduler *Scheduler)	// caller holds Scheduler->Lock, returns NULL if there are no tasks
+{
+	DeterministicTask *Next = NULL ;
+	UINT Ties = 0 ;
+
+	for(size_t i = 0; i < Scheduler->Tasks.size(); i ++)	{
+		DeterministicTask *Task = Scheduler->Tasks[i] ;
+		if(Next == NULL || Task->WakeTime < Next->WakeTime)	{
+			Next = Task ;
+			Ties = 1 ;
+		}
+		else if(Task->WakeTime == Next->WakeTime && NEXT_RANDOM(Scheduler->RandomState) % ++Ties == 0)	// pick evenly among equal wake times
+			Next = Task ;
+	}
+	return Next ;
+}
+
+static void RUN_TASK(DeterministicScheduler *Scheduler, DeterministicTask *Next)	// caller holds Scheduler->Lock
+{
+	Scheduler->RunningTask = Next ;
+
+	if(Next != NULL)	{
+		if(Next->WakeTime > Scheduler->LogicalTime)
+			Scheduler->LogicalTime = Next->WakeTime ;		// nothing else can happen before then
+		SetEvent(Next->Wakeup) ;
+	}
+}
+
+static DeterministicTask *FIND_TASK(DeterministicScheduler *Scheduler, UINT ThreadID)	// caller holds Scheduler->Lock
+{
+	for(size_t i = 0; i < Scheduler->Tasks.size(); i ++)
+		if(Scheduler->Tasks[i]->ThreadID == ThreadID)
+			return Scheduler->Tasks[i] ;
+	return NULL ;
+}
+
+static void DETERMINISTIC_ADD(UINT ThreadID)		// called when an active class is resumed
+{
+	DeterministicScheduler *Scheduler = CURRENT_SCHEDULER() ;
+	if(Scheduler == NULL)
+		return ;
+
+	Scheduler->Lock.Enter() ;
+	if(FIND_TASK(Scheduler, ThreadID) == NULL)	{
+		DeterministicTask *Task = new DeterministicTask ;
+		Task->ThreadID = ThreadID ;
+		Task->Wakeup = CreateEvent(NULL, FALSE, FALSE, NULL) ;
+		Task->WakeTime = Scheduler->LogicalTime ;
+		Task->Scheduler = Scheduler ;
+		Scheduler->Tasks.push_back(Task) ;
+
+		if(Scheduler->RunningTask == NULL)		// resumed from outside the scheduler, e.g. the primary thread
+			RUN_TASK(Scheduler, Task) ;
+	}
+	Scheduler->Lock.Leave() ;
+}
+
+static void DETERMINISTIC_REMOVE(UINT ThreadID)	// called when an active class ends or is destroyed
+{
+	SchedulerRegistryLock.Enter() ;		// even when there are none, as another thread may be adding one
+	for(size_t i = 0; i < Schedulers.size(); i ++)	{
+		DeterministicScheduler *Scheduler = Schedulers[i] ;
+
+		Scheduler->Lock.Enter() ;
+		DeterministicTask *Task = FIND_TASK(Scheduler, ThreadID) ;
+		if(Task != NULL)	{
+			for(size_t j = 0; j < Scheduler->Tasks.size(); j ++)
+				if(Scheduler->Tasks[j] == Task)
+					Scheduler->Tasks.erase(Scheduler->Tasks.begin() + j) ;
+
+			if(Scheduler->RunningTask == Task)
+				RUN_TASK(Scheduler, NEXT_TASK(Scheduler)) ;
+
+			CloseHandle(Task->Wakeup) ;
+			delete Task ;
+		}
+		Scheduler->Lock.Leave() ;
+	}
+	SchedulerRegistryLock.Leave() ;
+}
+
+static void DETERMINISTIC_START()		// called on an active class thread before its main()
+{
+	SchedulerRegistryLock.Enter() ;		// even when there are none, as another thread may be adding one
+	for(size_t i = 0; i < Schedulers.size() && CurrentTask == NULL; i ++)	{
+		Schedulers[i]->Lock.Enter() ;
+		CurrentTask = FIND_TASK(Schedulers[i], GetCurrentThreadId()) ;
+		Schedulers[i]->Lock.Leave() ;
+	}
+	SchedulerRegistryLock.Leave() ;
+
+	if(CurrentTask != NULL)
+		WaitForSingleObject(CurrentTask->Wakeup, INFINITE) ;	// wait for our first turn
+}
+
+static void DETERMINISTIC_YIELD(ULONGLONG Delay)		// give up the processor for 'Delay' logical microseconds
+{
+	DeterministicTask *Self = CurrentTask ;
+	DeterministicScheduler *Scheduler = Self->Scheduler ;
+
+	Scheduler->Lock.Enter() ;
+	Self->WakeTime = Scheduler->LogicalTime + Delay ;
+	RUN_TASK(Scheduler, NEXT_TASK(Scheduler)) ;		// may pick us again straight away
+	Scheduler->Lock.Leave() ;
+
+	WaitForSingleObject(Self->Wakeup, INFINITE) ;
+}
+
+//
+//	All the Wait() functions below come through here. Outside the scheduler this is just
+//	WaitForSingleObject(). A scheduled thread instead tests the object and lets the others run
+//	between tests, so it never blocks while holding the processor. The logical time between tests
+//	starts at 1 mSec and doubles up to SCHEDULER_MAX_WAIT_POLL so that long waits cost few switches
+//
+
+static UINT SCHEDULED_WAIT(UINT (*TryWait)(void *Object, DWORD Time), void *Object, DWORD Time)	// calling thread has a CurrentTask
+{
+	ULONGLONG Start = CurrentTask->Scheduler->LogicalTime ;
+	ULONGLONG Poll = 1000 ;
+
+	for(;;)	{
+		UINT Result = TryWait(Object, 0) ;
+		if(Result != WAIT_TIMEOUT)
+			return Result ;
+
+		ULONGLONG Waited = CurrentTask->Scheduler->LogicalTime - Start ;
+		if(Time != INFINITE && Waited >= (ULONGLONG)(Time) * 1000)
+			return WAIT_TIMEOUT ;
+		if(Time != INFINITE && Waited + Poll > (ULONGLONG)(Time) * 1000)
+			Poll = (ULONGLONG)(Time) * 1000 - Waited ;		// do not sleep past the timeout
+
+		DETERMINISTIC_YIELD(Poll) ;
+
+		if(Poll < SCHEDULER_MAX_WAIT_POLL)
+			Poll *= 2 ;
+	}
+}
+
+static UINT WAIT_FOR_HANDLE(void *Handle, DWORD Time)
+{
+	return WaitForSingleObject((HANDLE)(Handle), Time) ;
+}
+
+static UINT WAIT_FOR_OBJECT(HANDLE Handle, DWORD Time)
+{
+	if(CurrentTask == NULL || Time == 0)
+		return WaitForSingleObject(Handle, Time) ;
+
+	return SCHEDULED_WAIT(WAIT_FOR_HANDLE, Handle, Time) ;
+}
+
+void SET_DETERMINISTIC(BOOL On, UINT Seed)
+{
+	if(On && ProcessScheduler == NULL)
+		ProcessScheduler = NEW_SCHEDULER(Seed) ;
+	else if(On)
+		SET_RANDOM_SEED(Seed) ;
+	else
+		ProcessScheduler = NULL ;	// kept in the registry, threads already on it carry on
+}
+
+BOOL IS_DETERMINISTIC()
+{
+	return CURRENT_SCHEDULER() != NULL ;
+}
+
+void SET_RANDOM_SEED(UINT Seed)
+{
+	DeterministicScheduler *Scheduler = CURRENT_SCHEDULER() ;
+
+	if(Scheduler != NULL)	{
+		Scheduler->Lock.Enter() ;
+		Scheduler->RandomState = RANDOM_STATE(Seed) ;
+		Scheduler->Lock.Leave() ;
+	}
+	else	{
+		RandomLock.Enter() ;
+		RandomState = RANDOM_STATE(Seed) ;
+		RandomLock.Leave() ;
+	}
+}
+
+UINT RANDOM()
+{
+	DeterministicScheduler *Scheduler = CURRENT_SCHEDULER() ;
+	UINT Result ;
+
+	if(Scheduler != NULL)	{
+		Scheduler->Lock.Enter() ;
+		Result = NEXT_RANDOM(Scheduler->RandomState) ;
+		Scheduler->Lock.Leave() ;
+	}
+	else	{
+		RandomLock.Enter() ;
+		Result = NEXT_RANDOM(RandomState) ;
+		RandomLock.Leave() ;
+	}
+	return Result ;
+}
+
+CDeterministicScheduler::CDeterministicScheduler(UINT Seed)
+{
+	Scheduler = NEW_SCHEDULER(Seed) ;
+	PreviousScheduler = ThreadScheduler ;
+	ThreadScheduler = Scheduler ;
+}
+
+CDeterministicScheduler::~CDeterministicScheduler()
+{
+	ThreadScheduler = PreviousScheduler ;
+
+	SchedulerRegistryLock.Enter() ;
+	for(size_t i = 0; i < Schedulers.size(); i ++)
+		if(Schedulers[i] == Scheduler)
+			Schedulers.erase(Schedulers.begin() + i) ;
+	SchedulerRegistryLock.Leave() ;
+
+	for(size_t i = 0; i < Scheduler->Tasks.size(); i ++)	{	// threads that were never waited for
+		CloseHandle(Scheduler->Tasks[i]->Wakeup) ;
+		delete Scheduler->Tasks[i] ;
+	}
+	delete Scheduler ;
+}
+
+ULONGLONG CDeterministicScheduler::GetTime() const
+{
+	return Scheduler->LogicalTime ;
+}
+
+//
+//	The event log is a text file with one line per LOG_EVENT() call, the time from GET_TIME_US()
+//	followed by the event. In deterministic mode two runs with the same input and seed write
+//	identical logs, so comparing them with a file compare shows exactly where two builds differ
+//
+
+static FILE *EventLog = NULL ;
+static CriticalSection EventLogLock ;
+
+void SET_EVENT_LOG(const string &FileName)
+{
+	EventLogLock.Enter() ;
+	if(EventLog != NULL)
+		fclose(EventLog) ;
+	EventLog = NULL ;
+
+	if(!FileName.empty())	{
+		fopen_s(&EventLog, FileName.c_str(), "w") ;
+		PERR( EventLog != NULL, string("Cannot Create Event Log: ") + FileName) ;
+	}
+	EventLogLock.Leave() ;
+}
+
+void LOG_EVENT(const string &Event)
+{
+	if(EventLog == NULL)
+		return ;
+
+	EventLogLock.Enter() ;
+	if(EventLog != NULL)
+		fprintf(EventLog, "%llu %s\n", GET_TIME_US(), Event.c_str()) ;
+	EventLogLock.Leave() ;
+}
+
+void LOG_EVENTF(const char *Format, ...)
+{
+	if(EventLog == NULL)
+		return ;
+
+	EventLogLock.Enter() ;
+	if(EventLog != NULL)	{
+		va_list	Args ;
+
+		fprintf(EventLog, "%llu ", GET_TIME_US()) ;
+		va_start(Args, Format) ;
+		vfprintf(EventLog, Format, Args) ;
+		va_end(Args) ;
+		fputc('\n', EventLog) ;
+	}
+	EventLogLock.Leave() ;
+}
+
+//
+//	Compiled with RT_COUNT_ALLOCATIONS defined, rt replaces the global operator new and delete with
+//	ones that count the allocations made by each thread, so a program can check that a part of it
+//	that should not touch the heap does not, by comparing GET_ALLOCATION_COUNT() before and after.
+//	It is left out otherwise as it replaces them for the whole program
+//
+
+#ifdef RT_COUNT_ALLOCATIONS
+
+static PerThreadStorage ULONGLONG ThreadAllocations = 0 ;
+
+void *operator new(size_t Size)
+{
+	ThreadAllocations ++ ;
+
+	void *Memory = malloc(Size > 0 ? Size : 1) ;
+	if(Memory == NULL)
+		throw std::bad_alloc() ;
+	return Memory ;
+}
+
+void operator delete(void *Memory) throw()
+{
+	free(Memory) ;
+}
+
+ULONGLONG GET_ALLOCATION_COUNT()
+{
+	return ThreadAllocations ;
+}
+
+#else
+
+ULONGLONG GET_ALLOCATION_COUNT()
+{
+	return ALLOCATIONS_NOT_COUNTED ;
+}
+
+#endif
+
+////////////////////////////////////////////////////////////
+//	Object Scope Functions
+////////////////////////////////////////////////////////////
+//
+//	Mutexes, semaphores, events, conditions, datapools and pipelines are normally named Win32 kernel
+//	objects, so every object with the same name on the machine is the same object. That is what lets
+//	separate processes share them, but it also means two copies of a program on one machine share all
+//	their objects, and every creation costs a search of the system wide name space.
+//
+//	SET_OBJECT_SCOPE(LOCAL_OBJECTS) makes the objects created afterwards unnamed kernel objects instead.
+//	Objects created with the same name in the same process are still the same object, found through a
+//	table in the process and destroyed when the last one is unlinked, but nothing outside the process
+//	can see them. Use it when every thread using an object is in the same process, for example to run
+//	several copies of a simulation side by side with the same object names.
+//
+//	SET_OBJECT_SCOPE(PROCESS_OBJECTS) goes further for mutexes, semaphores, datapools and pipelines and
+//	makes them without kernel objects at all (see below), which makes an uncontended Wait() or Signal()
+//	many times cheaper. Events and conditions are unnamed kernel objects as in LOCAL_OBJECTS scope.
+//
+
+struct LocalObject {
+	string	Key ;			// type and name of the object
+	void	*Object ;		// handle of the unnamed kernel object, or the object itself in PROCESS_OBJECTS scope
+	UINT	Links ;			// number of objects using it
+	BOOL	(*Destroy)(void *Object) ;	// called when the last one is unlinked
+} ;
+
+static int ObjectScope = GLOBAL_OBJECTS ;
+static volatile LONG LocalObjectCount = 0 ;		// lets CLOSE_OBJECT() skip the table, even during static destruction, when it is empty
+static CriticalSection LocalObjectLock ;
+static map<string, LocalObject *> LocalObjectsByKey ;
+static map<void *, LocalObject *> LocalObjectsByAddress ;
+
+void SET_OBJECT_SCOPE(int Scope)
+{
+	PERR(Scope == GLOBAL_OBJECTS || Scope == LOCAL_OBJECTS || Scope == PROCESS_OBJECTS, "Use GLOBAL_OBJECTS, LOCAL_OBJECTS or PROCESS_OBJECTS in SET_OBJECT_SCOPE()") ;
+	if(Scope == GLOBAL_OBJECTS || Scope == LOCAL_OBJECTS || Scope == PROCESS_OBJECTS)
+		ObjectScope = Scope ;
+}
+
+int GET_OBJECT_SCOPE()
+{
+	return ObjectScope ;
+}
+
+static const char *OBJECT_NAME(const string &Name)	// name to create a kernel object with, NULL for an unnamed one
+{
+	return (ObjectScope == GLOBAL_OBJECTS) ? Name.c_str() : NULL ;
+}
+
+//	Returns the object already in the table with the same type and name, destroying the new one,
+//	or adds the new one to the table for the next object created with that type and name
+
+static void *LINK_OBJECT(const string &Type, const string &Name, void *Object, BOOL (*Destroy)(void *Object))
+{
+	const string Key = Type + ":" + Name ;
+
+	LocalObjectLock.Enter() ;
+	map<string, LocalObject *>::iterator Found = LocalObjectsByKey.find(Key) ;
+	if(Found != LocalObjectsByKey.end())	{
+		Destroy(Object) ;
+		Object = Found->second->Object ;
+		Found->second->Links ++ ;
+	}
+	else	{
+		LocalObject *Local = new LocalObject ;
+		Local->Key = Key ;
+		Local->Object = Object ;
+		Local->Links = 1 ;
+		Local->Destroy = Destroy ;
+		LocalObjectsByKey[Key] = Local ;
+		LocalObjectsByAddress[Object] = Local ;
+		LocalObjectCount ++ ;
+	}
+	LocalObjectLock.Leave() ;
+
+	return Object ;
+}
+
+static BOOL CLOSE_KERNEL_OBJECT(void *Handle)
+{
+	return CloseHandle((HANDLE)(Handle)) ;
+}
+
+//	Called with the handle of a kernel object just created using OBJECT_NAME(). Outside GLOBAL_OBJECTS
+//	scope it returns the handle of the object already created with the same type and name, closing
+//	the new one, or records the new one for the next object with that type and name.
+
+static HANDLE SHARE_OBJECT(const string &Type, const string &Name, HANDLE Handle)
+{
+	if(Handle == NULL || ObjectScope == GLOBAL_OBJECTS)
+		return Handle ;
+
+	return (HANDLE)(LINK_OBJECT(Type, Name, Handle, CLOSE_KERNEL_OBJECT)) ;
+}
+
+//	Closes a handle from SHARE_OBJECT() or releases an object from LINK_OBJECT(), an object shared
+//	within the process is only destroyed when the last object using it is unlinked
+
+static BOOL CLOSE_OBJECT(void *Object)
+{
+	if(LocalObjectCount == 0)
+		return CloseHandle((HANDLE)(Object)) ;
+
+	LocalObjectLock.Enter() ;
+	map<void *, LocalObject *>::iterator Found = LocalObjectsByAddress.find(Object) ;
+	if(Found == LocalObjectsByAddress.end())	{
+		LocalObjectLock.Leave() ;
+		return CloseHandle((HANDLE)(Object)) ;
+	}
+
+	LocalObject *Local = Found->second ;
+	if(-- Local->Links > 0)	{
+		LocalObjectLock.Leave() ;
+		return TRUE ;
+	}
+	LocalObjectsByAddress.erase(Found) ;
+	LocalObjectsByKey.erase(Local->Key) ;
+	LocalObjectCount -- ;
+	LocalObjectLock.Leave() ;
+
+	BOOL Success = Local->Destroy(Object) ;
+	delete Local ;
+	return Success ;
+}
+
+//
+//	In PROCESS_OBJECTS scope mutexes, semaphores, datapools and pipelines do not use kernel objects at
+//	all. Datapools and pipelines are plain heap memory, and mutexes and semaphores are a slim reader/writer
+//	lock and a condition variable, so a Wait() or Signal() that does not block never leaves user mode.
+//	Their GetHandle() returns NULL, so they cannot be passed to Win32 wait functions.
+//
+
+struct ProcessMutex {
+	SRWLOCK				Lock ;			// protects the fields below
+	CONDITION_VARIABLE	Released ;		// woken when the mutex becomes free
+	DWORD				Owner ;			// ID of the owning thread, 0 when free
+	UINT				Count ;			// number of Wait()s by the owner not yet matched by a Signal()
+} ;
+
+struct ProcessSemaphore {
+	SRWLOCK				Lock ;			// protects the fields below
+	CONDITION_VARIABLE	Signalled ;		// woken when the value goes up
+	int					Value ;
+	int					MaxValue ;
+} ;
+
+static BOOL DELETE_PROCESS_MUTEX(void *Mutex)
+{
+	delete (ProcessMutex *)(Mutex) ;
+	return TRUE ;
+}
+
+static BOOL DELETE_PROCESS_SEMAPHORE(void *Semaphore)
+{
+	delete (ProcessSemaphore *)(Semaphore) ;
+	return TRUE ;
+}
+
+static BOOL FREE_PROCESS_MEMORY(void *Memory)
+{
+	free(Memory) ;
+	return TRUE ;
+}
+
+static ProcessMutex *NEW_PROCESS_MUTEX(const string &Name, BOOL bOwned)
+{
+	ProcessMutex *Mutex = new ProcessMutex ;
+	InitializeSRWLock(&Mutex->Lock) ;
+	InitializeConditionVariable(&Mutex->Released) ;
+	Mutex->Owner = bOwned ? GetCurrentThreadId() : 0 ;
+	Mutex->Count = bOwned ? 1 : 0 ;
+	return (ProcessMutex *)(LINK_OBJECT("ProcessMutex", Name, Mutex, DELETE_PROCESS_MUTEX)) ;
+}
+
+static ProcessSemaphore *NEW_PROCESS_SEMAPHORE(const string &Name, int InitialVal, int MaxVal)
+{
+	ProcessSemaphore *Semaphore = new ProcessSemaphore ;
+	InitializeSRWLock(&Semaphore->Lock) ;
+	InitializeConditionVariable(&Semaphore->Signalled) ;
+	Semaphore->Value = InitialVal ;
+	Semaphore->MaxValue = MaxVal ;
+	return (ProcessSemaphore *)(LINK_OBJECT("ProcessSemaphore", Name, Semaphore, DELETE_PROCESS_SEMAPHORE)) ;
+}
+
+static void *PROCESS_MEMORY(const string &Name, UINT Size)	// zeroed memory shared by name within the process
+{
+	void *Memory = calloc(Size, 1) ;
+	if(Memory == NULL)
+		return NULL ;
+	return LINK_OBJECT("ProcessMemory", Name, Memory, FREE_PROCESS_MEMORY) ;
+}
+
+static UINT PROCESS_MUTEX_WAIT(void *Object, DWORD Time)
+{
+	ProcessMutex *Mutex = (ProcessMutex *)(Object) ;
+	DWORD Self = GetCurrentThreadId() ;
+	DWORD Start = (Time == INFINITE || Time == 0) ? 0 : GetTickCount() ;
+
+	AcquireSRWLockExclusive(&Mutex->Lock) ;
+	while(Mutex->Owner != 0 && Mutex->Owner != Self)	{
+		DWORD Waited = (Time == INFINITE || Time == 0) ? 0 : GetTickCount() - Start ;
+		if(Time == 0 || (Time != INFINITE && Waited >= Time))	{
+			ReleaseSRWLockExclusive(&Mutex->Lock) ;
+			return WAIT_TIMEOUT ;
+		}
+		SleepConditionVariableSRW(&Mutex->Released, &Mutex->Lock, (Time == INFINITE) ? INFINITE : Time - Waited, 0) ;
+	}
+	Mutex->Owner = Self ;
+	Mutex->Count ++ ;
+	ReleaseSRWLockExclusive(&Mutex->Lock) ;
+
+	return WAIT_OBJECT_0 ;
+}
+
+static BOOL PROCESS_MUTEX_SIGNAL(ProcessMutex *Mutex)
+{
+	AcquireSRWLockExclusive(&Mutex->Lock) ;
+	BOOL Owned = (Mutex->Owner == GetCurrentThreadId()) ;		// like ReleaseMutex(), only the owner can signal
+	if(Owned && -- Mutex->Count == 0)	{
+		Mutex->Owner = 0 ;
+		WakeConditionVariable(&Mutex->Released) ;
+	}
+	ReleaseSRWLockExclusive(&Mutex->Lock) ;
+
+	return Owned ;
+}
+
+static UINT PROCESS_SEMAPHORE_WAIT(void *Object, DWORD Time)
+{
+	ProcessSemaphore *Semaphore = (ProcessSemaphore *)(Object) ;
+	DWORD Start = (Time == INFINITE || Time == 0) ? 0 : GetTickCount() ;
+
+	AcquireSRWLockExclusive(&Semaphore->Lock) ;
+	while(Semaphore->Value == 0)	{
+		DWORD Waited = (Time == INFINITE || Time == 0) ? 0 : GetTickCount() - Start ;
+		if(Time == 0 || (Time != INFINITE && Waited >= Time))	{
+			ReleaseSRWLockExclusive(&Semaphore->Lock) ;
+			return WAIT_TIMEOUT ;
+		}
+		SleepConditionVariableSRW(&Semaphore->Signalled, &Semaphore->Lock, (Time == INFINITE) ? INFINITE : Time - Waited, 0) ;
+	}
+	Semaphore->Value -- ;
+	ReleaseSRWLockExclusive(&Semaphore->Lock) ;
+
+	return WAIT_OBJECT_0 ;
+}
+
+static BOOL PROCESS_SEMAPHORE_SIGNAL(ProcessSemaphore *Semaphore, int Increment)
+{
+	AcquireSRWLockExclusive(&Semaphore->Lock) ;
+	BOOL Success = (Increment > 0 && Increment <= Semaphore->MaxValue - Semaphore->Value) ;	// like ReleaseSemaphore(), fails past the maximum
+	if(Success)	{
+		Semaphore->Value += Increment ;
+		if(Increment == 1)
+			WakeConditionVariable(&Semaphore->Signalled) ;
+		else
+			WakeAllConditionVariable(&Semaphore->Signalled) ;
+	}
+	ReleaseSRWLockExclusive(&Semaphore->Lock) ;
+
+	return Success ;
+}
+
+////////////////////////////////////////////////////////////
+//	Adaptive Wait and Contention Profile Functions
+////////////////////////////////////////////////////////////
+//
+//	A Wait() on a mutex or semaphore that is not free normally blocks straight away, which costs two
+//	thread switches even when the owner is about to release it, as in CPipe::Read() and Write() where
+//	it is held for a few instructions. After SET_ADAPTIVE_WAIT(TRUE), a CMutex or CSemaphore Wait()
+//	that finds the object taken first spins, testing it again between pause instructions, and only
+//	blocks if it is still taken at the end. How long it spins adapts to how long the spins that
+//	worked for objects with the same name took, up to ADAPTIVE_MAX_SPIN tests. Threads on a
+//	deterministic scheduler never spin, and nor does anything on a single processor.
+//
+//	SET_CONTENTION_PROFILE(FileName) records, for every name used by a mutex, semaphore, event or
+//	condition, how often it was acquired, how often that meant waiting, how long the waits took and
+//	how long a mutex was then held. Each CMutex times its own holds from the Wait() that got it to the
+//	Signal() that let it go, the outermost of those when its owner takes it again, so other objects
+//	with the name and counting semaphores, that have no holder, do not upset it. Events are tested
+//	before they are counted as contended, as conditions are. CONTENTION_REPORT() gives the figures as a table
+//	at any time, and it is written to the file when profiling is stopped or the program exits. With
+//	neither adaptive waits nor profiling on, each Wait() and Signal() costs one extra test.
+//
+//	A name is only registered while adaptive waits or profiling are on, when an object is made or on
+//	its first Wait() after either is switched on. Its figures can be read with GET_WAIT_STATISTICS()
+//	while an object with the name exists, and while profiling is on after the last one is destroyed,
+//	so the report covers it. Otherwise the entry goes with its last object, which keeps the per day
+//	names of a batch run from piling up. Adaptive waits count Waits, Spins, Parks and WaitTime even
+//	without profiling.
+//
+
+#define	ADAPTIVE_MAX_SPIN		100		// most tests of a taken object before blocking
+#define	ADAPTIVE_PAUSES			16		// pause instructions between two tests
+#define	SPIN_ESTIMATE_SHIFT		8		// SpinEstimate holds tests * 256 so the average keeps decaying
+
+#define	WAIT_SPIN				0		// OBJECT_WAIT() mode for mutexes and semaphores
+#define	WAIT_TEST				1		// ditto for events and conditions, tested first but never spun on
+
+struct NamedWait {
+	string			Name ;
+	volatile LONG64	Waits ;
+	volatile LONG64	Acquisitions ;
+	volatile LONG64	Contended ;
+	volatile LONG64	Spins ;
+	volatile LONG64	Parks ;
+	volatile LONG64	WaitTime ;
+	volatile LONG64	MaxWait ;
+	volatile LONG64	HoldTime ;
+	volatile LONG64	MaxHold ;
+	volatile LONG	SpinEstimate ;		// running average of the tests successful spins needed, fixed point
+	LONG			Users ;				// objects made with the name, under NamedWaitLock
+} ;
+
+static BOOL AdaptiveWait = FALSE ;
+static LONG AdaptiveProcessors = 0 ;
+static BOOL ContentionProfile = FALSE ;
+static string ContentionReportFile ;
+static CriticalSection NamedWaitLock ;
+static map<string, NamedWait *> NamedWaits ;		// freed with the last user unless profiling
+
+void SET_ADAPTIVE_WAIT(BOOL On)
+{
+	if(AdaptiveProcessors == 0)	{
+		SYSTEM_INFO Info ;
+		GetSystemInfo(&Info) ;
+		AdaptiveProcessors = (LONG)(Info.dwNumberOfProcessors) ;
+	}
+	AdaptiveWait = On ;
+}
+
+static NamedWait *NAMED_WAIT(const string &Name)		// NULL if neither adaptive waits nor profiling are on
+{
+	if(!AdaptiveWait && !ContentionProfile)
+		return NULL ;
+
+	NamedWaitLock.Enter() ;
+	NamedWait *&Wait = NamedWaits[Name] ;
+	if(Wait == NULL)	{
+		Wait = new NamedWait ;
+		Wait->Name = Name ;
+		Wait->Waits = Wait->Acquisitions = Wait->Contended = Wait->Spins = Wait->Parks = 0 ;
+		Wait->WaitTime = Wait->MaxWait = Wait->HoldTime = Wait->MaxHold = 0 ;
+		Wait->SpinEstimate = 0 ;
+		Wait->Users = 0 ;
+	}
+	Wait->Users ++ ;
+	NamedWaitLock.Leave() ;
+
+	return Wait ;
+}
+
+void RELEASE_NAMED_WAIT(NamedWait *Wait)
+{
+	if(Wait == NULL)
+		return ;
+
+	NamedWaitLock.Enter() ;
+	if(-- Wait->Users == 0 && !ContentionProfile)	{
+		NamedWaits.erase(Wait->Name) ;
+		delete Wait ;
+	}
+	NamedWaitLock.Leave() ;
+}
+
+//	The name of an object made before adaptive waits or profiling were switched on is registered
+//	by its first Wait() after, the compare and swap keeps one of two threads doing it at once
+
+static NamedWait *LINKED_WAIT(NamedWait *volatile *pWait, const string &Name)
+{
+	NamedWait *Wait = *pWait ;
+	if(Wait != NULL)
+		return Wait ;
+
+	Wait = NAMED_WAIT(Name) ;
+	NamedWait *Seen = (NamedWait *)(InterlockedCompareExchangePointer((void *volatile *)(pWait), Wait, NULL)) ;
+	if(Seen != NULL)	{
+		RELEASE_NAMED_WAIT(Wait) ;
+		Wait = Seen ;
+	}
+	return Wait ;
+}
+
+static void RELEASE_UNUSED_NAMED_WAITS()		// once profiling stops nothing else needs them
+{
+	NamedWaitLock.Enter() ;
+	for(map<string, NamedWait *>::iterator i = NamedWaits.begin(); i != NamedWaits.end(); )	{
+		if(i->second->Users == 0)	{
+			delete i->second ;
+			NamedWaits.erase(i ++) ;
+		}
+		else
+			++ i ;
+	}
+	NamedWaitLock.Leave() ;
+}
+
+static void RECORD_MAX(volatile LONG64 *Max, LONG64 Value)
+{
+	LONG64 Old = *Max ;
+	while(Value > Old)	{
+		LONG64 Seen = InterlockedCompareExchange64(Max, Value, Old) ;
+		if(Seen == Old)
+			break ;
+		Old = Seen ;
+	}
+}
+
+static void RECORD_WAIT(NamedWait *Wait, UINT Result, ULONGLONG Start)	// Start is 0 if the object was free
+{
+	InterlockedIncrement64(&Wait->Waits) ;
+
+	if(Start != 0)	{
+		LONG64 Waited = (LONG64)(GET_TIME_US() - Start) ;
+		InterlockedExchangeAdd64(&Wait->WaitTime, Waited) ;
+		if(ContentionProfile)	{
+			InterlockedIncrement64(&Wait->Contended) ;
+			RECORD_MAX(&Wait->MaxWait, Waited) ;
+		}
+	}
+
+	if(ContentionProfile && (Result == WAIT_OBJECT_0 || Result == WAIT_ABANDONED))
+		InterlockedIncrement64(&Wait->Acquisitions) ;
+}
+
+static void RECORD_HOLD(NamedWait *Wait, ULONGLONG Start)	// Start is 0 if the hold began with profiling off
+{
+	if(!ContentionProfile || Wait == NULL || Start == 0)
+		return ;
+
+	LONG64 Held = (LONG64)(GET_TIME_US() - Start) ;
+	InterlockedExchangeAdd64(&Wait->HoldTime, Held) ;
+	RECORD_MAX(&Wait->MaxHold, Held) ;
+}
+
+static WAITSTATISTICS WAIT_STATISTICS(const NamedWait *Wait)
+{
+	WAITSTATISTICS Statistics ;
+	Statistics.Waits = (ULONGLONG)(Wait->Waits) ;
+	Statistics.Spins = (ULONGLONG)(Wait->Spins) ;
+	Statistics.Parks = (ULONGLONG)(Wait->Parks) ;
+	Statistics.WaitTime = (ULONGLONG)(Wait->WaitTime) ;
+	Statistics.Acquisitions = (ULONGLONG)(Wait->Acquisitions) ;
+	Statistics.Contended = (ULONGLONG)(Wait->Contended) ;
+	Statistics.MaxWait = (ULONGLONG)(Wait->MaxWait) ;
+	Statistics.HoldTime = (ULONGLONG)(Wait->HoldTime) ;
+	Statistics.MaxHold = (ULONGLONG)(Wait->MaxHold) ;
+	return Statistics ;
+}
+
+WAITSTATISTICS GET_WAIT_STATISTICS(const string &Name)
+{
+	WAITSTATISTICS Statistics = { 0, 0, 0, 0, 0, 0, 0, 0, 0 } ;
+
+	NamedWaitLock.Enter() ;
+	map<string, NamedWait *>::const_iterator Found = NamedWaits.find(Name) ;
+	if(Found != NamedWaits.end())
+		Statistics = WAIT_STATISTICS(Found->second) ;
+	NamedWaitLock.Leave() ;
+
+	return Statistics ;
+}
+
+static bool MORE_WAIT_TIME(const NamedWait *First, const NamedWait *Second)
+{
+	return First->WaitTime > Second->WaitTime ;
+}
+
+string CONTENTION_REPORT()
+{
+	vector<NamedWait *> Waits ;
+
+	NamedWaitLock.Enter() ;
+	for(map<string, NamedWait *>::const_iterator i = NamedWaits.begin(); i != NamedWaits.end(); ++ i)
+		if(i->second->Waits != 0)
+			Waits.push_back(i->second) ;
+	NamedWaitLock.Leave() ;
+
+	sort(Waits.begin(), Waits.end(), MORE_WAIT_TIME) ;		// the most time lost first
+
+	ostringstream Report ;
+	Report << "Name                                      Acquired  Contended     Spins     Parks  Wait total(us)  Wait max  Held total(us)  Held max\n" ;
+	for(size_t i = 0; i < Waits.size(); i ++)	{
+		const NamedWait *Wait = Waits[i] ;
+		Report << left << setw(40) << Wait->Name << right
+			<< setw(10) << Wait->Acquisitions << setw(11) << Wait->Contended
+			<< setw(10) << Wait->Spins << setw(10) << Wait->Parks
+			<< setw(16) << Wait->WaitTime << setw(10) << Wait->MaxWait
+			<< setw(16) << Wait->HoldTime << setw(10) << Wait->MaxHold << "\n" ;
+	}
+	return Report.str() ;
+}
+
+static void WRITE_CONTENTION_REPORT()
+{
+	if(!ContentionProfile)
+		return ;
+
+	FILE *File = NULL ;
+	fopen_s(&File, ContentionReportFile.c_str(), "w") ;
+	PERR( File != NULL, string("Cannot Create Contention Report: ") + ContentionReportFile) ;
+	if(File != NULL)	{
+		fputs(CONTENTION_REPORT().c_str(), File) ;
+		fclose(File) ;
+	}
+}
+
+void SET_CONTENTION_PROFILE(const string &ReportFile)
+{
+	static BOOL AtExit = FALSE ;
+
+	WRITE_CONTENTION_REPORT() ;		// for the profile being stopped or replaced
+
+	ContentionReportFile = ReportFile ;
+	ContentionProfile = !ReportFile.empty() ;
+
+	if(ContentionProfile && !AtExit)	{
+		atexit(WRITE_CONTENTION_REPORT) ;
+		AtExit = TRUE ;
+	}
+
+	if(!ContentionProfile)
+		RELEASE_UNUSED_NAMED_WAITS() ;
+}
+
+//	Moves the fixed point SpinEstimate an eighth of the way to Spins, with a compare and swap as
+//	threads spinning on the same name update it at once
+
+static void UPDATE_SPIN_ESTIMATE(volatile LONG *Estimate, LONG Spins)
+{
+	LONG Old = *Estimate ;
+	for(;;)	{
+		LONG New = Old + ((Spins << SPIN_ESTIMATE_SHIFT) - Old) / 8 ;
+		LONG Seen = InterlockedCompareExchange(Estimate, New, Old) ;
+		if(Seen == Old)
+			break ;
+		Old = Seen ;
+	}
+}
+
+//	Spins on an object found taken and then blocks on it, see SET_ADAPTIVE_WAIT()
+
+static UINT SPIN_WAIT(UINT (*TryWait)(void *Object, DWORD Time), void *Object, DWORD Time, NamedWait *Wait, ULONGLONG Start)
+{
+	LONG Limit = (AdaptiveProcessors > 1) ? ((Wait->SpinEstimate * 2) >> SPIN_ESTIMATE_SHIFT) + 10 : 0 ;
+	if(Limit > ADAPTIVE_MAX_SPIN)
+		Limit = ADAPTIVE_MAX_SPIN ;
+
+	UINT Result = WAIT_TIMEOUT ;
+	LONG Spin = 0 ;
+
+	while(Result == WAIT_TIMEOUT && Spin < Limit)	{
+		for(int i = 0; i < ADAPTIVE_PAUSES; i ++)
+			YieldProcessor() ;
+		Spin ++ ;
+		Result = TryWait(Object, 0) ;
+	}
+
+	if(Result != WAIT_TIMEOUT)	{
+		InterlockedIncrement64(&Wait->Spins) ;
+		UPDATE_SPIN_ESTIMATE(&Wait->SpinEstimate, Spin) ;
+		return Result ;
+	}
+
+	InterlockedIncrement64(&Wait->Parks) ;
+	if(Limit > 0)
+		UPDATE_SPIN_ESTIMATE(&Wait->SpinEstimate, Limit) ;	// let it spin longer next time
+
+	DWORD Spent = (DWORD)((GET_TIME_US() - Start) / 1000) ;
+	if(Time == INFINITE)
+		return TryWait(Object, INFINITE) ;
+	return (Spent >= Time) ? WAIT_TIMEOUT : TryWait(Object, Time - Spent) ;
+}
+
+//	Every CMutex, CSemaphore, CEvent and CCondition Wait() comes through here with the function
+//	that tests, or blocks on, its object
+
+static UINT OBJECT_WAIT(UINT (*TryWait)(void *Object, DWORD Time), void *Object, DWORD Time, NamedWait *volatile *pWait, const string &Name, int Mode)
+{
+	NamedWait *Wait = NULL ;
+	if(ContentionProfile || (AdaptiveWait && Mode == WAIT_SPIN))
+		Wait = LINKED_WAIT(pWait, Name) ;
+
+	if(Wait == NULL)
+		return (CurrentTask != NULL && Time != 0) ? SCHEDULED_WAIT(TryWait, Object, Time) : TryWait(Object, Time) ;
+
+	UINT Result = TryWait(Object, 0) ;		// a free object is not counted as contended
+	ULONGLONG Start = 0 ;
+
+	if(Result == WAIT_TIMEOUT && Time != 0)	{
+		Start = GET_TIME_US() ;
+		if(CurrentTask != NULL)
+			Result = SCHEDULED_WAIT(TryWait, Object, Time) ;
+		else if(AdaptiveWait && Mode == WAIT_SPIN)
+			Result = SPIN_WAIT(TryWait, Object, Time, Wait, Start) ;
+		else
+			Result = TryWait(Object, Time) ;
+	}
+
+	RECORD_WAIT(Wait, Result, Start) ;
+	return Result ;
+}
+
+//	This function create a parallel thread within a process (do not confuse this
+//	with creating a new process. Each and every process (i.e. program/application)
+//	can have many threads. At startup, a process will have just 1 thread which commences
+//	with the execution of main() in your 'C' program. Once started, this 'primary' thread
+//	can create secondary threads which run in parallel with each other AND the main thread
+//	
+//	A thread is simply a 'C' style function (see examples below) defined in a special way.
+//	A thread inherits the priority of its parent thread, but can be changed later
+//
+//	A Thread function MUST be declared in a prescribed style (see example below). 
+//	A process can create/maintain many such threads and they can share global variables 
+//	thus implementing thread-to-thread communication in a simple and effective way
+
+//	and even call the same functions.
+
+
+//##ModelId=3DE6123A0182
+CThread::CThread(UINT __stdcall Function( void *), // name/pointer to function that is to be the new thread
+				 BOOL bCreateState,		// A flag indicating if the thread should commence SUSPENDED (TRUE) or ACTIVE (FALSE)
+				 void *ThreadArgs		// a generic pointer (can point to anything) to any data the calling thread
+										// wishes to pass to the child thread
+					 )
+{
+	UINT		ThreadControlFlags = 0 ;
+
+	bActiveClass = FALSE ;
+
+	if(bCreateState == SUSPENDED)		// if caller wants thread initially suspended
+		ThreadControlFlags = CREATE_SUSPENDED ;
+
+	ThreadHandle = (HANDLE)(_beginthreadex(NULL, 0, Function, ThreadArgs, ThreadControlFlags, &ThreadID)) ;
+	PERR( ThreadHandle != 0, string("Unable to Create Thread")) ;	// check for error and print message if appropriate
+}
+
+
+/*
+**	The following two functions work together to assist in the design of CThread derived classes with a main() to simulate the main of the thread
+**	All active class objects have their root thread within this function
+*/
+
+UINT __stdcall __GlobalThreadMain__(void *theThreadPtr) 	// receives a pointer to the thread object 
+{
+	DETERMINISTIC_START() ;												// in deterministic mode, wait for our turn to run
+	UINT ExitCode = ((ActiveClass *)(theThreadPtr))->main() ;			// run the activeclass virtual main function it should be overridden in derived class
+	DETERMINISTIC_REMOVE(GetCurrentThreadId()) ;
+	ExitThread(ExitCode) ;
+	return 0 ;
+}
+
+
+//##ModelId=3DE6123A0178
+CThread::CThread(BOOL bCreateState)			// A flag indicating if the thread should commence SUSPENDED (TRUE) or ACTIVE (FALSE)
+{
+	UINT		ThreadControlFlags = 0 ;
+
+	bActiveClass = TRUE ;
+
+	if(bCreateState == SUSPENDED)		// if caller wants thread initially suspended
+		ThreadControlFlags = CREATE_SUSPENDED ;
+
+	ThreadHandle = (HANDLE)(_beginthreadex(NULL, 
+							0, 
+							__GlobalThreadMain__,	
+							this,				//pointer to cthread derived object passed to __GlobalThreadMain__() above
+							ThreadControlFlags,	// thread is created in suspended state 
+							&ThreadID)) ;
+
+	PERR( ThreadHandle != 0, string("Unable to Create Thread")) ;	// check for error and print message if appropriate
+}
+
+
+//##ModelId=3DE6123A0223
+ActiveClass::ActiveClass()
+: TerminateFlag(FALSE) ,
+TerminateEvent(CreateEvent(NULL, TRUE, FALSE, NULL)) ,
+CThread()		// Call base class constructor to create the SUSPENDED thread, i.e. main in derived class does not yet run
+				// All objects derived from active class are thus initially created in the suspended state and have to
+				// be RESUMED before they become active. This is the safest way, as it allows control over the
+				// order in which objects run and avoids potential race hazards.
+{}				// Note that active class objects like all derived classes are constructed from the base upwards 
+				// and thus we have to make sure that base/derived class constructors are run to completion
+				// before the thread for the class (which is created in the base class) is allowed to resume
+				// otherwise the thread could run BEFORE the active class object had completed its construction
+				// this was the main reason for creating all ActiveClass objects in the Suspended state so don't change it
+				// I learn't the hard way and it was painful to debug !!!
+
+
+// this is important as we want to allow the derived 
+//classes constructor i.e. the one
+// written by the user, to complete its constructor 
+//before the class main() is run
+// otherwise the class might run with unitialised 
+//variables/state
+// This means that the user has to call Resume() for the 
+//class object to allow it to run.
+//##ModelId=3DE6123A022C
+ActiveClass::~ActiveClass()
+{
+	CloseHandle(TerminateEvent) ;
+}
+
+//
+//	Use this instead of SLEEP() in the loop of an active class so that RequestTerminate() wakes it
+//	straight away rather than after the rest of the sleep. On the deterministic scheduler it sleeps
+//	the whole time like SLEEP(), so the logical clock never depends on when the request was made.
+//
+
+BOOL ActiveClass::WaitForTerminate(DWORD Time) const
+{
+	if(!TerminateFlag)	{
+		if(CurrentTask != NULL)
+			SLEEP(Time) ;
+		else
+			WaitForSingleObject(TerminateEvent, Time) ;
+	}
+
+	return TerminateFlag ;
+}
+
+
+
+//
+//	The following can be used to terminate a thread at any point in the thread execution
+//	If the thread reaches the end of its 'thread function' then executing return 0 does the same trick.
+//
+
+//##ModelId=3DE6123A01D4
+void CThread::Exit(UINT	ExitCode) const
+{
+	DETERMINISTIC_REMOVE(GetCurrentThreadId()) ;
+	ExitThread(ExitCode) ;
+}
+
+CThread::~CThread()
+{
+	DETERMINISTIC_REMOVE(ThreadID) ;
+	::TerminateThread(ThreadHandle, 0) ;
+}
+	
+/////////////////////////////////////////////////////////////////////////////////////////////
+//	These two functions can be called to suspend and resume a threads activity. Once suspended
+//	the thread will no longer run and consume CPU time
+//
+//	Note that if you suspend a thread more than once, then it will require that many number
+//	of resumes to allow it to continue
+//
+//	Both functions require the thread HANDLE, which can be obtained when the thread is created
+///////////////////////////////////////////////////////////////////////////////////////////////
+
+//##ModelId=3DE6123A01AA
+BOOL CThread::Suspend() const
+{
+	UINT	Result = SuspendThread(ThreadHandle) ;
+	PERR( Result != 0xffffffff, string("Cannot Suspend Thread\n")) ;	// check for error and print message if appropriate
+
+	if(Result != 0xffffffff)
+		return TRUE ;
+	else
+		return FALSE ;
+}
+
+//##ModelId=3DE6123A01B4
+BOOL CThread::Resume() const
+{
+	if(bActiveClass)
+		DETERMINISTIC_ADD(ThreadID) ;			// scheduled from now on if the deterministic scheduler is on
+	UINT	Result = ResumeThread(ThreadHandle) ;
+	PERR( Result != 0xffffffff, string("Cannot Resume Thread\n")) ;	// check for error and print message if appropriate
+
+	if(Result != 0xffffffff)
+		return TRUE ;
+	else
+		return FALSE ;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////
+//	The following function can be used to change the priority of a thread once it has been
+//	created (irrespective of whether it is active or suspended). Threads with higher priority
+//	will block/stop threads with lower priority from executing so be careful.
+//
+//	All you need is the handle for the thread obtained from CREATE_THREAD() (see above)
+//	Windows NT has a limited number of thread priorities and the following symbolic
+//	constants can be used as a valid value for the parameter 'Priority' in the function
+//	Normally a thread will inherit a 'base' priority from its parent thread, or, if it is
+//	the primary thread, from its parent process (See FORK_PROCESS() above
+//	The constant below simply allow you to make small adjustments to the thread priority
+/////////////////////////////////////////////////////////////////////////////////////////////
+//
+//	THREAD_PRIORITY_ABOVE_NORMAL  = Indicates 1 point above normal priority for the priority class. 
+//	THREAD_PRIORITY_BELOW_NORMAL  = Indicates 1 point below normal priority for the priority class. 
+//	THREAD_PRIORITY_HIGHEST = Indicates 2 points above normal priority for the priority class. 
+//	THREAD_PRIORITY_IDLE = Indicates a base priority level of 1 for IDLE_PRIORITY_CLASS, NORMAL_PRIORITY_CLASS, or HIGH_PRIORITY_CLASS processes, and a base priority level of 16 for REALTIME_PRIORITY_CLASS processes. 
+//	THREAD_PRIORITY_LOWEST = Indicates 2 points below normal priority for the priority class. 
+//	THREAD_PRIORITY_NORMAL = Indicates normal priority for the priority class. 
+//	THREAD_PRIORITY_TIME_CRITICAL = Indicates a base priority level of 15 for IDLE_PRIORITY_CLASS, NORMAL_PRIORITY_CLASS, or HIGH_PRIORITY_CLASS processes, and a base priority level of 31 for REALTIME_PRIORITY_CLASS processes. 
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+//##ModelId=3DE6123A01BF
+BOOL CThread::SetPriority(UINT Priority) const
+{	
+	BOOL Success;
+
+	// check for error in priority value and print message if appropriate
+
+	PERR(((Priority == THREAD_PRIORITY_ABOVE_NORMAL) ||
+			(Priority == THREAD_PRIORITY_BELOW_NORMAL) ||
+			(Priority == THREAD_PRIORITY_HIGHEST) ||
+			(Priority == THREAD_PRIORITY_IDLE) ||
+			(Priority == THREAD_PRIORITY_LOWEST) ||
+			(Priority == THREAD_PRIORITY_NORMAL) ||
+			(Priority == THREAD_PRIORITY_TIME_CRITICAL)) ,
+			string("Illegal Priority value specified for Thread in call to CThread::SetPriority()")) ;
+
+	Success = SetThreadPriority(ThreadHandle, Priority) ;	// set priority
+
+	PERR( Success == TRUE, string("Cannot Set Thread Priority\n")) ;	// check for error and print message if appropriate
+	
+	return Success ;
+}
+
+//
+//	This function limits the thread to the processors whose bits are set in the mask, which must
+//	be some of the processors of the process. Keeping a latency critical thread on a processor of
+//	its own stops other threads delaying it, while packing threads that share data onto a few
+//	processors keeps that data in their caches.
+//
+
+BOOL CThread::SetAffinity(DWORD_PTR Mask) const
+{
+	BOOL Success = (SetThreadAffinityMask(ThreadHandle, Mask) != 0) ;		// returns the old mask, 0 on failure
+	PERR( Success == TRUE, string("Cannot Set Thread Affinity\n")) ;
+
+	return Success ;
+}
+
+
+//
+//	This function will wait for the child thread specified by ThreadHandle to terminate
+//	main or parent threads can use this to wait for their child thread to terminate
+//
+//	A time period can be specified indicating the maximum time to attempt a wait
+//
+//	This function returns WAIT_FAILED if there was an error, WAIT_TIMEOUT if the wait operation timed out
+//	of WAIT_OBJECT_0 if the operation did in fact wait and then returned
+//
+
+//##ModelId=3DE6123A01B6
+UINT CThread::WaitForThread(DWORD Time) const		
+{
+	UINT Result = WAIT_FOR_OBJECT(ThreadHandle, Time) ;	// return WAIT_FAILED on error
+	PERR( Result != WAIT_FAILED, string("Cannot Wait For Thread")) ;	// check for error and print error message as appropriate
+
+	return Result ;
+}
+
+//	The following function sends a message to a thread
+//	If the thread is currently suspended, waiting for a message, then posting it a message
+//	will wake it up and allow it to continue
+//
+//	Message must bve in the range 0 - 32000
+//	In order to use messages, the thread receiving the message must have created a message queue.
+//	(See CMessageQueue later )
+//
+
+//##ModelId=3DE6123A01CA
+BOOL CThread::Post(UINT Message) const	// message value and ID of thread
+{
+	BOOL Result ;
+
+	if(Message > 32000)	{
+		PERR( Message <= 32000, string("Could not Post User Message: Message > 32000")) ;	// check for error and print error message as appropriate
+		return FALSE ;
+	}
+	else {
+		Result = PostThreadMessage(ThreadID, WM_USER + Message, 0, 0L) ;
+		PERR( Result != 0, string("Could not Post User Message. The Thread might have died")) ;	// check for error and print error message as appropriate
+		return Result ;
+	}
+}
+
+
+// constructs mutex with name and indicates whether 
+// object protected by mutex is owned by creator or not
+// Note use of default argument, i.e. if you do not 
+// specifiy a value for bOwned argument
+// then it will default to NOTOWNED
+
+//##ModelId=3DE6123A0397
+CMutex::CMutex(const string &Name, BOOL bOwned)		// needs a name for the mutex (i.e. a string) and a flag 
+													// indicating if the mutex is owned by the process that created it (Use OWNED or NOTOWNED for this value)
+	:MutexName(Name)
+{
+	if(bOwned == OWNED)	bOwned = TRUE ;
+	else				bOwned = FALSE ;
+
+	HoldDepth = 0 ;
+	HoldStart = 0 ;
+
+	pNamedWait = NAMED_WAIT(Name) ;
+
+	if(ObjectScope == PROCESS_OBJECTS)	{
+		MutexHandle = NULL ;
+		pProcessMutex = NEW_PROCESS_MUTEX(Name, bOwned) ;
+		return ;
+	}
+
+	pProcessMutex = NULL ;
+	MutexHandle  = SHARE_OBJECT("Mutex", Name, CreateMutex(NULL, bOwned, OBJECT_NAME(Name))) ;
+	PERR( MutexHandle != NULL, string("Cannot Create Mutex: ") + Name) ;	// check for error and print message if appropriate
+}
+
+
+//////////////////////////////////////////////////////////////////////
+//	unlinks a thread from a Mutex, provided you have its handle
+//	Returns TRUE/FALSE on SUCCESS/FAIL
+//	when all threads have unlinked from a mutex it will be destroyed automatically
+//////////////////////////////////////////////////////////////////////
+
+//##ModelId=3DE6123A0383
+BOOL	CMutex::Unlink() const
+{
+	BOOL Success = CLOSE_OBJECT((pProcessMutex != NULL) ? (void *)(pProcessMutex) : MutexHandle) ;
+	PERR( Success == TRUE, string("Cannot Unlink from Mutex:") + MutexName) ;	// check for error and print message if appropriate
+	return Success ;
+}		
+
+
+//
+//	This function will attempt to perform a WAIT on a Mutex. If the Mutex has been signalled
+//	(new mutexs are created in the 'signalled' or free state), then the process will be allowed to
+//	continue and the mutex will be set to the non-signalled state. This would mean
+//	that any other process coming along and performing a wait would be blocked until the mutex
+//	is signalled once again.
+//	
+//	This function returns WAIT_FAILED if there was an error, WAIT_TIMEOUT if the wait operation timed out
+//	of WAIT_OBJECT_0 if the operation did in fact wait and then returned
+//
+
+//##ModelId=3DE6123A036D
+UINT CMutex::Wait(DWORD Time) const				// return an unsigned int or UINT
+{
+	UINT	Result ;
+
+	if(pProcessMutex == NULL)
+		Result = OBJECT_WAIT(WAIT_FOR_HANDLE, MutexHandle, Time, &pNamedWait, MutexName, WAIT_SPIN) ;				// returns WAIT_FAILED on error
+	else
+		Result = OBJECT_WAIT(PROCESS_MUTEX_WAIT, pProcessMutex, Time, &pNamedWait, MutexName, WAIT_SPIN) ;
+
+	if((Result == WAIT_OBJECT_0 || Result == WAIT_ABANDONED) && HoldDepth ++ == 0)		// only the owner gets here until it signals
+		HoldStart = ContentionProfile ? GET_TIME_US() : 0 ;
+
+	PERR( Result != WAIT_FAILED, string("Cannot Perfom WAIT operation on Mutex: ") + MutexName) ;	// check for error and print message if appropriate
+	return Result ;
+}
+
+
+//
+//	This function will attempt to 'signal' a Mutex. This will allow one blocked
+//	process to proceed (setting the mutex back to the non-signalled state), otherwise
+//	if no processes are waiting/blocked, the mutex remains in the signalled state
+//	
+
+
+//##ModelId=3DE6123A0377
+BOOL CMutex::Signal() const
+{
+	if(HoldDepth > 0 && -- HoldDepth == 0)		// not for a mutex created owned, that was never waited for
+		RECORD_HOLD(pNamedWait, HoldStart) ;
+	BOOL Success = (pProcessMutex != NULL) ? PROCESS_MUTEX_SIGNAL(pProcessMutex) : ReleaseMutex( MutexHandle) ;		// FALSE on failure, TRUE on success
+	PERR( Success == TRUE, string("Cannot Perfom SIGNAL operation on Mutex: ") + MutexName) ;	// check for error and print message if appropriate
+	return Success ;
+}
+
+//
+//	This function reads the value of a Mutex, without signalling or waiting on it
+//	it can be used to poll the value of the Mutex to perhaps determine if it is safe to
+//	perform a wait without getting suspended/blocked
+//	returns WAIT_FAILED if there was an error.
+//
+//	If the Mutex has been signalled, then this function returns TRUE
+//	if the Mutex has NOT been signalled, then this function returns FALSE
+//
+
+//##ModelId=3DE6123A0381
+BOOL CMutex::Read() const	// Handle of the Mutex needed
+{							// returns true/false state of Mutex
+	BOOL Signalled ;
+
+	if(pProcessMutex != NULL)	{		// nothing to put back, just look at it
+		AcquireSRWLockShared(&pProcessMutex->Lock) ;
+		Signalled = (pProcessMutex->Owner == 0 || pProcessMutex->Owner == GetCurrentThreadId()) ;
+		ReleaseSRWLockShared(&pProcessMutex->Lock) ;
+		return (UINT)Signalled ;
+	}
+
+	// first wait for the object. Timeout is zero, so function
+	// should immediately wait and decrement the Mutex value if it is signalled (i.e. >1)
+	
+	Signalled = WaitForSingleObject(MutexHandle, 0) ;	// see of Mutex is signalled or not
+	PERR( Signalled != WAIT_FAILED, string("Cannot Perfom READ operation on Mutex: ") + MutexName) ;	// check for error and print message if appropriate	
+	
+	// Now if we did a wait and managed to decrement the Mutex, then
+	// the above function call should have returned WAIT_OBJECT_0, thus the process
+	// of attempting to read the Mutex has unfortunately resulted in its value
+	// being decremented, so we have to put that write by signalling it again. This should be
+	// safe, since we cannot exceed the limits of the Mutex max value as we are
+	// only putting it back to what it was before we attempted this
+
+	if(Signalled == WAIT_FAILED) 
+		return WAIT_FAILED ;
+
+	if(Signalled == WAIT_OBJECT_0)	{
+		BOOL Success = ReleaseMutex(MutexHandle) ;			// signal mutex if we decremented it
+		PERR( Success == TRUE, string("Cannot Perfom READ operation on Mutex: ") + MutexName) ;		// check for error and print message if appropriate
+		return (UINT)TRUE ;
+	}
+	else 
+		return (UINT)FALSE ;			// non-signalled
+
+}
+
+////////////////////////////////////////////////////////////
+//	ReaderWriters Mutex Problem
+////////////////////////////////////////////////////////////
+
+//
+//	This version gives preference to readers rather than writers
+//
+
+CReadersWritersMutex::CReadersWritersMutex(const string &MyName) : Name(MyName)
+{
+	ReadersWritersMutex = new CMutex(string("__CReadersWritersMutex__") + MyName) ;
+	ReadersWritersSemaphore = new CSemaphore(string("__CReadersWritersSemaphore__") + MyName, 1, 1) ;
+	ReadersWritersDataPool = new CDataPool(string("__CReadersWritersDataPool__") + MyName, sizeof(struct Data)) ;
+	ptr = (struct Data *)(ReadersWritersDataPool->LinkDataPool()) ;
+		
+	if(strcmp(ptr->Initialised, "Initialised") != 0)	{	// if pool not initialised
+		ptr->NumberOfReaders = 0 ;
+		strcpy_s(ptr->Initialised, "Initialised");			// show me as initialised
+	}
+}
+
+CReadersWritersMutex::~CReadersWritersMutex()
+{
+	delete ReadersWritersMutex;
+	delete ReadersWritersSemaphore;
+	strcpy_s(ptr->Initialised, "") ;
+	delete ReadersWritersDataPool;
+}
+
+//
+// called by a reader when they wish to access to the resource
+//
+void CReadersWritersMutex::WaitToRead()
+{
+	ReadersWritersMutex->Wait();			// wait for exclusive access
+
+	// increment the number of waiting readers
+
+	if(++(ptr->NumberOfReaders) == 1)		// if this is the 1st reader
+		ReadersWritersSemaphore->Wait();	// wait on the semaphore as a writer may be using the resource
+
+	ReadersWritersMutex->Signal() ;		// release access to resource
+}
+
+
+// 
+// called by a reader when they have finished with the resource
+//
+
+void CReadersWritersMutex::DoneReading() 
+{
+	ReadersWritersMutex->Wait();			// wait for exclusive access
+
+	// decrement the number of waiting readers
+	if(--(ptr->NumberOfReaders) == 0)			// if no readers
+		ReadersWritersSemaphore->Signal() ;		// signal that writers may now enter
+
+	ReadersWritersMutex->Signal() ;			// release access to resource
+}
+
+//
+// called by a writer when they wish to access to the resource
+//
+
+void CReadersWritersMutex::WaitToWrite()
+{
+	ReadersWritersSemaphore->Wait() ;		// used to exclude all readers
+}
+
+// 
+// called by a writer when they have finished with the resource
+//
+
+void CReadersWritersMutex::DoneWriting()
+{		
+	PERR((ptr->NumberOfReaders < 2) , "HELP");
+	ReadersWritersSemaphore->Signal() ;		// allow readers in
+}
+
+////////////////////////////////////////////////////////////
+//	WritersReader Mutex Problem
+////////////////////////////////////////////////////////////
+
+//
+//	This version gives preference to writers rather than readers
+//
+
+
+CWritersReadersMutex::CWritersReadersMutex(const string &MyName) : Name(MyName)
+{
+	WritersReadersMutex = new CMutex(string("__CWritersReadersMutex__") + MyName) ;
+	WritersReadersSemaphore = new CSemaphore(string("__CWritersReadersSemaphore__") + MyName, 1, 1) ;
+	WritersReadersCondition = new CCondition(string("__CWritersReadersCondition__") + MyName, MANUAL, SIGNALLED) ;
+
+	WritersReadersDataPool = new CDataPool(string("__CWritersReadersDataPool__") + MyName, sizeof(struct Data)) ;
+	ptr = (struct Data *)(WritersReadersDataPool->LinkDataPool()) ;
+		
+	if(strcmp(ptr->Initialised, "Initialised") != 0)	{	// if pool not initialised
+		ptr->NumberOfReaders = 0 ;
+		ptr->NumberOfWriters = 0 ;
+		strcpy_s(ptr->Initialised, "Initialised");			// show me as initialised
+	}
+}
+
+CWritersReadersMutex::~CWritersReadersMutex()
+{
+	delete WritersReadersMutex;
+	delete WritersReadersSemaphore;
+	delete WritersReadersCondition ;
+	strcpy_s(ptr->Initialised, "") ;
+	delete WritersReadersDataPool;
+}
+
+//
+// called by a reader when they wish to access to the resource
+//
+void CWritersReadersMutex::WaitToRead()
+{
+	WritersReadersCondition->Wait() ;		// wait until no writers
+	WritersReadersMutex->Wait();			// wait for exclusive access
+
+	// increment the number of waiting readers
+
+	if(++(ptr->NumberOfReaders) == 1)		// if this is the 1st reader
+		WritersReadersSemaphore->Wait();	// wait on the semaphore as a writer may be waiting to use the resource
+
+	WritersReadersMutex->Signal() ;		// release access to resource
+}
+
+
+// 
+// called by a reader when they have finished with the resource
+//
+void CWritersReadersMutex::DoneReading() 
+{
+	WritersReadersMutex->Wait();				// wait for exclusive access
+
+	if(--(ptr->NumberOfReaders) == 0)			// if no readers
+		WritersReadersSemaphore->Signal() ;		// signal last reader has left and that any waiting writers may now enter
+
+	WritersReadersMutex->Signal() ;				// release access to resource
+}
+
+//
+// called by a writer when they wish to access to the resource
+//
+void CWritersReadersMutex::WaitToWrite()
+{
+	WritersReadersMutex->Wait();				// wait for exclusive access to data
+
+	if(++(ptr->NumberOfWriters) == 1 )			// if I am the only writer waiting
+		WritersReadersCondition->Reset() ;		// block future readers until this writer has gained access and has released it
+
+	WritersReadersMutex->Signal() ;				// release access to data
+	
+	WritersReadersSemaphore->Wait() ;			// wait until all other process have left resource (readers or writers)
+}
+
+// 
+// called by a writer when they have finished with the resource
+//
+void CWritersReadersMutex::DoneWriting()
+{		
+	WritersReadersSemaphore->Signal() ;				// allow next writer or reader in depending on who is first in line
+
+	WritersReadersMutex->Wait();					// wait for exclusive access to data
+
+	if(--(ptr->NumberOfWriters) == 0 )				// if there are no more waiting writers
+		WritersReadersCondition->Signal() ;			// remove the condition blocking entry by readers
+		
+	WritersReadersMutex->Signal() ;					// release access to data
+	
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////
+//	CRendezvous Class
+///////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+CRendezvous::CRendezvous(const string &TheRendezvousName, int NumberThreads) : RendezvousName(TheRendezvousName)
+{
+	RendezvousMutex = new CMutex(string("__RendezvousMutex__") + RendezvousName) ;
+	RendezvousEvent = new CEvent(string("__RendezvousEvent__") + RendezvousName) ;
+		
+	RendezvousDataPool = new CDataPool(string("__RendezvousDataPool__") + RendezvousName, sizeof(struct RendezvousData)) ;
+	ptr = (struct RendezvousData *)(RendezvousDataPool->LinkDataPool()) ;
+
+	RendezvousMutex->Wait() ;
+	if(strcmp(ptr->Initialised, "Initialised") != 0)	// if not initialised
+	{
+		strcpy_s(ptr->Initialised, "Initialised") ;							// initialise it
+		ptr->NumberWaiting = NumberThreads ;					// set number of threads waiting to rendezvous
+		ptr->NumThreads = NumberThreads ;
+		ptr->Generation = 0 ;
+	}
+	else								// check the number is the same as previous initialisation of this rendezvous
+		PERR(NumberThreads == ptr->NumThreads, string("Rendezvous '") + RendezvousName + string("' Already Created with a Different Number of Clients")) ;
+
+	RendezvousMutex->Signal() ;
+}
+
+//
+//	The event is only pulsed, so a thread that has not yet reached RendezvousEvent->Wait() would miss it.
+//	Waiting threads therefore watch the generation, which the last thread to arrive moves on, and only
+//	use the event to wake up early. This also lets the deterministic scheduler run the rendezvous
+//
+
+UINT CRendezvous::Wait(DWORD Time) {
+	ULONGLONG Start = GET_TIME_US() ;
+
+	RendezvousMutex->Wait() ;
+	LONG Generation = ptr->Generation ;
+	if(--(ptr->NumberWaiting) == 0)
+	{
+		ptr->NumberWaiting = ptr->NumThreads ;			// reset the count
+		InterlockedIncrement(&ptr->Generation) ;
+		RendezvousEvent->Signal() ;			// release all waiting threads
+		RendezvousMutex->Signal() ;
+		return WAIT_OBJECT_0 ;
+	}
+	RendezvousMutex->Signal() ;
+
+	while(ptr->Generation == Generation)	{
+		ULONGLONG Waited = (GET_TIME_US() - Start) / 1000 ;
+		if(Time != INFINITE && Waited >= Time)	{
+			RendezvousMutex->Wait() ;
+			BOOL Arrived = (ptr->Generation != Generation) ;
+			if(!Arrived)
+				ptr->NumberWaiting ++ ;			// no longer waiting, so the others still need this thread
+			RendezvousMutex->Signal() ;
+			return Arrived ? WAIT_OBJECT_0 : WAIT_TIMEOUT ;
+		}
+
+		DWORD Poll = RENDEZVOUS_POLL ;
+		if(Time != INFINITE && Time - Waited < Poll)
+			Poll = (DWORD)(Time - Waited) ;
+		RendezvousEvent->Wait(Poll) ;
+	}
+	return WAIT_OBJECT_0 ;
+}
+
+CRendezvous::~CRendezvous()
+{
+	strcpy_s(ptr->Initialised, "") ;
+	delete RendezvousDataPool ;
+	delete RendezvousMutex ;
+	delete RendezvousEvent ;
+}
+
+
+////////////////////////////////////////////////////////////
+//	Event Functions
+////////////////////////////////////////////////////////////
+
+
+CEvent::CEvent(const string &Name, BOOL bType, BOOL bState)			// btype = SINGLE_RELEASE or MULTIPLE_RELEASE to allow one or many thread to resume when event is signalled
+{																	// bState = SIGNALLED or NOTSIGNALLED to indicate the initial or creation state of the event
+	PERR(bState == SIGNALLED || bState == NOTSIGNALLED, string("Illegal Signalled/NotSignalled Type specified when creating CEvent: ") + EventName) ;
+	
+	if(bState == SIGNALLED)		
+		bState = TRUE ;
+	else
+		bState = FALSE ;
+
+	PERR(bType == SINGLE_RELEASE || bType == MULTIPLE_RELEASE, string("Illegal Single or Multithread Type specified when creating CEvent: ") + EventName) ;
+	
+	if(bType == SINGLE_RELEASE)
+		bType = FALSE ;			// Win32 Auto-reset event
+	else
+		bType = TRUE ;			// Win32 manual-reset event
+	
+	pNamedWait = NAMED_WAIT(Name) ;
+	EventHandle = SHARE_OBJECT("Event", Name, CreateEvent(NULL, bType, bState, OBJECT_NAME(Name))) ;		
+	PERR( EventHandle != NULL, string("Cannot Create CEvent: ") + Name) ;	// check for error and print message if appropriate
+}
+	
+BOOL CEvent::Unlink() const {								// unlink from event, i.e. we have finished using it
+	BOOL Success = CLOSE_OBJECT(EventHandle) ;
+	PERR(Success != 0, string("Cannot Unlink the CEvent: ") + EventName) ;	// check for error and print message if appropriate
+	return Success ;
+}
+
+// Signal() sets the event and will release ONLY ONE Waiting thread. It is then automatically reset.
+// If no thread is waiting at the time it is signalled, then it is STILL RESET immediately
+
+BOOL CEvent::Signal() const 
+{ 	
+	BOOL Success = PulseEvent(EventHandle) ;
+	PERR( Success != 0, string("Cannot SignalAndReset() the CEvent: ") + EventName) ;	// check for error and print message if appropriate
+	return Success ; 
+}
+	
+UINT CEvent::Wait(DWORD Time) const 			// perform a wait on an event for ever or until specified time
+{
+	UINT	Status = OBJECT_WAIT(WAIT_FOR_HANDLE, EventHandle, Time, &pNamedWait, EventName, WAIT_TEST) ;
+	PERR(Status != WAIT_FAILED, string("Cannot Wait for CEvent: ") + EventName) ;	// check for error and print message if appropriate
+	return Status ;
+}
+
+////////////////////////////////////////////////////////////
+//	Condition Functions
+////////////////////////////////////////////////////////////
+
+CCondition::CCondition(const string &Name, BOOL bType, BOOL bState) 
+	:ConditionName(Name)
+{
+	pNamedWait = NAMED_WAIT(Name) ;
+
+	PERR(bState == SIGNALLED || bState == NOTSIGNALLED, string("Illegal Signalled/NotSignalled Type specified when creating CCondition: ") + ConditionName) ;
+
+	if(bState == SIGNALLED)		bState = TRUE ;
+	else						bState = FALSE ;
+
+	PERR(bType == MANUAL || bType == AUTORESET, string("Illegal Signalled/NotSignalled Type specified when creating CCondition: ") + ConditionName) ;
+
+	if(bType == MANUAL)		bType = TRUE ;
+	else					bType = FALSE ;
+
+	
+	ConditionHandle = SHARE_OBJECT("Event", Name, CreateEvent(NULL, bType, bState, OBJECT_NAME(Name))) ;		// based around a Win32 manual event
+	PERR( ConditionHandle != NULL, string("Cannot Create CCondition: ") + Name) ;	// check for error and print message if appropriate
+}
+
+BOOL CCondition::Unlink() const {								// unlink from Condition, i.e. we have finished using it
+	BOOL Success = CLOSE_OBJECT(ConditionHandle) ;
+	PERR(Success != 0, string("Cannot Unlink the CCondition: ") + ConditionName) ;	// check for error and print message if appropriate
+	return Success ;
+}
+
+
+// Signal() sets the Condition and will release ALL Waiting threads. It can be reset by calling Reset()
+BOOL CCondition::Signal() const { 	
+	BOOL Success = SetEvent(ConditionHandle) ;
+	PERR( Success != 0, string("Cannot Set() the CCondition: ") + ConditionName) ;	// check for error and print message if appropriate
+	return Success ; 
+}	
+	
+
+UINT CCondition::Wait(DWORD Time) const 			// perform a wait on a Condition for ever or until specified time
+{
+	UINT	Status = OBJECT_WAIT(WAIT_FOR_HANDLE, ConditionHandle, Time, &pNamedWait, ConditionName, WAIT_TEST) ;
+	PERR(Status != WAIT_FAILED, string("Cannot Wait for CCondition: ") + ConditionName) ;	// check for error and print message if appropriate
+	return Status ;
+}
+
+BOOL CCondition::Reset() const		// reset the condition back to false or not signalled
+{
+	BOOL Success = ResetEvent(ConditionHandle) ;
+	PERR( Success != 0, string("Cannot Reset CCondition: ") + ConditionName) ;	// check for error and print message if appropriate
+	return Success ;
+}
+	
+BOOL CCondition::Test() const 									// see if condition is signalled	
+{
+	UINT	Status = WaitForSingleObject(ConditionHandle, 0) ;
+	PERR( Status != WAIT_FAILED, string("Cannot Test Value of CAutoResetCondition: ") + ConditionName) ;	// check for error and print message if appropriate
+
+	if(Status == WAIT_FAILED)
+		return WAIT_FAILED ;
+	else if(Status == WAIT_OBJECT_0)		// if event signalled
+		return TRUE ;						// return TRUE
+	else 
+		return FALSE ;						// esle return FALSE
+}
+
+
+////////////////////////////////////////////////////////////
+//	Semaphore Functions
+////////////////////////////////////////////////////////////
+//
+//	Semaphore's are used primarily by processes that need to make sure that a limited number of
+//	processes are allowed to access a resource at any one time.
+//
+//	In order to use a Semaphore, create one using the function below, giving it a name
+//	if the Semaphore is new, i.e. there is not already a Semaphore with that name in existence, 
+//	then a new one will be created using the initial value specified and limiting its maximum value to that specified
+//	However, if one already exists, then the function below simply links to it 
+//	or creates a reference to it. (the max and initial values will in this instance be ignored)
+//
+//	In essence, all processes that wish to use the Semaphore attempt to create it.
+//	Only one process will actually create it, the others simply reference or share the Semaphore
+//	with the same name. In either case, the function returns a HANDLE to the object.
+//	This handle can be used in subsequent calls relating to the use of Semaphores. In the event
+//	that an error occurs, the returned value of the Handle will be NULL. the calling process
+//	can check this and take appropriate action
+//
+//	An alternative is to use the LINK_SEMAPHORE() function below if you only want to
+//	use the Semaphore and not create it
+//
+//	For a Binary semaphore specify Max value as 1
+
+
+// construct semaphore by name with initial and max 
+//permissible values
+//##ModelId=3DE6123B02A6
+CSemaphore::CSemaphore(const string &Name, int InitialVal, int MaxVal)	// name, starting value and Maximum value needed
+	:SemaphoreName(Name)
+{
+	pNamedWait = NAMED_WAIT(Name) ;
+
+	if(ObjectScope == PROCESS_OBJECTS)	{
+		SemaphoreHandle = NULL ;
+		pProcessSemaphore = NEW_PROCESS_SEMAPHORE(Name, InitialVal, MaxVal) ;
+		return ;
+	}
+
+	pProcessSemaphore = NULL ;
+	SemaphoreHandle = SHARE_OBJECT("Semaphore", Name, CreateSemaphore(0, InitialVal, MaxVal, OBJECT_NAME(Name))) ;
+	PERR( SemaphoreHandle != NULL, string("Cannot Create Semaphore: ") + Name) ;	// check for error and print message if appropriate
+}
+
+
+
+//////////////////////////////////////////////////////////////////////
+//	unlinks a Semaphore, provided you have its handle
+//	Returns TRUE/FALSE on SUCCESS/FAIL
+//	
+//	A sempahore is removed when all threads have unlinked from it
+//////////////////////////////////////////////////////////////////////
+
+//##ModelId=3DE6123B0293
+BOOL	CSemaphore::Unlink() const	// Handle of the semaphore needed
+{													// return TRUE/FALSE on Success/Failure
+	BOOL Success = CLOSE_OBJECT((pProcessSemaphore != NULL) ? (void *)(pProcessSemaphore) : SemaphoreHandle) ;
+	PERR( Success == TRUE, string("Cannot Unlink from Semaphore: ") + SemaphoreName ) ;	// check for error and print message if appropriate
+	return Success ;
+}
+
+
+//
+//	This function will attempt to perform a wait on a sempahore. If the sempahore has been signalled
+//	(new sempahores are NOT necessarily created in the 'signalled' state), then the process will be allowed to
+//	continue and the sempahore will be set to the non-signalled state. This would mean
+//	that any other process coming along and performing a wait would be blocked until the sempahore
+//	is signalled once again.
+//
+//	This function returns WAIT_FAILED if there was an error, WAIT_TIMEOUT if the wait operation timed out
+//	of WAIT_OBJECT_0 if the operation did in fact wait and then returned
+///
+
+//##ModelId=3DE6123B0277
+UINT CSemaphore::Wait(DWORD Time) const	// Handle of the semaphore needed
+{
+	UINT Result ;
+
+	if(pProcessSemaphore == NULL)
+		Result = OBJECT_WAIT(WAIT_FOR_HANDLE, SemaphoreHandle, Time, &pNamedWait, SemaphoreName, WAIT_SPIN) ;		// return WAIT_FAILED on error
+	else
+		Result = OBJECT_WAIT(PROCESS_SEMAPHORE_WAIT, pProcessSemaphore, Time, &pNamedWait, SemaphoreName, WAIT_SPIN) ;
+
+	PERR( Result != WAIT_FAILED, string("Cannot Wait on Semaphore: ") + SemaphoreName ) ;	// check for error and print message if appropriate
+	return Result ;
+}
+
+
+//
+//	This function will attempt to 'signal' a semaphore. This will allow one or more blocked
+//	process to proceed (setting the mutex back to the non-signalled state), otherwise
+//	if no processes are waiting/blocked, the sempahore remains in the signalled state
+//	
+
+//##ModelId=3DE6123B027F
+BOOL CSemaphore::Signal( int Increment)	const	// value by which sempahore increases (default is 1)
+{											// return TRUE/FALSE on Success/Failure
+	BOOL Success = (pProcessSemaphore != NULL) ? PROCESS_SEMAPHORE_SIGNAL(pProcessSemaphore, Increment) : ReleaseSemaphore( SemaphoreHandle, Increment, NULL) ; 
+	PERR( Success == TRUE, string("Cannot Signal Semaphore: ") + SemaphoreName + string("\nMaxmimum Value may have been exceeded")) ;	// check for error and print message if appropriate
+	return Success ;
+}
+
+
+
+//
+//	This function reads the value of a Semaphore, without signalling or waiting on it
+//	it can be used to poll the value of the Semaphore to perhaps determine if it is safe to
+//	perform a wait without getting suspended/blocked
+//	returns WAIT_FAILED if there was an error	
+//
+//	If the Semaphore has been signalled, then this function returns TRUE
+//	if the Semaphore has NOT been signalled, then this function returns FALSE
+//
+
+
+//##ModelId=3DE6123B0289
+UINT CSemaphore::Read() const	// Handle of the semaphore needed
+{												// returns current value of semaphore
+	BOOL Signalled ;
+
+	if(pProcessSemaphore != NULL)	{		// nothing to put back, just look at it
+		AcquireSRWLockShared(&pProcessSemaphore->Lock) ;
+		UINT Value = (UINT)(pProcessSemaphore->Value) ;
+		ReleaseSRWLockShared(&pProcessSemaphore->Lock) ;
+		return Value ;
+	}
+
+	// first wait for the object. Timeout is zero, so function
+	// should immediately wait and decrement the sempahores value if it is signalled (i.e. >1)
+	
+	Signalled = WaitForSingleObject(SemaphoreHandle, 0) ;	// see of semaphore is signalled or not
+	PERR( Signalled != WAIT_FAILED, string("Cannot Read Semaphore: ") + SemaphoreName ) ;	// check for error and print message if appropriate	
+	
+	// Now if we did a wait and managed to decrement the semaphore, then
+	// the above function call should have returned WAIT_OBJECT_0, thus the process
+	// of attempting to read the semaphore has unfortunately resulted in its value
+	// being decremented, so we have to put that write by signalling it again. This should be
+	// safe, since we cannot exceed the limits of the sempahores max value as we are
+	// only putting it back to what it was before we attempted this
+	//
+	//	In the process of putting it back, we also get the value of the semaphore as
+	//	a bonus (+1 added to make sure it the value before be decremented it
+	//
+	//	You might well ask why we cannot simply just use ReleaseSemaphore and specify an
+	//	increment of 0 in place of all this code, so that the sempahore doesn't change at all
+	//	but we get the previous value back. That is what we are after in the end isn't it ?
+	//	The answer is that it work in Windoes 95/98 but not on NT which insists
+	//	on having a release value > 0 and thus doesn't have a future in windows 2000
+
+	if(Signalled == WAIT_OBJECT_0)	{
+		LONG Prev ;		// to hold the previous value of the semapahore
+		BOOL Success = ReleaseSemaphore(SemaphoreHandle, 1, &Prev) ;
+		PERR( Success == TRUE, string("Cannot Signal Semaphore") + SemaphoreName ) ;	// check for error and print message if appropriate
+		return (UINT)(Prev+1) ;	// returns true if semaphore signalled
+	}
+
+	else if(Signalled == WAIT_TIMEOUT)	// the operation timed-out and the sempahore is not-signalled
+		return (UINT)0 ;				// non-signalled
+
+	else
+		return WAIT_FAILED ;			// error, possibly invalid handle
+
+}
+
+
+//
+//	The following function can be used to prevent DEADLOCK in a multi-threaded
+//	application where several thread/processes are competing to acquire resources
+//
+//	For example consider two processes A and B, both waiting for both resources X and Y.
+//	If Process A manages to acquire X (via a wait on it Mutex) and Process B acquires Y (via its mutex)
+//	and then both A and B try to acquire the other resource that is now owned by the other
+//	process, a deadlock arises, where each process blocks the other.
+//
+//	One way around this would be for one or other process to release its currently owned resource
+//	and try again some short time later and hope that it then successful in acquiring
+//	both resources, but you can never be sure and its not a good solution in real-time systems
+//
+//	Windows therefore provides this function to allow a thread/process to simply wait until
+//	all the resources it requires are free, and then grab them all in one indivisible
+//	operation, that is, no other thread can grab half of them while this is going on
+//
+//	In essence, the function simply requires an array of HANDLES. These handles 
+//	are the handles to objects such as mutex's, semaphores, events etc that protect a required resource.
+//	If the objects have been signalled, then they are free and not owned by a thread.
+//	This function will wait until all handles are in their signalled state and then acquire
+//	them by setting them back to their non-signalled state (as it you had done a wait on them)
+//	thus preventing other threads from acquiring them.
+//	Of course you have to remember to release the resource EACH resource when you have finished
+//
+//	This function returns WAIT_FAILED if there was an error or WAIT_TIMEOUT if the wait operation timed out
+//
+
+UINT	WAIT_FOR_MULTIPLE_OBJECTS(	UINT nCount,             // number of handles in the handle array
+									CONST HANDLE *lpHandles,  // pointer to the object-handle array
+									DWORD Time
+								)
+{
+	UINT Result = WaitForMultipleObjects(nCount, lpHandles, TRUE, Time) ;
+	PERR( Result != WAIT_FAILED, string("Cannot Wait for Multiple Objects")) ;	// check for error and print message if appropriate
+	return Result;
+}
+
+
+///////////////////////////////////////////////////////////////////////
+// Example
+//////////////////////////////////////////////////////////////////////
+/*
+
+#include <stdio.h>
+#include "rt.h"
+  
+int main()
+{
+	...
+	...
+	CSemaphore c1(.....) , c2(.....) ;					// two sempahore objects
+	CEvent		e1(.....), e2(.....) ;					// two event objects
+
+	
+	HANDLE	hArray[4] = {c1.GetHandle(), c2.GetHandle(), e1.GetHandle(), e2.GetHandle() } ;
+	
+	WAIT_FOR_MULTIPLE_OBJECTS(4,hArray) ;	// wait for all objects
+
+	...
+	...
+	return 0 ;
+}
+
+*/
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////
+//	PIPELINE Functions
+//	
+//	The following functions are C++ member function for the CPipe class
+//	See example usage later, after the code for all the functions has been shown
+//////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//	This is the constructor to create a Pipeline object. All you need is the name of the pipeline
+//	The size of the pipeline is controlled by the '__PIPESIZE__' constant in the "rt.h" header file
+//
+//	Note that this function will attempt to create the pipeline and then open it. If the pipeline already exists
+//	then it does not create it, it simply opens it
+//	
+//	In this implementation, the pipeline will be destroyed when both reading and writing process
+//	terminate
+//
+//	The size is rounded up to whole pages, as that is what a datapool uses anyway. A pipeline of at
+//	least the allocation granularity (64K) is rounded up to a multiple of it instead and its data is
+//	mapped twice, one view straight after the other, so that the byte after the last one is the
+//	first one again. A message that goes past the end of the buffer can then be copied in or out,
+//	or used where it is, as one piece.
+//
+
+static UINT PIPE_CAPACITY(UINT SizeOfPipe, BOOL &Mirror)	// size of the data actually made for a pipeline
+{
+	SYSTEM_INFO Info ;
+	GetSystemInfo(&Info) ;
+
+	UINT Unit = (SizeOfPipe >= Info.dwAllocationGranularity) ? Info.dwAllocationGranularity : Info.dwPageSize ;
+	UINT Capacity = (SizeOfPipe + Unit - 1) / Unit * Unit ;
+
+	Mirror = (Capacity % Info.dwAllocationGranularity == 0) ;
+	return Capacity ;
+}
+
+//	Maps the whole of a file mapping of Capacity bytes twice, the second view straight after the
+//	first. The address space is found by reserving and releasing it, so another thread can take it
+//	in between, in which case it tries again. Returns NULL if it cannot be done
+
+static BYTE *MAP_MIRRORED(HANDLE hMapping, UINT Capacity)
+{
+	for(int Attempt = 0; Attempt < 8; Attempt ++)	{
+		BYTE *Base = (BYTE *)VirtualAlloc(NULL, (SIZE_T)(Capacity) * 2, MEM_RESERVE, PAGE_NOACCESS) ;
+		if(Base == NULL)
+			return NULL ;
+		VirtualFree(Base, 0, MEM_RELEASE) ;
+
+		BYTE *First = (BYTE *)MapViewOfFileEx(hMapping, FILE_MAP_WRITE, 0, 0, Capacity, Base) ;
+		BYTE *Second = (First != NULL) ? (BYTE *)MapViewOfFileEx(hMapping, FILE_MAP_WRITE, 0, 0, Capacity, Base + Capacity) : NULL ;
+
+		if(Second != NULL)
+			return First ;
+		if(First != NULL)
+			UnmapViewOfFile(First) ;
+	}
+	return NULL ;
+}
+
+static BOOL UNMAP_MIRRORED(void *Data)
+{
+	MEMORY_BASIC_INFORMATION Info ;		// the size of the first view tells us where the second one is
+
+	if(VirtualQuery(Data, &Info, sizeof(Info)) == 0)
+		return FALSE ;
+
+	BOOL Success = UnmapViewOfFile((BYTE *)(Data) + Info.RegionSize) ;
+	return UnmapViewOfFile(Data) && Success ;
+}
+
+//	In PROCESS_OBJECTS scope a mirrored pipeline uses an unnamed file mapping instead of heap memory,
+//	shared by name within the process like PROCESS_MEMORY(). The views keep the mapping alive so its
+//	handle is closed straight away
+
+static BYTE *PROCESS_MIRRORED_MEMORY(const string &Name, UINT Capacity)
+{
+	HANDLE hMapping = CreateFileMapping(INVALID_HANDLE_VALUE, NULL, PAGE_READWRITE, 0, Capacity, NULL) ;
+	if(hMapping == NULL)
+		return NULL ;
+
+	BYTE *Data = MAP_MIRRORED(hMapping, Capacity) ;
+	CloseHandle(hMapping) ;
+	if(Data == NULL)
+		return NULL ;
+
+	return (BYTE *)(LINK_OBJECT("ProcessMirror", Name, Data, UNMAP_MIRRORED)) ;
+}
+
+
+//##ModelId=3DE6123C03AB
+CPipe::CPipe(const string &Name, UINT SizeOfPipe) :PipeName(Name)
+{
+	// check the pipeline meets minimum size requirements of 2 bytes
+
+	if(SizeOfPipe < 1)	{
+		printf("Sorry Pipeline size is too small, Minimum is 1 byte.\n") ;	// check for error and print error message as appropriate
+		getchar() ;
+		exit(0) ;
+	}
+
+
+	const string PipeName = "__PipeLine__" + Name;
+	const string PipeDataName = "__PipeLineData__" + Name;
+	const string MutexName = "__PipelineMutex__" + Name;
+	const string ProdSemaName = "__PipelineProducerSemaphore__" + Name;
+	const string ConSemaName = "__PipelineConsumerSemaphore__" + Name;
+	const string WriterMutexName = "__PipelineWriterMutex__" + Name;
+	const string ReaderMutexName = "__PipelineReaderMutex__" + Name;
+
+	SizeOfPipe = PIPE_CAPACITY(SizeOfPipe, Mirrored) ;
+		
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	// now create the pipeline as a small data pool based around the contents of the struct PipeContents 
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	if(ObjectScope == PROCESS_OBJECTS)	{		// plain heap memory, see SET_OBJECT_SCOPE()
+		hPipe = NULL ;
+		hData = NULL ;
+		PipePointer = (PIPECONTROL *)PROCESS_MEMORY(PipeName, sizeof(PIPECONTROL)) ;
+		DataPointer = Mirrored ? PROCESS_MIRRORED_MEMORY(PipeDataName, SizeOfPipe) : NULL ;
+		if(DataPointer == NULL)	{
+			Mirrored = FALSE ;
+			DataPointer = (BYTE *)PROCESS_MEMORY(PipeDataName, SizeOfPipe) ;
+		}
+
+		PERR(PipePointer != NULL && DataPointer != NULL, string("Cannot Make Datapool For Pipeline ") + Name) ;
+		if(PipePointer == NULL || DataPointer == NULL)
+			exit(0) ;
+	}
+	else	{
+		hPipe = SHARE_OBJECT("Datapool", PipeName, CreateFileMapping((HANDLE)0xFFFFFFFF, 
+							NULL, 
+							PAGE_READWRITE,
+							0,
+							sizeof(PIPECONTROL),
+							OBJECT_NAME(PipeName)
+		)) ;
+	
+		PERR(hPipe != NULL, string("Cannot Make Datapool For Pipeline ") + Name) ;	// check for error and print error message as appropriate
+	
+		PipePointer = (PIPECONTROL *)MapViewOfFile(
+			hPipe,						// file-mapping object to map into 
+										// address space
+			FILE_MAP_WRITE ,
+			0,							// high-order 32 bits of file offset
+			0,							// low-order 32 bits of file offset
+			0							// number of bytes to map, 0 means all
+		) ;
+
+
+		PERR(PipePointer != NULL, string("Cannot Make Datapool For Pipeline ") + Name) ;	// check for error and print error message as appropriate
+	
+		if(PipePointer == NULL)		{
+			CLOSE_OBJECT(hPipe) ;	// close datapool handle
+			exit(0) ;
+		} 
+
+
+		/////////////////////////////////////////////////////////////////////////////////////////////
+		// now a datapool for the data in the pipeline itself
+		/////////////////////////////////////////////////////////////////////////////////////////////
+
+		hData = SHARE_OBJECT("Datapool", PipeDataName, CreateFileMapping((HANDLE)0xFFFFFFFF, 
+							NULL, 
+							PAGE_READWRITE,
+							0,
+							SizeOfPipe,
+							OBJECT_NAME(PipeDataName)
+		)) ;
+	
+		PERR(hData != NULL, string("Cannot Make Datapool For Pipeline ") + Name) ;	// check for error and print error message as appropriate
+	
+		DataPointer = (Mirrored && hData != NULL) ? MAP_MIRRORED(hData, SizeOfPipe) : NULL ;
+
+		if(DataPointer == NULL)	{
+			Mirrored = FALSE ;
+			DataPointer = (BYTE *)MapViewOfFile(
+				hData,						// file-mapping object to map into 
+											// address space
+				FILE_MAP_WRITE ,
+				0,							// high-order 32 bits of file offset
+				0,							// low-order 32 bits of file offset
+				0							// number of bytes to map, 0 means all
+			) ;
+		}
+
+
+		PERR(DataPointer != NULL, string("Cannot Make Datapool For Pipeline ") + Name) ;	// check for error and print error message as appropriate
+	
+		if(DataPointer == NULL)		{
+			CLOSE_OBJECT(hPipe) ;	// close datapool handle
+			CLOSE_OBJECT(hData) ;
+			exit(0) ;
+		}
+	}
+
+
+	// create mutex name for this pipeline and create the producer and consumer semaphores
+
+	pMutex = new CMutex(MutexName) ;
+	pProdSemaphore = new CSemaphore(ProdSemaName,  0, SizeOfPipe) ;					// wakes readers, one unit for each waiting, far fewer than SizeOfPipe
+	pConSemaphore = new CSemaphore(ConSemaName, 0, SizeOfPipe) ;					// ditto writers
+	pWriterMutex = new CMutex(WriterMutexName) ;								// one Reserve() and one Peek() at a time
+	pReaderMutex = new CMutex(ReaderMutexName) ;
+
+	ReservePointer = NULL ;
+	ReserveSize = 0 ;
+	PeekPointer = NULL ;
+	PeekSize = 0 ;
+
+	if(!Mirrored)	{								// so a message that wraps never needs the heap later on
+		WriteStage.reserve(SizeOfPipe) ;
+		ReadStage.reserve(SizeOfPipe) ;
+	}
+
+	// now allocate some storage for the datapool and initialise the pointers which are all in the datapool
+	// for cross process communication
+
+	pMutex->Wait() ;
+	if(PipePointer->Initialised != 0x4afc)	{		// if datapool not initialised
+		PipePointer->Initialised = 0x4afc ;			// show as being initialised
+		PipePointer->ReadingIndex = 0 ;		
+		PipePointer->WritingIndex = 0 ;
+		PipePointer->NumBytes = 0 ;
+		PipePointer->SizeOfPipe = SizeOfPipe ;
+		PipePointer->Overflows = 0 ;
+		PipePointer->Reserved = 0 ;
+		PipePointer->Peeked = 0 ;
+		PipePointer->Readers = 0 ;
+		PipePointer->Writers = 0 ;
+	}
+	else	{	// if it is initialised, make sure the size was specified the same in all processes creating it
+		PERR( SizeOfPipe == PipePointer->SizeOfPipe, string("Size of Pipeline Name:") + PipeName + string(" Conflicts with size already specified by another process"));	// check for error and print error message as appropriate
+		if(SizeOfPipe != PipePointer->SizeOfPipe)	{
+			CLOSE_OBJECT(hPipe) ;	// close datapool handles
+			CLOSE_OBJECT(hData) ;
+			exit(0);
+		}
+	}
+
+	pMutex->Signal() ;
+}
+
+
+
+//the constant __PIPESIZE__ in rt.h header file, 
+//currently set to 1024 bytes
+
+//##ModelId=3DE6123C03B5
+CPipe::~CPipe()
+{
+	pMutex->Wait() ;
+
+	if(hPipe == NULL)	{							// PROCESS_OBJECTS memory goes when the last CPipe using it does
+		BOOL PipeClosed = CLOSE_OBJECT(PipePointer) ;		// both, even if the first fails
+		BOOL DataClosed = CLOSE_OBJECT(DataPointer) ;
+		PERR( PipeClosed == TRUE && DataClosed == TRUE, string("Cannot Destroy Datapool Object for Pipeline: ") + PipeName);
+	}
+	else if(PipePointer->NumBytes == 0)	{			// if no data in pipeline
+		PipePointer->Initialised = 0 ;			// show pipeline as uninitialised
+
+		BOOL Success = UnmapViewOfFile(PipePointer) ;	// unlink from data pool view
+		PERR( Success == TRUE, string("Cannot Destroy Datapool Object for Pipeline: ") + PipeName);	// check for error and print error message as appropriate
+
+		Success = CLOSE_OBJECT(hPipe) ;	// close handle to pipeline
+		PERR( Success == TRUE, string("Cannot Destroy Datapool Object for Pipeline: ") + PipeName);	// check for error and print error message as appropriate
+
+		Success = Mirrored ? UNMAP_MIRRORED(DataPointer) : UnmapViewOfFile(DataPointer) ;	// unlink from data pool view(s)
+		PERR( Success == TRUE, string("Cannot Destroy Datapool Object for Pipeline: ") + PipeName);	// check for error and print error message as appropriate
+
+		Success = CLOSE_OBJECT(hData) ;	// close handle to pipeline
+		PERR( Success == TRUE, string("Cannot Destroy Datapool Object for Pipeline: ") + PipeName);	// check for error and print error message as appropriate
+	
+	}
+
+	pMutex->Signal() ;
+
+	delete pMutex ;
+	delete pConSemaphore ;
+	delete pProdSemaphore ;
+	delete pWriterMutex ;
+	delete pReaderMutex ;
+}
+
+
+//
+//	The space and data in a pipeline are counted in PIPECONTROL under its mutex. The producer and
+//	consumer semaphores only wake readers waiting for data and writers waiting for space, with one
+//	unit for each thread waiting, so a write or read that does not have to wait costs the mutex and
+//	nothing more, however many bytes it moves. A writer waits for room for the whole of a message
+//	that fits in the pipeline, and a reader for all the data it asked for, so messages go in and
+//	come out in one piece, unless the other end is waiting as well, when they make do with what
+//	there is rather than both waiting for ever. Nothing is held while waiting
+//
+
+#define	PIPE_FOREVER	((ULONGLONG)(-1))		// deadline of a wait with no time limit
+
+static ULONGLONG PIPE_DEADLINE(DWORD Time)
+{
+	return (Time == INFINITE) ? PIPE_FOREVER : GET_TIME_US() + (ULONGLONG)(Time) * 1000 ;
+}
+
+//
+//	Called with the pipeline mutex held, which it lets go while blocked on 'Wakeup'. Returns TRUE
+//	when woken, to have another look, or FALSE if 'Deadline' passed first. A waiter that times out
+//	just as it is woken takes its unit, so the count of waiters and the units always match
+//
+
+BOOL CPipe::Block(CSemaphore *Wakeup, UINT *Waiting, ULONGLONG Deadline)
+{
+	DWORD Time = INFINITE ;
+	if(Deadline != PIPE_FOREVER)	{
+		ULONGLONG Now = GET_TIME_US() ;
+		if(Now >= Deadline)
+			return FALSE ;
+		Time = (DWORD)((Deadline - Now + 999) / 1000) ;
+	}
+
+	(*Waiting) ++ ;
+	pMutex->Signal() ;
+	UINT Result = Wakeup->Wait(Time) ;
+	pMutex->Wait() ;
+
+	if(Result == WAIT_OBJECT_0)
+		return TRUE ;
+
+	if(Wakeup->Wait(0) != WAIT_OBJECT_0)		// still counted, as nothing woke it
+		(*Waiting) -- ;
+	return FALSE ;
+}
+
+void CPipe::Wake(CSemaphore *Wakeup, UINT *Waiting)		// with the mutex held, see Block()
+{
+	if(*Waiting > 0)	{
+		Wakeup->Signal(*Waiting) ;
+		*Waiting = 0 ;
+	}
+}
+
+//
+//	How much of 'Size' bytes a writer can put in the pipeline now, and Readable() ditto for a reader
+//	taking them out, see above. Called with the mutex held
+//
+
+UINT CPipe::Writable(UINT Size) const
+{
+	if(PipePointer->Reserved != 0)			// Reserve() has the space at the writing index
+		return 0 ;
+
+	UINT Free = PipePointer->SizeOfPipe - PipePointer->NumBytes ;
+	UINT Whole = (Size < PipePointer->SizeOfPipe) ? Size : PipePointer->SizeOfPipe ;
+
+	if(Free >= Whole)
+		return Whole ;
+	return (PipePointer->Readers > 0) ? Free : 0 ;
+}
+
+UINT CPipe::Readable(UINT Size) const
+{
+	if(PipePointer->Peeked != 0)				// Peek() has the data at the reading index
+		return 0 ;
+
+	UINT Whole = (Size < PipePointer->SizeOfPipe) ? Size : PipePointer->SizeOfPipe ;
+
+	if(PipePointer->NumBytes >= Whole)
+		return Whole ;
+	return (PipePointer->Writers > 0) ? PipePointer->NumBytes : 0 ;
+}
+
+//
+//	Copy to and from the pipeline data starting at an index, wrapping round to the start of the
+//	buffer if the data goes past its end, unless the data is mirrored when it is always one piece.
+//	Advance() returns the index Run bytes on from Index. The caller holds the pipeline mutex
+//
+
+void CPipe::CopyIn(UINT Index, const BYTE *Data, UINT Size)
+{
+	UINT ToEnd = PipePointer->SizeOfPipe - Index ;
+
+	if(Mirrored || Size <= ToEnd)
+		memcpy(DataPointer + Index, Data, Size) ;
+	else	{
+		memcpy(DataPointer + Index, Data, ToEnd) ;
+		memcpy(DataPointer, Data + ToEnd, Size - ToEnd) ;
+	}
+}
+
+void CPipe::CopyOut(UINT Index, BYTE *Data, UINT Size) const
+{
+	UINT ToEnd = PipePointer->SizeOfPipe - Index ;
+
+	if(Mirrored || Size <= ToEnd)
+		memcpy(Data, DataPointer + Index, Size) ;
+	else	{
+		memcpy(Data, DataPointer + Index, ToEnd) ;
+		memcpy(Data + ToEnd, DataPointer, Size - ToEnd) ;
+	}
+}
+
+UINT CPipe::Advance(UINT Index, UINT Run) const
+{
+	return (Run < PipePointer->SizeOfPipe - Index) ? Index + Run : Index + Run - PipePointer->SizeOfPipe ;
+}
+
+//
+//	Put() adds 'Run' bytes at the writing index and wakes the readers, Take() takes them from the
+//	reading index, or throws them away if 'Data' is NULL, and wakes the writers. The mutex is held
+//
+
+void CPipe::Put(const BYTE *Data, UINT Run)
+{
+	CopyIn(PipePointer->WritingIndex, Data, Run) ;
+	PipePointer->WritingIndex = Advance(PipePointer->WritingIndex, Run) ;
+	PipePointer->NumBytes += Run ;										// Increment count of bytes in pipeline
+	Wake(pProdSemaphore, &PipePointer->Readers) ;
+}
+
+void CPipe::Take(BYTE *Data, UINT Run)
+{
+	if(Data != NULL)
+		CopyOut(PipePointer->ReadingIndex, Data, Run) ;
+	PipePointer->ReadingIndex = Advance(PipePointer->ReadingIndex, Run) ;
+	PipePointer->NumBytes -= Run ;										// decrement count of bytes in pipeline
+	Wake(pConSemaphore, &PipePointer->Writers) ;
+}
+
+//
+//	This functions handles writing data to a pipeline. All you need is the address of the programs
+//	data that is to be transferred to the pipline, and the size of that data. The write function takes
+//	care of the rest. Note that a process/thread writing to a full pipeline will be suspended until
+//	the process at the other end of the pipeline reads some out
+//
+//	The data goes in as one piece if it fits in the pipeline, otherwise as runs of however much space
+//	is free, each copied with the mutex taken once rather than a byte at a time. Only the runs of
+//	data bigger than the pipeline can be mixed up with those of another writer
+//
+
+//##ModelId=3DE6123C03CA
+BOOL CPipe::Write(void *Data, UINT Size)	// producer process
+{
+	//  transfer data from application address to pipeline and update the writing pointers
+
+	LPBYTE	Addr = (LPBYTE)(Data) ;		// cast from void to byte pointer
+
+	pMutex->Wait() ;		// make sure no other process is using the pipeline, if not grab it
+	while(Size > 0)	{
+		UINT Run = Writable(Size) ;
+		if(Run == 0)	{								// no space in the pipeline, so suspend
+			Block(pConSemaphore, &PipePointer->Writers, PIPE_FOREVER) ;
+			continue ;
+		}
+
+		Put(Addr, Run) ;
+		Addr += Run ;
+		Size -= Run ;
+	}
+	pMutex->Signal() ;		// release the process/thread blocking mutex
+	return TRUE ;
+}
+
+//
+//	A write that gives up on a full pipeline, so a writer feeding several readers is not held up by
+//	one that has stopped reading. It waits up to 'Time' mSec for room for all of the data, which goes
+//	in together or not at all, and then counts an overflow and applies the policy:
+//
+//	PIPE_BLOCK			waits for as long as it takes, like the other Write()
+//	PIPE_REJECT			returns FALSE
+//	PIPE_DROP_OLDEST	reads out and throws away the oldest 'Size' bytes until there is room
+//	PIPE_COALESCE		returns TRUE without writing if the same data is already waiting, else FALSE
+//
+//	The last two treat the pipeline as holding messages that are all 'Size' bytes long
+//
+
+BOOL CPipe::Write(void *Data, UINT Size, DWORD Time, UINT Policy)
+{
+	if(Policy == PIPE_BLOCK)
+		return Write(Data, Size) ;
+
+	PERR(Size > 0 && Size <= PipePointer->SizeOfPipe, string("Cannot Write That Much Data to Pipeline: ") + PipeName) ;
+	if(Size == 0 || Size > PipePointer->SizeOfPipe)
+		return FALSE ;
+
+	ULONGLONG Deadline = PIPE_DEADLINE(Time) ;
+
+	pMutex->Wait() ;
+
+	BOOL Room = TRUE ;
+	while(Room && Writable(Size) != Size)
+		Room = Block(pConSemaphore, &PipePointer->Writers, Deadline) ;
+
+	BOOL Written = Room ;
+
+	if(!Room)	{
+		++ (PipePointer->Overflows) ;
+
+		if(Policy == PIPE_DROP_OLDEST)
+			Written = Room = DropOldest(Size, Time) ;
+		else if(Policy == PIPE_COALESCE)
+			Written = IsWaiting((const BYTE *)(Data), Size) ;
+	}
+
+	if(Room)
+		Put((const BYTE *)(Data), Size) ;
+
+	pMutex->Signal() ;
+	return Written ;
+}
+
+//
+//	Makes room for 'Size' bytes by throwing away the oldest messages of that size. The caller holds
+//	the mutex, and a message a reader is looking at with Peek() gets 'Time' mSec to be released
+//
+
+BOOL CPipe::DropOldest(UINT Size, DWORD Time)
+{
+	ULONGLONG Deadline = PIPE_DEADLINE(Time) ;
+
+	while(Writable(Size) != Size)	{
+		if(PipePointer->Peeked != 0 || PipePointer->Reserved != 0)	{
+			if(!Block(pConSemaphore, &PipePointer->Writers, Deadline))
+				return FALSE ;
+		}
+		else if(PipePointer->NumBytes >= Size)
+			Take(NULL, Size) ;
+		else
+			return FALSE ;								// the data was not whole messages
+	}
+	return TRUE ;
+}
+
+//
+//	TRUE if a message the same as the 'Size' bytes at 'Data' is waiting to be read. The caller holds
+//	the mutex
+//
+
+BOOL CPipe::IsWaiting(const BYTE *Data, UINT Size)
+{
+	BOOL Found = FALSE ;
+
+	UINT Index = PipePointer->ReadingIndex ;
+	for(UINT Waiting = PipePointer->NumBytes; Waiting >= Size && !Found; Waiting -= Size)	{
+		UINT ToEnd = PipePointer->SizeOfPipe - Index ;		// compared in place, in two pieces if it wraps
+
+		if(Mirrored || Size <= ToEnd)
+			Found = (memcmp(DataPointer + Index, Data, Size) == 0) ;
+		else
+			Found = (memcmp(DataPointer + Index, Data, ToEnd) == 0 && memcmp(DataPointer, Data + ToEnd, Size - ToEnd) == 0) ;
+		Index = Advance(Index, Size) ;
+	}
+
+	return Found ;
+}
+
+//
+//	This functions handles reading data from a pipeline. All you need is the address of the programs
+//	data and the size of that data. The read function takes	care of the rest.
+//	Note that a process/thread reading from an empty pipeline will be suspended until
+//	the process at the other end of the pipeline writes some in
+//
+
+//##ModelId=3DE6123C03B7
+BOOL CPipe::Read(void *Data, UINT Size)
+{
+
+	//  transfer data from pipeline to application and update the reading pointers
+	//	if we attempt to overtake the writing process then suspend the thread.
+	//	We will need a Mutex somewhere in here to avoid two processes accessing the pipeline
+	//	at the same instant.
+
+	LPBYTE	Addr = (LPBYTE)(Data) ;								// cast from void to byte pointer
+
+	pMutex->Wait() ;										// make sure no other process is using the pipeline, if not grab it
+	while(Size > 0)	{
+		UINT Run = Readable(Size) ;
+		if(Run == 0)	{									// no data to read in the pipeline, so suspend
+			Block(pProdSemaphore, &PipePointer->Readers, PIPE_FOREVER) ;
+			continue ;
+		}
+
+		Take(Addr, Run) ;
+		Addr += Run ;
+		Size -= Run ;
+	}
+	pMutex->Signal() ;									// release the process/thread blocking mutex
+	return TRUE ;
+}
+
+//
+//	Reads as many whole messages of 'MessageSize' bytes as are in the pipeline, up to 'MaxMessages',
+//	with the mutex taken once, and returns how many were read. It never waits for messages to arrive
+//
+
+UINT CPipe::ReadBatch(void *Data, UINT MessageSize, UINT MaxMessages)
+{
+	if(MessageSize == 0 || MaxMessages == 0)
+		return 0 ;
+
+	pMutex->Wait() ;
+
+	UINT Messages = (PipePointer->Peeked != 0) ? 0 : PipePointer->NumBytes / MessageSize ;
+	if(Messages > MaxMessages)
+		Messages = MaxMessages ;
+
+	if(Messages > 0)
+		Take((BYTE *)(Data), Messages * MessageSize) ;
+
+	pMutex->Signal() ;
+	return Messages ;
+}
+
+//
+//	Reserve() waits for 'Size' bytes of space in the pipeline and returns a pointer to them, so a
+//	message can be built where it will be read from instead of being built elsewhere and copied in
+//	by Write(). Commit() then makes the first 'Size' bytes of it available to the reader and gives
+//	back the rest. Nothing else can be written in between, and the space is only contiguous in the
+//	pipeline itself if it is mirrored or does not wrap, otherwise the message is built in a buffer
+//	of the CPipe and copied in by Commit(). If the space is not there within 'Time' mSec it counts an
+//	overflow, like the timed Write(), and returns NULL
+//
+
+BYTE *CPipe::Reserve(UINT Size, DWORD Time)
+{
+	PERR(Size > 0 && Size <= PipePointer->SizeOfPipe, string("Cannot Reserve That Much Space in Pipeline: ") + PipeName) ;
+	if(Size == 0 || Size > PipePointer->SizeOfPipe)
+		return NULL ;
+
+	ULONGLONG Deadline = PIPE_DEADLINE(Time) ;
+
+	pWriterMutex->Wait() ;				// held until Commit()
+	pMutex->Wait() ;
+
+	BOOL Room = TRUE ;
+	while(Room && Writable(Size) != Size)
+		Room = Block(pConSemaphore, &PipePointer->Writers, Deadline) ;
+
+	if(!Room)	{									// nothing is taken until there is room for all of it, so nothing to give back
+		++ (PipePointer->Overflows) ;
+		pMutex->Signal() ;
+		pWriterMutex->Signal() ;
+		return NULL ;
+	}
+
+	PipePointer->Reserved = Size ;		// other writers wait for Commit()
+	UINT Index = PipePointer->WritingIndex ;
+	pMutex->Signal() ;
+
+	if(Mirrored || Size <= PipePointer->SizeOfPipe - Index)
+		ReservePointer = DataPointer + Index ;
+	else	{
+		WriteStage.resize(Size) ;
+		ReservePointer = &WriteStage[0] ;
+	}
+	ReserveSize = Size ;
+	return ReservePointer ;
+}
+
+BOOL CPipe::Commit(UINT Size)
+{
+	PERR(ReservePointer != NULL && Size <= ReserveSize, string("Commit Without Matching Reserve on Pipeline: ") + PipeName) ;
+	if(ReservePointer == NULL || Size > ReserveSize)
+		return FALSE ;
+
+	pMutex->Wait() ;
+	if(!WriteStage.empty() && ReservePointer == &WriteStage[0])
+		CopyIn(PipePointer->WritingIndex, ReservePointer, Size) ;
+	PipePointer->WritingIndex = Advance(PipePointer->WritingIndex, Size) ;
+	PipePointer->NumBytes += Size ;
+	PipePointer->Reserved = 0 ;								// space reserved but not used is free again
+	Wake(pProdSemaphore, &PipePointer->Readers) ;
+	Wake(pConSemaphore, &PipePointer->Writers) ;
+	pMutex->Signal() ;
+
+	ReservePointer = NULL ;
+	ReserveSize = 0 ;
+	pWriterMutex->Signal() ;
+	return TRUE ;
+}
+
+//
+//	Peek() waits for 'Size' bytes of data in the pipeline and returns a pointer to them without
+//	taking them out, so a message can be used where it is instead of being copied out by Read().
+//	Release() then takes the first 'Size' bytes of it out of the pipeline and leaves the rest to be
+//	read again. As with Reserve(), data that wraps round an unmirrored pipeline is copied into a
+//	buffer of the CPipe
+//
+
+const BYTE *CPipe::Peek(UINT Size)
+{
+	PERR(Size > 0 && Size <= PipePointer->SizeOfPipe, string("Cannot Peek That Much Data in Pipeline: ") + PipeName) ;
+	if(Size == 0 || Size > PipePointer->SizeOfPipe)
+		return NULL ;
+
+	pReaderMutex->Wait() ;				// held until Release()
+	pMutex->Wait() ;
+	while(Readable(Size) != Size)
+		Block(pProdSemaphore, &PipePointer->Readers, PIPE_FOREVER) ;
+
+	PipePointer->Peeked = Size ;		// other readers wait for Release()
+	UINT Index = PipePointer->ReadingIndex ;
+
+	if(Mirrored || Size <= PipePointer->SizeOfPipe - Index)
+		PeekPointer = DataPointer + Index ;
+	else	{
+		ReadStage.resize(Size) ;
+		CopyOut(Index, &ReadStage[0], Size) ;
+		PeekPointer = &ReadStage[0] ;
+	}
+	pMutex->Signal() ;
+
+	PeekSize = Size ;
+	return PeekPointer ;
+}
+
+BOOL CPipe::Release(UINT Size)
+{
+	PERR(PeekPointer != NULL && Size <= PeekSize, string("Release Without Matching Peek on Pipeline: ") + PipeName) ;
+	if(PeekPointer == NULL || Size > PeekSize)
+		return FALSE ;
+
+	pMutex->Wait() ;
+	PipePointer->Peeked = 0 ;								// data looked at but not taken can be read again
+	Take(NULL, Size) ;
+	Wake(pProdSemaphore, &PipePointer->Readers) ;
+	pMutex->Signal() ;
+
+	PeekPointer = NULL ;
+	PeekSize = 0 ;
+	pReaderMutex->Signal() ;
+	return TRUE ;
+}
+
+
+//
+//	This function returns the number of bytes in a pipeline
+//
+
+//##ModelId=3DE6123C03D5
+UINT CPipe::TestForData() const 
+{
+	pMutex->Wait() ;						// make sure no other process is using the pipeline, if not grab it
+	int NumBytesInPipe =  PipePointer->NumBytes ;
+	pMutex->Signal() ;						// make sure no other process is using the pipeline, if not grab it
+	return NumBytesInPipe ;
+}
+
+//
+//	Message Queue Functions
+//
+//	A CMessageQueue is a ring of slots, each a sequence number followed by room for one message. A slot
+//	whose sequence number equals a position is free for the writer that claims that position, pos + 1
+//	means the message in it is ready for the reader, and once read it becomes pos + NumMessages for the
+//	writer that comes round the ring next. Writers claim positions with one interlocked compare and
+//	exchange, so they never wait for each other, and the one reader never waits for anybody. The
+//	control block and the slots are one datapool, created like the pipeline ones
+//
+//	A writer that finds the queue full counts itself in Waiting and blocks on a semaphore, which the
+//	reader signals once for each writer waiting when it frees a slot. The reader only looks at
+//	Waiting, which is on its own cache line, so it costs nothing while no writer is waiting
+//
+
+CMessageQueue::CMessageQueue(const string &Name, UINT MessageSize, UINT NumMessages) :QueueName(Name)
+{
+	const string DataName = "__MessageQueue__" + Name ;
+	const string MutexName = "__MessageQueueMutex__" + Name ;
+	const string RoomName = "__MessageQueueRoom__" + Name ;
+
+	if(MessageSize < 1 || NumMessages < 2)	{
+		printf("Sorry Message Queue is too small, Minimum is 2 messages of 1 byte.\n") ;
+		getchar() ;
+		exit(0) ;
+	}
+
+	UINT Messages = 2 ;						// the number of slots is a power of 2 so a position is masked, not divided
+	while(Messages < NumMessages)
+		Messages <<= 1 ;
+
+	Mask = Messages - 1 ;
+	SlotSize = sizeof(QUEUESLOT) + (MessageSize + 7) / 8 * 8 ;		// keeps every slot 8 byte aligned
+	UINT Size = sizeof(QUEUECONTROL) + Messages * SlotSize ;
+
+	if(ObjectScope == PROCESS_OBJECTS)	{		// plain heap memory, see SET_OBJECT_SCOPE()
+		hQueue = NULL ;
+		QueuePointer = (QUEUECONTROL *)PROCESS_MEMORY(DataName, Size) ;
+	}
+	else	{
+		hQueue = SHARE_OBJECT("Datapool", DataName, CreateFileMapping((HANDLE)0xFFFFFFFF, NULL, PAGE_READWRITE, 0, Size, OBJECT_NAME(DataName))) ;
+		PERR(hQueue != NULL, string("Cannot Make Datapool For Message Queue ") + Name) ;
+		QueuePointer = (hQueue != NULL) ? (QUEUECONTROL *)MapViewOfFile(hQueue, FILE_MAP_WRITE, 0, 0, 0) : NULL ;
+	}
+
+	PERR(QueuePointer != NULL, string("Cannot Make Datapool For Message Queue ") + Name) ;
+	if(QueuePointer == NULL)
+		exit(0) ;
+
+	SlotPointer = (BYTE *)(QueuePointer + 1) ;
+
+	// the mutex is only used here, so two processes do not both set the slots up
+
+	pMutex = new CMutex(MutexName) ;
+	pMutex->Wait() ;
+	if(QueuePointer->Initialised != 0x4afc)	{
+		for(UINT i = 0; i < Messages; i ++)
+			Slot(i)->Sequence = i ;
+		QueuePointer->EnqueuePos = 0 ;
+		QueuePointer->DequeuePos = 0 ;
+		QueuePointer->Waiting = 0 ;
+		QueuePointer->NumMessages = Messages ;
+		QueuePointer->MessageSize = MessageSize ;
+		QueuePointer->Initialised = 0x4afc ;
+	}
+	else	{	// make sure the sizes were specified the same in all processes creating it
+		BOOL Same = (QueuePointer->NumMessages == Messages && QueuePointer->MessageSize == MessageSize) ;
+		PERR(Same, string("Size of Message Queue Name:") + Name + string(" Conflicts with size already specified by another process")) ;
+		if(!Same)
+			exit(0) ;
+	}
+	pMutex->Signal() ;
+
+	pRoom = new CSemaphore(RoomName, 0, 0x7fffffff) ;
+}
+
+CMessageQueue::~CMessageQueue()
+{
+	if(hQueue == NULL)
+		CLOSE_OBJECT(QueuePointer) ;
+	else	{
+		UnmapViewOfFile(QueuePointer) ;
+		CLOSE_OBJECT(hQueue) ;
+	}
+	delete pMutex ;
+	delete pRoom ;
+}
+
+//
+//	Claims the next free position and copies the message into its slot, returning FALSE straight away
+//	if the queue is full. Another writer claiming the same position first only costs another try
+//
+
+BOOL CMessageQueue::TryWrite(const void *Data)
+{
+	LONG Pos = QueuePointer->EnqueuePos ;
+	QUEUESLOT *Next ;
+
+	for(;;)	{
+		Next = Slot(Pos) ;
+		LONG Difference = Next->Sequence - Pos ;
+
+		if(Difference == 0)	{									// free, try to claim it
+			LONG Claimed = InterlockedCompareExchange(&QueuePointer->EnqueuePos, Pos + 1, Pos) ;
+			if(Claimed == Pos)
+				break ;
+			Pos = Claimed ;
+		}
+		else if(Difference < 0)									// the reader has not emptied it yet
+			return FALSE ;
+		else
+			Pos = QueuePointer->EnqueuePos ;					// another writer got there first
+	}
+
+	memcpy(Next + 1, Data, QueuePointer->MessageSize) ;
+	InterlockedExchange(&Next->Sequence, Pos + 1) ;				// publish it to the reader
+	return TRUE ;
+}
+
+//
+//	Waits for a slot if the queue is full, for up to 'Time' mSec, returning FALSE if none came free.
+//	The writer counts itself in Waiting before it tries again, so either that try finds the slot the
+//	reader freed or the reader sees it waiting and wakes it. A writer that gets a slot on that try, or
+//	gives up waiting, takes itself out of the count again, or, if the reader has already taken the
+//	count, the unit the reader signalled for it
+//
+
+BOOL CMessageQueue::Write(const void *Data, DWORD Time)
+{
+	ULONGLONG Deadline = PIPE_DEADLINE(Time) ;
+
+	while(!TryWrite(Data))	{
+		DWORD Wait = INFINITE ;
+		if(Deadline != PIPE_FOREVER)	{
+			ULONGLONG Now = GET_TIME_US() ;
+			if(Now >= Deadline)
+				return FALSE ;
+			Wait = (DWORD)((Deadline - Now + 999) / 1000) ;
+		}
+
+		InterlockedIncrement(&QueuePointer->Waiting) ;
+
+		BOOL Written = TryWrite(Data) ;
+		if(!Written && pRoom->Wait(Wait) == WAIT_OBJECT_0)
+			continue ;
+
+		LONG Waiting = QueuePointer->Waiting ;
+		for(;;)	{
+			if(Waiting == 0)	{
+				pRoom->Wait() ;				// signalled, or about to be, by the reader
+				break ;
+			}
+			LONG Seen = InterlockedCompareExchange(&QueuePointer->Waiting, Waiting - 1, Waiting) ;
+			if(Seen == Waiting)
+				break ;
+			Waiting = Seen ;
+		}
+
+		if(Written)
+			break ;
+	}
+	return TRUE ;
+}
+
+//
+//	Only one thread may read a queue, so the reader needs no interlocked operations and never waits.
+//	A message claimed but not yet copied in by its writer counts as not there yet
+//
+
+BOOL CMessageQueue::TryRead(void *Data)
+{
+	LONG Pos = QueuePointer->DequeuePos ;
+	QUEUESLOT *Next = Slot(Pos) ;
+
+	if(Next->Sequence - (Pos + 1) < 0)
+		return FALSE ;
+
+	memcpy(Data, Next + 1, QueuePointer->MessageSize) ;
+	InterlockedExchange(&Next->Sequence, Pos + (LONG)(Mask) + 1) ;		// free for the writer coming round next
+	QueuePointer->DequeuePos = Pos + 1 ;
+
+	if(QueuePointer->Waiting != 0)	{								// writers blocked on a full queue
+		LONG Waiting = InterlockedExchange(&QueuePointer->Waiting, 0) ;
+		if(Waiting > 0)
+			pRoom->Signal(Waiting) ;
+	}
+	return TRUE ;
+}
+
+UINT CMessageQueue::ReadBatch(void *Data, UINT MaxMessages)
+{
+	BYTE *Addr = (BYTE *)(Data) ;
+	UINT Messages = 0 ;
+
+	while(Messages < MaxMessages && TryRead(Addr))	{
+		Addr += QueuePointer->MessageSize ;
+		Messages ++ ;
+	}
+	return Messages ;
+}
+
+UINT CMessageQueue::TestForData() const
+{
+	return (UINT)(QueuePointer->EnqueuePos - QueuePointer->DequeuePos) ;	// includes messages still being copied in
+}
+
+//
+//	Constructor creates a named datapool object with a 
+//specified size
+
+//##ModelId=3DE6123C01CB
+CDataPool::CDataPool(const string &Name, UINT size)
+	:DataPoolName(Name)
+{
+	if(ObjectScope == PROCESS_OBJECTS)	{		// plain heap memory, see SET_OBJECT_SCOPE()
+		DPInfo.DataPoolHandle = NULL ;
+		DPInfo.DataPoolPointer = PROCESS_MEMORY(Name, size) ;
+		PERR(DPInfo.DataPoolPointer != NULL, string("Cannot Make Datapool: ") + Name) ;
+		return ;
+	}
+
+	DPInfo.DataPoolHandle = SHARE_OBJECT("Datapool", Name, CreateFileMapping((HANDLE)0xFFFFFFFF, 
+						NULL, 
+						PAGE_READWRITE,
+						0,
+						size,
+						OBJECT_NAME(Name)
+	)) ;
+	
+	PERR(DPInfo.DataPoolHandle != NULL, string("Cannot Make Datapool: ") + Name) ;	// check for error and print error message as appropriate
+	
+	DPInfo.DataPoolPointer = MapViewOfFile(
+		DPInfo.DataPoolHandle,			// file-mapping object to map into 
+									// address space
+		FILE_MAP_WRITE ,
+		0,							// high-order 32 bits of file offset
+		0,							// low-order 32 bits of file offset
+		0							// number of bytes to map, 0 means all
+	) ;
+
+
+	PERR(DPInfo.DataPoolPointer != NULL,  string("Cannot Make Datapool: ") + Name) ;	// check for error and print error message as appropriate
+	
+	if(DPInfo.DataPoolPointer == NULL)	
+		CLOSE_OBJECT(DPInfo.DataPoolHandle) ;	// close datapool handle
+}
+
+
+//
+//	This function unlinks from a datapools 'view', when the thread/process has finished using it
+//	call this only as many times as you Link to it
+//
+
+//##ModelId=3DE6123C01E0
+BOOL	CDataPool::Unlink()	const // DataPoolHandle obtained by calling Link_Datapool()
+{
+	if(DPInfo.DataPoolHandle == NULL && DPInfo.DataPoolPointer != NULL)	{		// PROCESS_OBJECTS memory
+		BOOL Success = CLOSE_OBJECT(DPInfo.DataPoolPointer) ;
+		PERR( Success == TRUE, string("Cannot UnLink from Datapool: ") + DataPoolName ) ;
+		return Success ;
+	}
+
+	BOOL Success = UnmapViewOfFile(DPInfo.DataPoolPointer) ;	// unlink from data pool view
+	PERR( Success == TRUE, string("Cannot UnLink from Datapool: ") + DataPoolName ) ;		// check for error and print error message as appropriate
+
+	Success = CLOSE_OBJECT(DPInfo.DataPoolHandle) ;
+	PERR( Success == TRUE, string("Cannot UnLink from Datapool: ") + DataPoolName ) ;		// check for error and print error message as appropriate
+
+	return Success ;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//	This example makes a datapool and puts value into it
+/*
+
+#include <stdio.h>
+#include "rt.h"
+  
+struct test {
+		int floor;
+		int direction ;
+		int floors[1000] ;
+} ;
+
+int main()
+{
+	...
+	...
+	DATAPOOLINFO dp = MAKE_DATAPOOL("Car1", sizeof(struct test)) ;
+	
+	// check the validity of the above operation
+
+	if(dp.DataPoolHandle == NULL || dp.DataPoolPointer == NULL)	{
+		perror("Cannot make Datapool \n") ;
+		EXIT_PROCESS(0) ;
+	}
+
+  // now get the datapool pointer from the DATAPOOLINFO object 'dp' and cast it to a 'struct test' pointer
+	
+	struct test *MyDataPool = (struct test *)(dp.DataPoolPointer) ;
+
+
+	// put data into the datapool
+
+	MyDataPool->floor = 55 ;
+	MyDataPool->direction = 11 ;
+
+	printf("Floor = %d\n", MyDataPool->floor);
+	printf("Direction = %d\n", MyDataPool->direction) ; ;
+
+	for(int i = 0; i < 1000; i ++)
+		MyDataPool->floors[i] = i ;
+
+	UNLINK_DATAPOOL(dp) ;				// this call indicates the process has finished using the datapool
+										// if no other process are using it, then the O.System will remove it
+										// automatically.
+	return 0 ;
+}
+////////////////////////////////////////////////////////////////////////////////////////////////*/
+
+
+////////////////////////Message/Signal Functions///////////////////////////////////////////////
+//	Call this function to force windows to create a message queue for the process/thread
+//	The queue will only be created the 1st time it is called, so it can be called many times
+//	without problem. If you have multiple threads, then each can create its own message queue
+//	to deal with messages sent to it
+//
+//	An example of the use of messages and timers can be seen further down the file after
+//	the functions have been discussed
+//////////////////////////////////////////////////////////////////////////////////////////////
+
+//##ModelId=3DE6123B035A
+CMailbox::CMailbox()
+{
+	MSG	MessageBuff ;			// tempory buffer for use with PeekMessage Below
+
+	PeekMessage(&MessageBuff, NULL, WM_USER, WM_USER, PM_NOREMOVE) ;
+}
+
+//
+//	This function will suspend the current thread until the arrival of a message, the thread
+//	can then access the message using GET_USER_MESSAGE(). In order to use messages, the thread
+//	must have created a message queue. (See Create_User_Message_Queue() above )
+//	
+//	Once a message has been received, you must read it to remove it 
+//
+
+//##ModelId=3DE6123B035B
+void CMailbox::WaitForMessage() const
+{
+	BOOL Success = WaitMessage() ;
+	PERR( Success != 0, string("Unable to Wait For Message from Message Queue"))	;
+}
+
+//
+//	This function looks into the thread message queue to determine if there are any user messages
+//	that can be read. If the function returns TRUE, then at least one message exists. In order to use messages, the thread
+//	must have created a message queue. (See Create_User_Message_Queue() above )
+//
+//	Note that the header file 'rt.h' supplies default arguments for the parameters MinMessageValue and MaxMessageValue
+//	this means that you do not have to supply any arguments of your own when you call TEST_FOR_MESSAGE(), in which case
+//	the function tests to see if ANY message has been sent to the thread regardless of its value.
+//
+//	However, you can test for tha arrival of messages within a specified range by supplying the min and max values
+//	If you supply these arguments, then the function TEST_FOR_MESSAGE() tests for the existence of a message
+//	in the message queue that falls within the bounds of Min and MaxMessage Value (inclusive)
+//
+
+//##ModelId=3DE6123B0365
+BOOL CMailbox::TestForMessage(UINT MinMessageValue, UINT MaxMessageValue) const
+{
+	MSG	MessageBuff ;
+	return PeekMessage(&MessageBuff, NULL, WM_USER+MinMessageValue, WM_USER + MaxMessageValue, PM_NOREMOVE) ;
+}
+
+//
+//	This function retrives a message from the threads message queue. 
+//
+
+//##ModelId=3DE6123B0370
+UINT	CMailbox::GetMessage(UINT MinMessageValue, UINT MaxMessageValue) const
+{
+	MSG	Message ;
+	LPMSG	Mess = &Message ;
+	BOOL Result = ::GetMessage(Mess, NULL, WM_USER+MinMessageValue, WM_USER+MaxMessageValue) ;
+	PERR( Result != -1, string("Could Not Get Message from Message Queue")) ;	// check for error and print error message as appropriate
+	return Message.message - WM_USER ;
+}
+
+
+//
+//	This function sets up a timer to go off at the specified time interval.
+//	The system posts WM_TIMER signals/messages to the thread that sets the timer, thus it's probably
+//	a good idea to have a separate thread for each timer that you need, each thread can then
+//	carry out one action in repsonse to one timer.
+//	
+//	In order for a thread to deal with or intercept messages from timers or messages in general
+//	it must have created a message queue, see the function CREATE_MESSAGE_QUEUE() or 
+//	CMessageQueue class
+//
+//	Note: A thread can suspend itself waiting for a timer using the WAIT_FOR_TIMER() function, 
+//	which removes the timer message from the message queue when it arrives and wakes up the thread
+//
+//	Note that timers are repetitive and continue to go at the specified time interval
+//	until Stopped with the Stop() function
+//
+
+//##ModelId=3DE6123C00BC
+
+CTimer::CTimer() 	// Constructor 1: Create the Timer but don't set it running, use SetTimer() later to start timer
+	: TimerID(0)	// sets the timer id to 0
+{}	
+
+
+// create a running timer
+//	If callbackfn is not supplied or is NULL, then timer 
+//posts messages to the threads message queues
+//	if callbackfn is supplied, then the callback function 
+//is invoked rather than a message being sent to the 
+//threads message queue
+//##ModelId=3DE6123C00BD
+CTimer::CTimer(UINT Timer, TIMERPROC callbackfn) 	// create a running timer that uses call backs rather than messages
+	: TimerID(0)
+{
+	TimerID = SetTimer(Timer, callbackfn) ;
+}
+
+
+//##ModelId=3DE6123C00C7
+CTimer::~CTimer() {						// destructor tidies up by killing the timer so that
+	if(TimerID != 0)					// no longer posts timer messages to the thread
+		StopTimer(); 						// kill timer
+}
+
+
+//	Setup timer to go off at the specified rate in mSec
+//	If callbackfn is not supplied or is NULL, then timer 
+//posts messages to the threads message queue
+//	if callbackfn is supplied, then the callback function 
+//is invoked rather than a message being sent to the 
+//threads message queue
+//##ModelId=3DE6123C00D1
+UINT CTimer::SetTimer(UINT Timer, TIMERPROC callbackfn)
+{
+	if(TimerID != 0)						// if timer already running
+		StopTimer() ;						// kill it i.e. stop it
+	
+	TimerID = ::SetTimer(NULL, 0, Timer, callbackfn) ;
+	PERR( TimerID != 0, string("Error Could NOT  Set Timer")) ;	// check for error and print error message as appropriate
+
+	return TimerID ;		// TRUE if timer successfully set, FALSE otherwise
+}
+
+//##ModelId=3DE6123C00DB
+BOOL CTimer::TestForTimer()  				// returns TRUE if timer gone off and posted message
+{
+	MSG	MessageBuff ;
+	return PeekMessage(&MessageBuff, NULL, WM_TIMER, WM_TIMER, PM_REMOVE) ; 
+}
+
+//##ModelId=3DE6123C00D0
+BOOL CTimer::StopTimer()		// kills a timer so that it no longer posts timer messages to thread
+{ 
+	BOOL Success = ::KillTimer(NULL, TimerID) ;
+	PERR( Success == TRUE, string("Error Could Not Kill Timer")) ;	// check for error and print error message as appropriate
+	TimerID = 0 ;
+
+	return Success ;
+}
+
+//##ModelId=3DE6123C00E4
+void CTimer::WaitForTimer()
+{
+	MSG	MessageBuff ;
+
+	do {
+		WaitMessage() ;		// for any message
+	}while(!GetMessage(&MessageBuff, NULL, WM_TIMER, WM_TIMER)) ; // is it WM_TIMER
+}
+
+//
+//	Timer Wheel Functions
+//
+//	The wheel counts time in ticks of Resolution microseconds from when it was made. It has
+//	TIMERWHEEL_LEVELS levels of TIMERWHEEL_SLOTS slots, a timer goes in the lowest level L where its tick
+//	is less than TIMERWHEEL_SLOTS slots of 2^(TIMERWHEEL_BITS * L) ticks ahead, in the slot given by those
+//	bits of its tick. Level 0 therefore holds the timers due in the next few ticks, one tick per slot, and every
+//	time the bits below a level wrap round to 0 the slot of that level for the new tick is emptied
+//	and its timers are put back into the levels below. Each timer is moved down at most once per
+//	level, so the cost of a timer does not depend on how many others are set. Timers more than
+//	2^(TIMERWHEEL_BITS * TIMERWHEEL_LEVELS) ticks away wait in the top level until they are close enough.
+//
+//	The timers live in one vector linked by index, so a timer that goes off or is cancelled is reused
+//	by the next Set() and nothing is allocated once the vector is big enough.
+//
+
+CTimerWheel::CTimerWheel(ULONGLONG TheResolution)
+	: Resolution(TheResolution > 0 ? TheResolution : 1), Tick(0), Count(0), FreeList(-1)
+{
+	Start = GET_TIME_US() ;
+	for(int i = 0; i < TIMERWHEEL_LEVELS * TIMERWHEEL_SLOTS; i ++)
+		Slots[i] = -1 ;
+}
+
+void CTimerWheel::Insert(int Index, BOOL Cascading)
+{
+	WheelTimer &Timer = Timers[Index] ;
+	int	Level, Slot ;
+
+	// already due, go off on the next tick, unless it is being moved down for the tick Advance() is
+	// about to deal with, which is when a timer due on a multiple of TIMERWHEEL_SLOTS ticks gets there
+	if(Timer.Expires <= Tick && !Cascading)
+		Timer.Expires = Tick + 1 ;
+
+	for(Level = 0; Level < TIMERWHEEL_LEVELS; Level ++)	{
+		int Shift = TIMERWHEEL_BITS * Level ;
+		if((Timer.Expires >> Shift) - (Tick >> Shift) < TIMERWHEEL_SLOTS)
+			break ;
+	}
+
+	if(Level < TIMERWHEEL_LEVELS)
+		Slot = (int)(Timer.Expires >> (TIMERWHEEL_BITS * Level)) & (TIMERWHEEL_SLOTS - 1) ;
+	else	{										// too far away, park it in the top level slot that is emptied last
+		Level = TIMERWHEEL_LEVELS - 1 ;
+		Slot = (int)((Tick >> (TIMERWHEEL_BITS * Level)) - 1) & (TIMERWHEEL_SLOTS - 1) ;
+	}
+
+	Timer.Slot = Level * TIMERWHEEL_SLOTS + Slot ;
+	Timer.Prev = -1 ;
+	Timer.Next = Slots[Timer.Slot] ;
+	if(Timer.Next != -1)
+		Timers[Timer.Next].Prev = Index ;
+	Slots[Timer.Slot] = Index ;
+}
+
+void CTimerWheel::Remove(int Index)
+{
+	WheelTimer &Timer = Timers[Index] ;
+
+	if(Timer.Prev != -1)
+		Timers[Timer.Prev].Next = Timer.Next ;
+	else
+		Slots[Timer.Slot] = Timer.Next ;
+
+	if(Timer.Next != -1)
+		Timers[Timer.Next].Prev = Timer.Prev ;
+}
+
+void CTimerWheel::Free(int Index)
+{
+	WheelTimer &Timer = Timers[Index] ;
+
+	Timer.Slot = -1 ;
+	Timer.Generation ++ ;
+	Timer.Next = FreeList ;
+	FreeList = Index ;
+	Count -- ;
+}
+
+void CTimerWheel::Cascade(int Level, int Slot)
+{
+	int Index = Slots[Level * TIMERWHEEL_SLOTS + Slot] ;
+	Slots[Level * TIMERWHEEL_SLOTS + Slot] = -1 ;	// take the whole list first, parked timers may go back in this level
+
+	while(Index != -1)	{
+		int Next = Timers[Index].Next ;
+		Insert(Index, TRUE) ;
+		Index = Next ;
+	}
+}
+
+TIMERWHEELID CTimerWheel::Set(ULONGLONG Delay, TIMERWHEELPROC Callback, void *Arg)
+{
+	int	Index ;
+
+	Lock.Enter() ;
+
+	if(FreeList != -1)	{
+		Index = FreeList ;
+		FreeList = Timers[Index].Next ;
+	}
+	else	{
+		WheelTimer Timer ;
+		Timer.Generation = 0 ;
+		Timers.push_back(Timer) ;
+		Index = (int)(Timers.size()) - 1 ;
+	}
+
+	WheelTimer &Timer = Timers[Index] ;
+	Timer.Expires = (GET_TIME_US() - Start + Delay + Resolution - 1) / Resolution ;	// round up so a timer never goes off early
+	Timer.Callback = Callback ;
+	Timer.Arg = Arg ;
+	Insert(Index) ;
+	Count ++ ;
+
+	TIMERWHEELID Id = ((TIMERWHEELID)(Timer.Generation) << 32) | (TIMERWHEELID)(Index + 1) ;
+
+	Lock.Leave() ;
+	return Id ;
+}
+
+void CTimerWheel::Reserve(UINT Size)
+{
+	Lock.Enter() ;
+	Timers.reserve(Size) ;
+	Fired.reserve(Size) ;
+	Lock.Leave() ;
+}
+
+BOOL CTimerWheel::Cancel(TIMERWHEELID Id)
+{
+	int		Index = (int)(Id & 0xFFFFFFFF) - 1 ;
+	BOOL	Success = FALSE ;
+
+	Lock.Enter() ;
+
+	if(Index >= 0 && Index < (int)(Timers.size()) && Timers[Index].Slot != -1 && Timers[Index].Generation == (UINT)(Id >> 32))	{
+		Remove(Index) ;
+		Free(Index) ;
+		Success = TRUE ;
+	}
+
+	Lock.Leave() ;
+	return Success ;
+}
+
+//
+//	Goes through every tick since the last call, moving timers down the levels and taking the ones
+//	that are due out of the wheel. Their functions are called once the lock is released so that they
+//	can Set() or Cancel() timers themselves.
+//
+
+UINT CTimerWheel::Advance()
+{
+	Lock.Enter() ;
+
+	ULONGLONG Now = (GET_TIME_US() - Start) / Resolution ;
+	Fired.clear() ;
+
+	if(Count == 0 && Now > Tick)					// nothing to go off or move down, skip straight there
+		Tick = Now ;
+
+	while(Tick < Now)	{
+		Tick ++ ;
+
+		for(int Level = TIMERWHEEL_LEVELS - 1; Level > 0; Level --)	{
+			if((Tick & ((1ULL << (TIMERWHEEL_BITS * Level)) - 1)) == 0)
+				Cascade(Level, (int)(Tick >> (TIMERWHEEL_BITS * Level)) & (TIMERWHEEL_SLOTS - 1)) ;
+		}
+
+		int Slot = (int)(Tick) & (TIMERWHEEL_SLOTS - 1) ;
+		int Index = Slots[Slot] ;
+		Slots[Slot] = -1 ;
+
+		while(Index != -1)	{
+			int Next = Timers[Index].Next ;
+			Fired.push_back(Timers[Index]) ;
+			Free(Index) ;
+			Index = Next ;
+		}
+
+		if(Count == 0)
+			Tick = Now ;
+	}
+
+	Lock.Leave() ;
+
+	for(UINT i = 0; i < Fired.size(); i ++)
+		Fired[i].Callback(Fired[i].Arg) ;
+
+	return (UINT)(Fired.size()) ;
+}
+
+//
+//	Only level 0 is searched, if it is empty the answer is the next tick that moves timers down into
+//	it, so the caller may find nothing due when it gets there and has to ask again.
+//
+
+ULONGLONG CTimerWheel::TimeToNext()
+{
+	ULONGLONG Next = TIMERWHEEL_NONE ;
+
+	Lock.Enter() ;
+
+	if(Count > 0)	{
+		Next = (Tick & ~(ULONGLONG)(TIMERWHEEL_SLOTS - 1)) + TIMERWHEEL_SLOTS ;
+		for(ULONGLONG t = Tick + 1; t < Next; t ++)	{
+			if(Slots[t & (TIMERWHEEL_SLOTS - 1)] != -1)	{
+				Next = t ;
+				break ;
+			}
+		}
+		Next = Start + Next * Resolution ;
+	}
+
+	Lock.Leave() ;
+
+	if(Next == TIMERWHEEL_NONE)
+		return Next ;
+
+	ULONGLONG Now = GET_TIME_US() ;
+	return (Next > Now) ? Next - Now : 0 ;
+}
+
+void CTimerWheel::Run(ULONGLONG Until)
+{
+	ULONGLONG Now ;
+
+	while((Now = GET_TIME_US()) < Until)	{
+		Advance() ;
+
+		ULONGLONG Wait = TimeToNext() ;
+		if(Wait > Until - Now)
+			Wait = Until - Now ;
+
+		SLEEP((Wait < 1000) ? 1 : (UINT)(Wait / 1000)) ;	// SLEEP() only goes down to 1 mSec
+	}
+
+	Advance() ;
+}
+	
+
+//
+//	This function suspends the current thread until the specified time has elapsed
+//	This allows other processes with the same priority to run. Co-operative processing
+//	can be implemented with the help of this function,as processes voluntarily relinquish
+//	control of the CPU. If the delay is 0, the processes simply gives up the remainder of
+//	its CPU time. If the value is 'INFINITE', then the process waits forever. 
+//	If the delay is somewhere inbetween, the process is suspended for the duration specified
+//	sending it a message will not wake it up prematurely.
+//
+
+void	SLEEP(UINT	Time) 
+{
+	if(CurrentTask != NULL)
+		DETERMINISTIC_YIELD((ULONGLONG)(Time) * 1000) ;		// move the logical clock on instead
+	else
+		Sleep(Time) ;
+}
+
+//
+//	This function returns the time in microseconds from the high resolution performance counter.
+//	Only the difference between two calls is meaningful. Use it to time events more finely than
+//	the millisecond (or worse) resolution of SLEEP() and the Windows tick count. In deterministic
+//	mode it returns the logical clock instead, see SET_DETERMINISTIC()
+//
+
+ULONGLONG	GET_TIME_US()
+{
+	static LARGE_INTEGER Frequency = {0} ;
+	LARGE_INTEGER Now ;
+
+	DeterministicScheduler *Scheduler = CURRENT_SCHEDULER() ;
+	if(Scheduler != NULL)
+		return Scheduler->LogicalTime ;
+
+	if(Frequency.QuadPart == 0)
+		QueryPerformanceFrequency(&Frequency) ;		// counts per second, fixed at boot
+
+	QueryPerformanceCounter(&Now) ;
+	return (ULONGLONG)(Now.QuadPart / Frequency.QuadPart) * 1000000 
+		+ (ULONGLONG)(Now.QuadPart % Frequency.QuadPart) * 1000000 / Frequency.QuadPart ;
+}
+
+//
+//	This function tests the keyboard to see if a key has been pressed. If so, the value TRUE is
+//	returned and the thread can read the character without getting suspended using a function
+//	such as _getch(), _getche() etc.
+//
+
+BOOL	TEST_FOR_KEYBOARD()
+{
+	return _kbhit() ;
+}
+
+
+//
+//	These functions returns handles to a console standard input/output and error device
+//	i.e. keyboard, screen and screen respectively. NULL is returned on error
+//	For more example of console functions read the Vis C++ Help/Win32 functions by category/console functions
+//
+
+HANDLE	GET_STDIN()
+{
+	return GetStdHandle(STD_INPUT_HANDLE) ;
+}
+
+HANDLE	GET_STDOUT()
+{
+	return GetStdHandle(STD_OUTPUT_HANDLE) ;
+}
+
+HANDLE	GET_STDERR()
+{
+	return GetStdHandle(STD_ERROR_HANDLE) ;
+}
+
+//
+//	This function pauses the thread/process until user input is entered at the keyboard
+//
+//	This function returns WAIT_FAILED if there was an error, WAIT_TIMEOUT if the wait operation timed out
+//	of WAIT_OBJECT_0 if the operation did in fact wait and then returned
+//
+
+UINT WAIT_FOR_CONSOLE_INPUT(HANDLE hEvent, DWORD Time)
+{
+	UINT	Status = WaitForSingleObject(hEvent, Time) ;
+	PERR( Status != WAIT_FAILED, string("Cannot Wait for Console Input")) ;	// check for error and print message if appropriate
+	return Status ;
+}
+
+//
+//	The console functions below have two backends. WIN32_CONSOLE (the default) calls the Win32
+//	console API once for every cursor move or colour change. ANSI_CONSOLE instead appends VT100
+//	escape sequences to an in-memory buffer which is written to the screen in one go when
+//	FLUSH_CONSOLE() is called, usually once per frame. This is much cheaper than a console API
+//	round trip per call and works with any terminal that understands escape sequences, including
+//	remote terminals connected over SSH.
+//
+//	Text written between the cursor functions must go to CONSOLE() rather than cout so that it
+//	lands in the same buffer, in the right order. The buffer has no lock, so only one thread should
+//	draw with it. PERR(), which any thread can call, writes straight to the screen instead.
+//
+
+static int ConsoleBackend = WIN32_CONSOLE ;
+static ostringstream ConsoleBuffer ;
+
+void SET_CONSOLE_BACKEND(int Backend)
+{
+	PERR(Backend == WIN32_CONSOLE || Backend == ANSI_CONSOLE, string("Illegal Console Backend specified in call to SET_CONSOLE_BACKEND()")) ;
+
+	if(Backend == ANSI_CONSOLE)	{		// ask the Windows console to interpret escape sequences, harmless if it is not a console
+		DWORD Mode ;
+		if(GetConsoleMode(GET_STDOUT(), &Mode))
+			SetConsoleMode(GET_STDOUT(), Mode | ENABLE_VIRTUAL_TERMINAL_PROCESSING) ;
+	}
+
+	FLUSH_CONSOLE() ;					// don't lose anything buffered by the old backend
+	ConsoleBackend = Backend ;
+}
+
+ostream &CONSOLE()
+{
+	if(ConsoleBackend == ANSI_CONSOLE)
+		return ConsoleBuffer ;
+	else
+		return cout ;
+}
+
+void FLUSH_CONSOLE()
+{
+	if(ConsoleBackend == ANSI_CONSOLE)	{
+		const string Frame = ConsoleBuffer.str() ;
+		cout.write(Frame.c_str(), Frame.size()) ;		// one write for the whole frame
+		ConsoleBuffer.str("") ;
+	}
+
+	cout.flush() ;
+}
+
+//	moves the cursor to the x,y coord on the screen. [0,0] is top left
+//	all calls to printf cause output to occur at the current cursor position
+//	obviously, the cursor moves with text output operations
+
+void MOVE_CURSOR(int x, int y)
+{
+	if(ConsoleBackend == ANSI_CONSOLE)	{
+		ConsoleBuffer << "\x1b[" << y + 1 << ';' << x + 1 << 'H' ;		// escape sequences count from 1
+		return ;
+	}
+
+	COORD	c = {(short)x, (short)y}  ;
+	SetConsoleCursorPosition(GET_STDOUT(), c) ;
+}
+
+//
+//	These two function turns off/on the cursor so that it is not visible
+//	but it still operates and output text still occurs at the current curso
+//	position
+//
+
+void CURSOR_OFF()
+{
+	if(ConsoleBackend == ANSI_CONSOLE)	{
+		ConsoleBuffer << "\x1b[?25l" ;
+		return ;
+	}
+
+	CONSOLE_CURSOR_INFO	cci = {1, FALSE} ;
+	SetConsoleCursorInfo(GET_STDOUT(), &cci) ;
+}
+
+void CURSOR_ON()
+{
+	if(ConsoleBackend == ANSI_CONSOLE)	{
+		ConsoleBuffer << "\x1b[?25h" ;
+		return ;
+	}
+
+	CONSOLE_CURSOR_INFO	cci = {1, TRUE} ;
+	SetConsoleCursorInfo(GET_STDOUT(), &cci) ;
+}
+
+//
+//	These two functions turns on/off reverse video, so that text comes black on white background
+//	For more details set the SetConsoleTextAttribute() function in on-line
+//	help
+//
+
+void REVERSE_ON()
+{
+	if(ConsoleBackend == ANSI_CONSOLE)	{
+		ConsoleBuffer << "\x1b[7m" ;
+		return ;
+	}
+
+	SetConsoleTextAttribute(GET_STDOUT(), 
+		BACKGROUND_RED | BACKGROUND_GREEN | BACKGROUND_BLUE) ;
+}
+
+void REVERSE_OFF()
+{
+	if(ConsoleBackend == ANSI_CONSOLE)	{
+		ConsoleBuffer << "\x1b[27m" ;
+		return ;
+	}
+
+	SetConsoleTextAttribute(GET_STDOUT(), 
+		FOREGROUND_RED | FOREGROUND_GREEN | FOREGROUND_BLUE) ;
+}
+
+void CLEAR_SCREEN()
+{
+	if(ConsoleBackend == ANSI_CONSOLE)	{
+		ConsoleBuffer << "\x1b[2J\x1b[H" ;
+		return ;
+	}
+
+	for(int i = 0; i < 50; i ++)
+		putchar('\n') ;
+}
+
+/*Contains a function to change the text colour.
+
+  To Use:
+
+  This function takes 2 arguments, foreground and background.
+  foreground and background select one of 15 colours numbered as follows:
+
+  0 - Black
+  1 - Dark Blue
+  2 - Dark Green
+  3 - Dark Cyan
+  4 - Dark Red
+  5 - Dark Magenta
+  6 - Dark Yellow
+  7 - Grey
+  8 - Black (again)
+  9 - Blue
+  10 - Green
+  11 - Cyan
+  12 - Red
+  13 - Magenta
+  14 - Yellow
+  15 - White
+
+  Note... background and foreground cannot be the same value, and an
+  error (-1) will be returned.
+
+  If colours are valid, and operation was successful, 0 will be returned.
+
+  Use TEXT_COLOUR with no arguements to return values to default.
+
+  A foreground colour only can be specified, eg TEXT_COLOUR(4) will make text dark red .*/  
+
+//	Converts one of the console colour numbers above into the matching ANSI colour number (0 - 7).
+//	The console numbers store blue, green and red in bits 0, 1 and 2, ANSI stores them the other way round
+
+static int ANSI_COLOUR(unsigned char colour)
+{
+	return ((colour & 1) << 2) | (colour & 2) | ((colour & 4) >> 2) ;
+}
+
+int TEXT_COLOUR(unsigned char foreground, unsigned char background)
+{
+	if ((foreground>15)||(foreground<0)||(background>15)||(background<0)||(background==foreground))
+	{
+		return -1;
+	}
+
+	if(ConsoleBackend == ANSI_CONSOLE)	{	// bit 3 selects the bright version of the colour
+		ConsoleBuffer << "\x1b[" << ((foreground & 8) ? 90 : 30) + ANSI_COLOUR(foreground) 
+					  << ';' << ((background & 8) ? 100 : 40) + ANSI_COLOUR(background) << 'm' ;
+		return 0;
+	}
+
+	int colour=0;
+	background=background<<4;
+	colour=colour|background|foreground;
+	SetConsoleTextAttribute(GET_STDOUT(), colour);
+	return 0;
+}
+
+
+void flush(istream &is)		// can be used to flush an input stream, useful for removing operator entered rubbish
+{
+	is.clear() ;
+	streambuf  *ptr = is.rdbuf() ;		// get pointer to stream buffer
+	int avail = ptr->in_avail() ;			// get number of chars waiting to be read
+	is.ignore(avail) ;						// ignore this many characters
+	is.clear() ;
+}
+
+void PERR(bool bSuccess, string ErrorMessageString)
+{		
+	UINT LastError = GetLastError() ;
+
+	if(!(bSuccess)) {
+		char buff[512] ;
+		Beep(500, 100);
+		if(ConsoleBackend == ANSI_CONSOLE)		// not through the buffer, which belongs to the thread drawing
+			printf("\x1b[1;1H\x1b[7m") ;
+		else	{
+			MOVE_CURSOR(0,0) ;
+			REVERSE_ON() ;
+		}
+		FormatMessage( FORMAT_MESSAGE_FROM_SYSTEM, NULL, LastError,
+		MAKELANGID(LANG_NEUTRAL, SUBLANG_DEFAULT), buff, 1024, NULL );
+		printf(" Error %d in Process %s: line %d:\n", LastError, __FILE__, __LINE__);
+		printf(" Translation: %s Error: %s", buff, ErrorMessageString.c_str()) ;
+		if(ConsoleBackend == ANSI_CONSOLE)
+			printf("\x1b[27m") ;
+		else
+			REVERSE_OFF() ;
+		fflush(stdout) ;
+		printf("\n\nPress Return to Continue...") ;
+		_getch();
+	}
 }
\ No newline at end of file